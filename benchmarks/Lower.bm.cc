@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+
+#include <optional>
+#include <string>
+
+#include "Cocktail/Check/Check.h"
+#include "Cocktail/Common/Check.h"
+#include "Cocktail/Diagnostics/NullDiagnostics.h"
+#include "Cocktail/Lex/TokenizedBuffer.h"
+#include "Cocktail/Lower/Lower.h"
+#include "Cocktail/Parse/Tree.h"
+#include "Cocktail/Source/SourceBuffer.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace {
+
+using namespace Cocktail;
+
+// Holds a checked file so that only lowering is measured.
+class CheckedFile {
+ public:
+  explicit CheckedFile(const std::string& source_text) {
+    fs_.addFile("bench.cocktail", /*ModificationTime=*/0,
+                llvm::MemoryBuffer::getMemBuffer(source_text));
+    source_.emplace(*SourceBuffer::CreateFromFile(fs_, "bench.cocktail",
+                                                  NullDiagnosticConsumer()));
+    tokens_.emplace(
+        Lex::TokenizedBuffer::Lex(*source_, NullDiagnosticConsumer()));
+    parse_tree_.emplace(Parse::Tree::Parse(*tokens_, NullDiagnosticConsumer(),
+                                           /*vlog_stream=*/nullptr));
+    sem_ir_.emplace(Check::CheckParseTree(builtins_, *tokens_, *parse_tree_,
+                                          NullDiagnosticConsumer(),
+                                          /*vlog_stream=*/nullptr));
+    COCKTAIL_CHECK(!sem_ir_->has_errors());
+  }
+
+  auto sem_ir() const -> const SemIR::File& { return *sem_ir_; }
+
+ private:
+  llvm::vfs::InMemoryFileSystem fs_;
+  SemIR::File builtins_ = Check::MakeBuiltins();
+  std::optional<SourceBuffer> source_;
+  std::optional<Lex::TokenizedBuffer> tokens_;
+  std::optional<Parse::Tree> parse_tree_;
+  std::optional<SemIR::File> sem_ir_;
+};
+
+// A single function with `count` straight-line variable definitions, so that
+// most of the time goes to node-to-value mapping in one large block.
+auto MakeStraightLineSource(int count) -> std::string {
+  std::string source = "fn Run() -> i32 {\n";
+  for (int i = 0; i < count; ++i) {
+    source += "  var v" + std::to_string(i) + ": i32 = " + std::to_string(i) +
+              ";\n";
+  }
+  source += "  return 0;\n}\n";
+  return source;
+}
+
+// A single function with `count` `if` statements, so that lowering allocates
+// and looks up many basic blocks.
+auto MakeBranchySource(int count) -> std::string {
+  std::string source = "fn Run() -> i32 {\n";
+  for (int i = 0; i < count; ++i) {
+    source += "  if (true) { var v" + std::to_string(i) +
+              ": i32 = 1; } else { var w" + std::to_string(i) +
+              ": i32 = 2; }\n";
+  }
+  source += "  return 0;\n}\n";
+  return source;
+}
+
+static void BM_Lower_StraightLine(benchmark::State& state) {
+  CheckedFile file(MakeStraightLineSource(state.range(0)));
+  for (auto _ : state) {
+    llvm::LLVMContext llvm_context;
+    auto module = Lower::LowerToLLVM(llvm_context, "bench", file.sem_ir(),
+                                     /*vlog_stream=*/nullptr);
+    benchmark::DoNotOptimize(module.get());
+  }
+  state.counters["nodes"] = file.sem_ir().nodes_size();
+}
+
+static void BM_Lower_Branchy(benchmark::State& state) {
+  CheckedFile file(MakeBranchySource(state.range(0)));
+  for (auto _ : state) {
+    llvm::LLVMContext llvm_context;
+    auto module = Lower::LowerToLLVM(llvm_context, "bench", file.sem_ir(),
+                                     /*vlog_stream=*/nullptr);
+    benchmark::DoNotOptimize(module.get());
+  }
+  state.counters["nodes"] = file.sem_ir().nodes_size();
+  state.counters["blocks"] = file.sem_ir().node_blocks_size();
+}
+
+BENCHMARK(BM_Lower_StraightLine)->Arg(1000)->Arg(10000)->Arg(50000);
+BENCHMARK(BM_Lower_Branchy)->Arg(1000)->Arg(10000);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -1,4 +1,4 @@
-#include "Cocktail/Lexer/NumericLiteral.h"
+#include "Cocktail/Lex/NumericLiteral.h"
 
 #include <benchmark/benchmark.h>
 
@@ -11,18 +11,18 @@ using namespace Cocktail;
 
 static void BM_Lex_Float(benchmark::State& state) {
   for (auto _ : state) {
-    COCKTAIL_CHECK(LexedNumericLiteral::Lex("0.000001"));
+    COCKTAIL_CHECK(Lex::NumericLiteral::Lex("0.000001"));
   }
 }
 
 static void BM_Lex_Integer(benchmark::State& state) {
   for (auto _ : state) {
-    COCKTAIL_CHECK(LexedNumericLiteral::Lex("1_234_567_890"));
+    COCKTAIL_CHECK(Lex::NumericLiteral::Lex("1_234_567_890"));
   }
 }
 
 static void BM_ComputeValue_Float(benchmark::State& state) {
-  auto val = LexedNumericLiteral::Lex("0.000001");
+  auto val = Lex::NumericLiteral::Lex("0.000001");
   COCKTAIL_CHECK(val);
   auto emitter = NullDiagnosticEmitter<const char*>();
   for (auto _ : state) {
@@ -31,7 +31,7 @@ static void BM_ComputeValue_Float(benchmark::State& state) {
 }
 
 static void BM_ComputeValue_Integer(benchmark::State& state) {
-  auto val = LexedNumericLiteral::Lex("1_234_567_890");
+  auto val = Lex::NumericLiteral::Lex("1_234_567_890");
   auto emitter = NullDiagnosticEmitter<const char*>();
   COCKTAIL_CHECK(val);
   for (auto _ : state) {
@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+
+#include "Cocktail/Common/Check.h"
+#include "Cocktail/Driver/Driver.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace {
+
+using namespace Cocktail;
+
+// Runs `compile --phase=codegen` on an empty file with a fresh driver each
+// iteration, so that the time is dominated by per-invocation setup: builtins,
+// target initialization and target machine creation.
+static void BM_Startup_CodeGenEmptyFile(benchmark::State& state) {
+  llvm::vfs::InMemoryFileSystem fs;
+  fs.addFile("empty.carbon", /*ModificationTime=*/0,
+             llvm::MemoryBuffer::getMemBuffer(""));
+  llvm::raw_null_ostream output_stream;
+  llvm::raw_null_ostream error_stream;
+
+  for (auto _ : state) {
+    Driver driver(fs, output_stream, error_stream);
+    bool success = driver.RunCommand(
+        {"compile", "--phase=codegen", "--output=-", "empty.carbon"});
+    COCKTAIL_CHECK(success) << "Compiling an empty file failed";
+  }
+}
+
+BENCHMARK(BM_Startup_CodeGenEmptyFile);
+
+}  // namespace
+
+BENCHMARK_MAIN();
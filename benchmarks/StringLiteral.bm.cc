@@ -1,4 +1,4 @@
-#include "Cocktail/Lexer/StringLiteral.h"
+#include "Cocktail/Lex/StringLiteral.h"
 
 #include <benchmark/benchmark.h>
 
@@ -12,7 +12,7 @@ static void BM_ValidString(benchmark::State& state, std::string_view introducer,
   x.append(100000, 'a');
   x.append(terminator);
   for (auto _ : state) {
-    LexedStringLiteral::Lex(x);
+    Lex::StringLiteral::Lex(x);
   }
 }
 
@@ -47,7 +47,7 @@ static void BM_IncompleteWithRepeatedEscapes(benchmark::State& state,
     x.append("n ");
   }
   for (auto _ : state) {
-    LexedStringLiteral::Lex(x);
+    Lex::StringLiteral::Lex(x);
   }
 }
 
@@ -0,0 +1,35 @@
+#include "experimental/AST/Arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Cocktail {
+
+Arena ast_arena;
+
+Arena::~Arena() {
+  for (auto d = destructors_.rbegin(); d != destructors_.rend(); ++d) {
+    d->second(d->first);
+  }
+}
+
+auto Arena::Allocate(size_t size, size_t align) -> void* {
+  auto addr = reinterpret_cast<uintptr_t>(next_);
+  size_t padding = (align - addr % align) % align;
+  if (next_ == nullptr ||
+      static_cast<size_t>(end_ - next_) < padding + size) {
+    // Anything too big to share a chunk gets one of its own.
+    size_t chunk_size = std::max(ChunkSize, size + align);
+    chunks_.push_back(std::make_unique<char[]>(chunk_size));
+    reserved_bytes_ += chunk_size;
+    next_ = chunks_.back().get();
+    end_ = next_ + chunk_size;
+    addr = reinterpret_cast<uintptr_t>(next_);
+    padding = (align - addr % align) % align;
+  }
+  char* p = next_ + padding;
+  next_ = p + size;
+  return p;
+}
+
+}  // namespace Cocktail
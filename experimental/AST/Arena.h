@@ -0,0 +1,55 @@
+#ifndef COCKTAIL_EXPERIMENTAL_AST_ARENA_H
+#define COCKTAIL_EXPERIMENTAL_AST_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Cocktail {
+
+// Owns the nodes of the AST and the lists that hold their children.
+// Objects are carved out of large chunks in the order they are made, so a
+// parent and its children usually share a few cache lines, and they are all
+// destroyed together when the arena is.
+class Arena {
+ public:
+  Arena() = default;
+  Arena(const Arena&) = delete;
+  auto operator=(const Arena&) -> Arena& = delete;
+  ~Arena();
+
+  template <typename T, typename... Args>
+  auto New(Args&&... args) -> T* {
+    void* storage = Allocate(sizeof(T), alignof(T));
+    T* p = new (storage) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible_v<T>) {
+      destructors_.push_back({p, [](void* q) { static_cast<T*>(q)->~T(); }});
+    }
+    return p;
+  }
+
+  // The number of bytes taken from the system for this arena.
+  auto reserved_bytes() const -> size_t { return reserved_bytes_; }
+
+ private:
+  static constexpr size_t ChunkSize = 64 * 1024;
+
+  auto Allocate(size_t size, size_t align) -> void*;
+
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  char* next_ = nullptr;
+  char* end_ = nullptr;
+  size_t reserved_bytes_ = 0;
+  // The objects that need destroying, in the order they were made.
+  std::vector<std::pair<void*, void (*)(void*)>> destructors_;
+};
+
+// The arena that the `Make*` functions allocate from.
+extern Arena ast_arena;
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_EXPERIMENTAL_AST_ARENA_H
@@ -2,10 +2,12 @@
 
 #include <iostream>
 
+#include "experimental/AST/Arena.h"
+
 namespace Cocktail {
 
 auto MakeFunDecl(FunctionDefinition* f) -> Declaration* {
-  auto* d = new Declaration();
+  auto* d = ast_arena.New<Declaration>();
   d->tag = DeclarationKind::FunctionDeclaration;
   d->u.fun_def = f;
   return d;
@@ -13,11 +15,11 @@ auto MakeFunDecl(FunctionDefinition* f) -> Declaration* {
 
 auto MakeStructDecl(int line_num, std::string name, std::list<Member*>* members)
     -> Declaration* {
-  auto* d = new Declaration();
+  auto* d = ast_arena.New<Declaration>();
   d->tag = DeclarationKind::StructDeclaration;
-  d->u.struct_def = new StructDefinition();
+  d->u.struct_def = ast_arena.New<StructDefinition>();
   d->u.struct_def->line_num = line_num;
-  d->u.struct_def->name = new std::string(std::move(name));
+  d->u.struct_def->name = InternName(name);
   d->u.struct_def->members = members;
   return d;
 }
@@ -25,10 +27,10 @@ auto MakeStructDecl(int line_num, std::string name, std::list<Member*>* members)
 auto MakeChoiceDecl(int line_num, std::string name,
                     std::list<std::pair<std::string, Expression*>>* alts)
     -> Declaration* {
-  auto* d = new Declaration();
+  auto* d = ast_arena.New<Declaration>();
   d->tag = DeclarationKind::ChoiceDeclaration;
   d->u.choice_def.line_num = line_num;
-  d->u.choice_def.name = new std::string(std::move(name));
+  d->u.choice_def.name = InternName(name);
   d->u.choice_def.alternatives = alts;
   return d;
 }
@@ -6,6 +6,7 @@
 
 #include "experimental/AST/FunctionDefinition.h"
 #include "experimental/AST/Member.h"
+#include "experimental/AST/Name.h"
 #include "experimental/AST/StructDefinition.h"
 
 namespace Cocktail {
@@ -25,7 +26,7 @@ struct Declaration {
 
     struct {
       int line_num;
-      std::string* name;
+      Name name;
       std::list<std::pair<std::string, Expression*>>* alternatives;
     } choice_def;
 
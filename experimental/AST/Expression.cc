@@ -2,31 +2,33 @@
 
 #include <iostream>
 
+#include "experimental/AST/Arena.h"
+
 namespace Cocktail {
 
 auto MakeTypeType(int line_num) -> Expression* {
-  auto* t = new Expression();
+  auto* t = ast_arena.New<Expression>();
   t->tag = ExpressionKind::TypeT;
   t->line_num = line_num;
   return t;
 }
 
 auto MakeIntType(int line_num) -> Expression* {
-  auto* t = new Expression();
+  auto* t = ast_arena.New<Expression>();
   t->tag = ExpressionKind::IntT;
   t->line_num = line_num;
   return t;
 }
 
 auto MakeBoolType(int line_num) -> Expression* {
-  auto* t = new Expression();
+  auto* t = ast_arena.New<Expression>();
   t->tag = ExpressionKind::BoolT;
   t->line_num = line_num;
   return t;
 }
 
 auto MakeAutoType(int line_num) -> Expression* {
-  auto* t = new Expression();
+  auto* t = ast_arena.New<Expression>();
   t->tag = ExpressionKind::AutoT;
   t->line_num = line_num;
   return t;
@@ -34,7 +36,7 @@ auto MakeAutoType(int line_num) -> Expression* {
 
 auto MakeFunType(int line_num, Expression* param, Expression* ret)
     -> Expression* {
-  auto* t = new Expression();
+  auto* t = ast_arena.New<Expression>();
   t->tag = ExpressionKind::FunctionT;
   t->line_num = line_num;
   t->u.function_type.parameter = param;
@@ -43,25 +45,28 @@ auto MakeFunType(int line_num, Expression* param, Expression* ret)
 }
 
 auto MakeVar(int line_num, std::string var) -> Expression* {
-  auto* v = new Expression();
+  auto* v = ast_arena.New<Expression>();
   v->line_num = line_num;
   v->tag = ExpressionKind::Variable;
-  v->u.variable.name = new std::string(std::move(var));
+  v->u.variable.name = InternName(var);
+  v->u.variable.depth = 0;
+  v->u.variable.slot = -1;
   return v;
 }
 
 auto MakeVarPat(int line_num, std::string var, Expression* type)
     -> Expression* {
-  auto* v = new Expression();
+  auto* v = ast_arena.New<Expression>();
   v->line_num = line_num;
   v->tag = ExpressionKind::PatternVariable;
-  v->u.pattern_variable.name = new std::string(std::move(var));
+  v->u.pattern_variable.name = InternName(var);
   v->u.pattern_variable.type = type;
+  v->u.pattern_variable.slot = -1;
   return v;
 }
 
 auto MakeInt(int line_num, int i) -> Expression* {
-  auto* e = new Expression();
+  auto* e = ast_arena.New<Expression>();
   e->line_num = line_num;
   e->tag = ExpressionKind::Integer;
   e->u.integer = i;
@@ -69,16 +74,16 @@ auto MakeInt(int line_num, int i) -> Expression* {
 }
 
 auto MakeBool(int line_num, bool b) -> Expression* {
-  auto* e = new Expression();
+  auto* e = ast_arena.New<Expression>();
   e->line_num = line_num;
   e->tag = ExpressionKind::Boolean;
   e->u.boolean = b;
   return e;
 }
 
-auto MakeOp(int line_num, enum Operator op, std::vector<Expression*>* args)
+auto MakeOp(int line_num, enum Operator op, ExpressionList* args)
     -> Expression* {
-  auto* e = new Expression();
+  auto* e = ast_arena.New<Expression>();
   e->line_num = line_num;
   e->tag = ExpressionKind::PrimitiveOp;
   e->u.primitive_op.op = op;
@@ -87,11 +92,11 @@ auto MakeOp(int line_num, enum Operator op, std::vector<Expression*>* args)
 }
 
 auto MakeUnOp(int line_num, enum Operator op, Expression* arg) -> Expression* {
-  auto* e = new Expression();
+  auto* e = ast_arena.New<Expression>();
   e->line_num = line_num;
   e->tag = ExpressionKind::PrimitiveOp;
   e->u.primitive_op.op = op;
-  auto* args = new std::vector<Expression*>();
+  auto* args = ast_arena.New<ExpressionList>();
   args->push_back(arg);
   e->u.primitive_op.arguments = args;
   return e;
@@ -99,11 +104,11 @@ auto MakeUnOp(int line_num, enum Operator op, Expression* arg) -> Expression* {
 
 auto MakeBinOp(int line_num, enum Operator op, Expression* arg1,
                Expression* arg2) -> Expression* {
-  auto* e = new Expression();
+  auto* e = ast_arena.New<Expression>();
   e->line_num = line_num;
   e->tag = ExpressionKind::PrimitiveOp;
   e->u.primitive_op.op = op;
-  auto* args = new std::vector<Expression*>();
+  auto* args = ast_arena.New<ExpressionList>();
   args->push_back(arg1);
   args->push_back(arg2);
   e->u.primitive_op.arguments = args;
@@ -111,7 +116,7 @@ auto MakeBinOp(int line_num, enum Operator op, Expression* arg1,
 }
 
 auto MakeCall(int line_num, Expression* fun, Expression* arg) -> Expression* {
-  auto* e = new Expression();
+  auto* e = ast_arena.New<Expression>();
   e->line_num = line_num;
   e->tag = ExpressionKind::Call;
   e->u.call.function = fun;
@@ -121,18 +126,16 @@ auto MakeCall(int line_num, Expression* fun, Expression* arg) -> Expression* {
 
 auto MakeGetField(int line_num, Expression* exp, std::string field)
     -> Expression* {
-  auto* e = new Expression();
+  auto* e = ast_arena.New<Expression>();
   e->line_num = line_num;
   e->tag = ExpressionKind::GetField;
   e->u.get_field.aggregate = exp;
-  e->u.get_field.field = new std::string(std::move(field));
+  e->u.get_field.field = InternName(field);
   return e;
 }
 
-auto MakeTuple(int line_num,
-               std::vector<std::pair<std::string, Expression*>>* args)
-    -> Expression* {
-  auto* e = new Expression();
+auto MakeTuple(int line_num, FieldList* args) -> Expression* {
+  auto* e = ast_arena.New<Expression>();
   e->line_num = line_num;
   e->tag = ExpressionKind::Tuple;
   int i = 0;
@@ -147,7 +150,7 @@ auto MakeTuple(int line_num,
 }
 
 auto MakeIndex(int line_num, Expression* exp, Expression* i) -> Expression* {
-  auto* e = new Expression();
+  auto* e = ast_arena.New<Expression>();
   e->line_num = line_num;
   e->tag = ExpressionKind::Index;
   e->u.index.aggregate = exp;
@@ -181,8 +184,7 @@ static void PrintOp(Operator op) {
   }
 }
 
-static void PrintFields(
-    std::vector<std::pair<std::string, Expression*>>* fields) {
+static void PrintFields(FieldList* fields) {
   int i = 0;
   for (auto iter = fields->begin(); iter != fields->end(); ++iter, ++i) {
     if (i != 0) {
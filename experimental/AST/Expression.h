@@ -2,10 +2,20 @@
 #define COCKTAIL_EXPERIMENTAL_AST_EXPRESSION_H
 
 #include <string>
-#include <vector>
+#include <utility>
+
+#include "experimental/AST/Name.h"
+#include "experimental/AST/SmallVector.h"
 
 namespace Cocktail {
 
+struct Expression;
+
+// The operands of a primitive operator.
+using ExpressionList = SmallVector<Expression*, 2>;
+// The fields of a tuple, in order. Positional fields are named by position.
+using FieldList = SmallVector<std::pair<std::string, Expression*>, 2>;
+
 enum class ExpressionKind {
   AutoT,
   BoolT,
@@ -38,12 +48,17 @@ struct Expression {
   ExpressionKind tag;
   union {
     struct {
-      std::string* name;
+      Name name;
+      // Where the variable lives, as resolved for the interpreter: a slot of
+      // the enclosing function's frame at depth 0, or of the globals at
+      // depth 1. The slot is -1 while the variable is unresolved.
+      int depth;
+      int slot;
     } variable;
 
     struct {
       Expression* aggregate;
-      std::string* field;
+      Name field;
     } get_field;
 
     struct {
@@ -52,20 +67,23 @@ struct Expression {
     } index;
 
     struct {
-      std::string* name;
+      Name name;
       Expression* type;
+      // The frame slot that the variable is bound to, or -1 while the
+      // variable is unresolved.
+      int slot;
     } pattern_variable;
 
     int integer;
     bool boolean;
 
     struct {
-      std::vector<std::pair<std::string, Expression*>>* fields;
+      FieldList* fields;
     } tuple;
 
     struct {
       Operator op;
-      std::vector<Expression*>* arguments;
+      ExpressionList* arguments;
     } primitive_op;
 
     struct {
@@ -84,17 +102,14 @@ auto MakeVar(int line_num, std::string var) -> Expression*;
 auto MakeVarPat(int line_num, std::string var, Expression* type) -> Expression*;
 auto MakeInt(int line_num, int i) -> Expression*;
 auto MakeBool(int line_num, bool b) -> Expression*;
-auto MakeOp(int line_num, Operator op, std::vector<Expression*>* args)
-    -> Expression*;
+auto MakeOp(int line_num, Operator op, ExpressionList* args) -> Expression*;
 auto MakeUnOp(int line_num, enum Operator op, Expression* arg) -> Expression*;
 auto MakeBinOp(int line_num, enum Operator op, Expression* arg1,
                Expression* arg2) -> Expression*;
 auto MakeCall(int line_num, Expression* fun, Expression* arg) -> Expression*;
 auto MakeGetField(int line_num, Expression* exp, std::string field)
     -> Expression*;
-auto MakeTuple(int line_num,
-               std::vector<std::pair<std::string, Expression*>>* args)
-    -> Expression*;
+auto MakeTuple(int line_num, FieldList* args) -> Expression*;
 auto MakeIndex(int line_num, Expression* exp, Expression* i) -> Expression*;
 
 auto MakeTypeType(int line_num) -> Expression*;
@@ -1,9 +1,11 @@
 #include "experimental/AST/ExpressionOrFieldList.h"
 
+#include "experimental/AST/Arena.h"
+
 namespace Cocktail {
 
 auto MakeExp(Expression* exp) -> ExpOrFieldList* {
-  auto e = new ExpOrFieldList();
+  auto e = ast_arena.New<ExpOrFieldList>();
   e->tag = ExpOrFieldListKind::Exp;
   e->u.exp = exp;
   return e;
@@ -11,14 +13,14 @@ auto MakeExp(Expression* exp) -> ExpOrFieldList* {
 
 auto MakeFieldList(std::list<std::pair<std::string, Expression*>>* fields)
     -> ExpOrFieldList* {
-  auto e = new ExpOrFieldList();
+  auto e = ast_arena.New<ExpOrFieldList>();
   e->tag = ExpOrFieldListKind::FieldList;
   e->u.fields = fields;
   return e;
 }
 
 auto MakeConsField(ExpOrFieldList* e1, ExpOrFieldList* e2) -> ExpOrFieldList* {
-  auto fields = new std::list<std::pair<std::string, Expression*>>();
+  auto fields = ast_arena.New<std::list<std::pair<std::string, Expression*>>>();
   switch (e1->tag) {
     case ExpOrFieldListKind::Exp:
       fields->push_back(std::make_pair("", e1->u.exp));
@@ -1,13 +1,14 @@
 #include <iostream>
 
 #include "experimental/AST/FunctionDefinition.h"
+#include "experimental/AST/Arena.h"
 
 namespace Cocktail {
 
 auto MakeFunDef(int line_num, std::string name, Expression* ret_type,
                 Expression* param_pattern, Statement* body)
     -> struct FunctionDefinition* {
-  auto* f = new struct FunctionDefinition();
+  auto* f = ast_arena.New<FunctionDefinition>();
   f->line_num = line_num;
   f->name = std::move(name);
   f->return_type = ret_type;
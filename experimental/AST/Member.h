@@ -4,6 +4,7 @@
 #include <string>
 
 #include "experimental/AST/Expression.h"
+#include "experimental/AST/Name.h"
 
 namespace Cocktail {
 
@@ -16,7 +17,7 @@ struct Member {
   MemberKind tag;
   union {
     struct {
-      std::string* name;
+      Name name;
       Expression* type;
     } field;
   } u;
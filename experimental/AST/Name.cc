@@ -0,0 +1,14 @@
+#include "experimental/AST/Name.h"
+
+#include <unordered_set>
+
+namespace Cocktail {
+
+auto InternName(const std::string& name) -> Name {
+  // Elements of an unordered_set never move, so their addresses can serve
+  // as handles.
+  static auto* names = new std::unordered_set<std::string>();
+  return &*names->insert(name).first;
+}
+
+}  // namespace Cocktail
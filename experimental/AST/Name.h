@@ -0,0 +1,16 @@
+#ifndef COCKTAIL_EXPERIMENTAL_AST_NAME_H
+#define COCKTAIL_EXPERIMENTAL_AST_NAME_H
+
+#include <string>
+
+namespace Cocktail {
+
+// A handle to an interned name. Two names are equal iff their handles are,
+// and a handle stays valid for as long as the program runs.
+using Name = const std::string*;
+
+auto InternName(const std::string& name) -> Name;
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_EXPERIMENTAL_AST_NAME_H
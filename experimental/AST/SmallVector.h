@@ -0,0 +1,93 @@
+#ifndef COCKTAIL_EXPERIMENTAL_AST_SMALL_VECTOR_H
+#define COCKTAIL_EXPERIMENTAL_AST_SMALL_VECTOR_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace Cocktail {
+
+// A vector that holds its first `N` elements inline and only moves them to
+// the heap once it grows past that. Most AST nodes have one or two children,
+// so this keeps them in the arena next to their parent.
+template <typename T, size_t N>
+class SmallVector {
+ public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  SmallVector() = default;
+  SmallVector(std::initializer_list<T> elements) {
+    for (const T& element : elements) {
+      push_back(element);
+    }
+  }
+  template <typename Iterator>
+  SmallVector(Iterator first, Iterator last) {
+    for (; first != last; ++first) {
+      push_back(*first);
+    }
+  }
+  SmallVector(const SmallVector& other)
+      : SmallVector(other.begin(), other.end()) {}
+  auto operator=(const SmallVector& other) -> SmallVector& {
+    if (this != &other) {
+      clear();
+      for (const T& element : other) {
+        push_back(element);
+      }
+    }
+    return *this;
+  }
+
+  void push_back(T element) {
+    if (size_ < N) {
+      inline_[size_++] = std::move(element);
+      return;
+    }
+    if (size_ == N) {
+      overflow_.reserve(2 * N);
+      for (T& e : inline_) {
+        overflow_.push_back(std::move(e));
+      }
+    }
+    overflow_.push_back(std::move(element));
+    ++size_;
+  }
+
+  void clear() {
+    overflow_.clear();
+    size_ = 0;
+  }
+
+  auto size() const -> size_t { return size_; }
+  auto empty() const -> bool { return size_ == 0; }
+
+  auto data() -> T* { return size_ > N ? overflow_.data() : inline_; }
+  auto data() const -> const T* {
+    return size_ > N ? overflow_.data() : inline_;
+  }
+
+  auto begin() -> iterator { return data(); }
+  auto end() -> iterator { return data() + size_; }
+  auto begin() const -> const_iterator { return data(); }
+  auto end() const -> const_iterator { return data() + size_; }
+
+  auto operator[](size_t i) -> T& { return data()[i]; }
+  auto operator[](size_t i) const -> const T& { return data()[i]; }
+  auto front() -> T& { return data()[0]; }
+  auto front() const -> const T& { return data()[0]; }
+  auto back() -> T& { return data()[size_ - 1]; }
+  auto back() const -> const T& { return data()[size_ - 1]; }
+
+ private:
+  size_t size_ = 0;
+  T inline_[N] = {};
+  std::vector<T> overflow_;
+};
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_EXPERIMENTAL_AST_SMALL_VECTOR_H
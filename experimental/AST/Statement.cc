@@ -2,10 +2,12 @@
 
 #include <iostream>
 
+#include "experimental/AST/Arena.h"
+
 namespace Cocktail {
 
 auto MakeExpStmt(int line_num, Expression* exp) -> Statement* {
-  auto* s = new Statement();
+  auto* s = ast_arena.New<Statement>();
   s->line_num = line_num;
   s->tag = StatementKind::ExpressionStatement;
   s->u.exp = exp;
@@ -13,7 +15,7 @@ auto MakeExpStmt(int line_num, Expression* exp) -> Statement* {
 }
 
 auto MakeAssign(int line_num, Expression* lhs, Expression* rhs) -> Statement* {
-  auto* s = new Statement();
+  auto* s = ast_arena.New<Statement>();
   s->line_num = line_num;
   s->tag = StatementKind::Assign;
   s->u.assign.lhs = lhs;
@@ -22,7 +24,7 @@ auto MakeAssign(int line_num, Expression* lhs, Expression* rhs) -> Statement* {
 }
 
 auto MakeVarDef(int line_num, Expression* pat, Expression* init) -> Statement* {
-  auto* s = new Statement();
+  auto* s = ast_arena.New<Statement>();
   s->line_num = line_num;
   s->tag = StatementKind::VariableDefinition;
   s->u.variable_definition.pat = pat;
@@ -32,7 +34,7 @@ auto MakeVarDef(int line_num, Expression* pat, Expression* init) -> Statement* {
 
 auto MakeIf(int line_num, Expression* cond, Statement* then_stmt,
             Statement* else_stmt) -> Statement* {
-  auto* s = new Statement();
+  auto* s = ast_arena.New<Statement>();
   s->line_num = line_num;
   s->tag = StatementKind::If;
   s->u.if_stmt.cond = cond;
@@ -42,7 +44,7 @@ auto MakeIf(int line_num, Expression* cond, Statement* then_stmt,
 }
 
 auto MakeWhile(int line_num, Expression* cond, Statement* body) -> Statement* {
-  auto* s = new Statement();
+  auto* s = ast_arena.New<Statement>();
   s->line_num = line_num;
   s->tag = StatementKind::While;
   s->u.while_stmt.cond = cond;
@@ -52,21 +54,21 @@ auto MakeWhile(int line_num, Expression* cond, Statement* body) -> Statement* {
 
 auto MakeBreak(int line_num) -> Statement* {
   std::cout << "MakeBlock" << std::endl;
-  auto* s = new Statement();
+  auto* s = ast_arena.New<Statement>();
   s->line_num = line_num;
   s->tag = StatementKind::Break;
   return s;
 }
 
 auto MakeContinue(int line_num) -> Statement* {
-  auto* s = new Statement();
+  auto* s = ast_arena.New<Statement>();
   s->line_num = line_num;
   s->tag = StatementKind::Continue;
   return s;
 }
 
 auto MakeReturn(int line_num, Expression* e) -> Statement* {
-  auto* s = new Statement();
+  auto* s = ast_arena.New<Statement>();
   s->line_num = line_num;
   s->tag = StatementKind::Return;
   s->u.return_stmt = e;
@@ -74,7 +76,7 @@ auto MakeReturn(int line_num, Expression* e) -> Statement* {
 }
 
 auto MakeSeq(int line_num, Statement* s1, Statement* s2) -> Statement* {
-  auto* s = new Statement();
+  auto* s = ast_arena.New<Statement>();
   s->line_num = line_num;
   s->tag = StatementKind::Sequence;
   s->u.sequence.stmt = s1;
@@ -83,7 +85,7 @@ auto MakeSeq(int line_num, Statement* s1, Statement* s2) -> Statement* {
 }
 
 auto MakeBlock(int line_num, Statement* stmt) -> Statement* {
-  auto* s = new Statement();
+  auto* s = ast_arena.New<Statement>();
   s->line_num = line_num;
   s->tag = StatementKind::Block;
   s->u.block.stmt = stmt;
@@ -93,7 +95,7 @@ auto MakeBlock(int line_num, Statement* stmt) -> Statement* {
 auto MakeMatch(int line_num, Expression* exp,
                std::list<std::pair<Expression*, Statement*>>* clauses)
     -> Statement* {
-  auto* s = new Statement();
+  auto* s = ast_arena.New<Statement>();
   s->line_num = line_num;
   s->tag = StatementKind::Match;
   s->u.match_stmt.exp = exp;
@@ -5,12 +5,13 @@
 #include <string>
 
 #include "experimental/AST/Member.h"
+#include "experimental/AST/Name.h"
 
 namespace Cocktail {
 
 struct StructDefinition {
   int line_num;
-  std::string* name;
+  Name name;
   std::list<Member*>* members;
 };
 
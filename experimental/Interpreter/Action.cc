@@ -44,16 +44,29 @@ void PrintAct(Action* act, std::ostream& out) {
   }
 }
 
-void PrintActList(Cons<Action*>* ls, std::ostream& out) {
-  if (ls) {
-    PrintAct(ls->curr, out);
-    if (ls->next) {
+void PrintActList(const Stack<Action*>& ls, std::ostream& out) {
+  bool first = true;
+  for (Action* act : ls) {
+    if (!first) {
       out << " :: ";
-      PrintActList(ls->next, out);
     }
+    first = false;
+    PrintAct(act, out);
   }
 }
 
+auto Action::operator new(size_t size) -> void* {
+  void* p = interpreter_pool.Allocate(size);
+  if (state) {
+    state->heap.Track(static_cast<Action*>(p));
+  }
+  return p;
+}
+
+void Action::operator delete(void* p, size_t size) {
+  interpreter_pool.Deallocate(p, size);
+}
+
 auto MakeExpAct(Expression* e) -> Action* {
   auto* act = new Action();
   act->tag = ActionKind::ExpressionAction;
@@ -1,12 +1,14 @@
 #ifndef COCKTAIL_EXPERIMENTAL_INTERPRETER_ACTION_H
 #define COCKTAIL_EXPERIMENTAL_INTERPRETER_ACTION_H
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
 #include "experimental/AST/Expression.h"
 #include "experimental/AST/Statement.h"
-#include "experimental/Interpreter/ConsList.h"
+#include "experimental/Interpreter/Stack.h"
 #include "experimental/Interpreter/Value.h"
 
 namespace Cocktail {
@@ -21,6 +23,11 @@ enum class ActionKind {
 };
 
 struct Action {
+  // Actions come from `interpreter_pool`, and while a program runs they are
+  // owned by its heap; see Heap.h.
+  static auto operator new(size_t size) -> void*;
+  static void operator delete(void* p, size_t size);
+
   ActionKind tag;
   union {
     Expression* exp;  // for LValAction and ExpressionAction
@@ -30,10 +37,11 @@ struct Action {
   } u;
   int pos;                      // position or state of the action
   std::vector<Value*> results;  // results from subexpression
+  uint32_t mark;                // the garbage collector's mark
 };
 
 void PrintAct(Action* act, std::ostream& out);
-void PrintActList(Cons<Action*>* ls, std::ostream& out);
+void PrintActList(const Stack<Action*>& ls, std::ostream& out);
 auto MakeExpAct(Expression* e) -> Action*;
 auto MakeLvalAct(Expression* e) -> Action*;
 auto MakeStmtAct(Statement* s) -> Action*;
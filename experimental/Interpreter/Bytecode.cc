@@ -0,0 +1,443 @@
+#include "experimental/Interpreter/Bytecode.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <utility>
+
+#include "experimental/AST/FunctionDefinition.h"
+
+namespace Cocktail {
+
+namespace {
+
+struct FunctionInfo {
+  int index;
+  // The field names of the parameter tuple, in register order.
+  std::vector<std::string> param_names;
+};
+
+using FunctionTable = std::map<std::string, FunctionInfo>;
+
+// Whether `type` is a type expression for a value the VM keeps in a register.
+// Only the empty tuple is allowed, which is how `()` return types are written.
+auto IsRegisterType(Expression* type, bool allow_auto) -> bool {
+  switch (type->tag) {
+    case ExpressionKind::IntT:
+    case ExpressionKind::BoolT:
+      return true;
+    case ExpressionKind::AutoT:
+      return allow_auto;
+    case ExpressionKind::Tuple:
+      return type->u.tuple.fields->empty();
+    default:
+      return false;
+  }
+}
+
+class FunctionCompiler {
+ public:
+  FunctionCompiler(const FunctionTable& functions, BytecodeFunction* out)
+      : functions_(functions), out_(out) {}
+
+  // Compiles `def`, whose signature has already been accepted by
+  // `AddSignature`. Returns the reason when the body can't be compiled.
+  auto Compile(FunctionDefinition* def) -> std::optional<std::string> {
+    scopes_.emplace_back();
+    for (auto& field : *def->param_pattern->u.tuple.fields) {
+      scopes_.back().push_back(
+          {*field.second->u.pattern_variable.name, AllocateRegister()});
+    }
+    CompileStmt(def->body);
+    // Control can reach here when every branch of a trailing `if` returns.
+    Emit(OpCode::FellOffEnd);
+    return failure_;
+  }
+
+ private:
+  struct Loop {
+    int continue_target;
+    std::vector<int> break_jumps;
+  };
+
+  void Fail(int line_num, const std::string& what) {
+    if (!failure_) {
+      failure_ = std::to_string(line_num) + ": " + what;
+    }
+  }
+
+  auto AllocateRegister() -> int {
+    int reg = next_register_++;
+    out_->num_registers = std::max(out_->num_registers, next_register_);
+    return reg;
+  }
+
+  auto Emit(OpCode op, int a = 0, int b = 0, int c = 0) -> int {
+    out_->code.push_back({.op = op, .a = a, .b = b, .c = c});
+    return static_cast<int>(out_->code.size()) - 1;
+  }
+
+  auto Here() -> int { return static_cast<int>(out_->code.size()); }
+
+  auto LookupLocal(const std::string& name) -> std::optional<int> {
+    for (auto scope = scopes_.rbegin(); scope != scopes_.rend(); ++scope) {
+      for (auto local = scope->rbegin(); local != scope->rend(); ++local) {
+        if (local->first == name) {
+          return local->second;
+        }
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Returns a register holding the value of `e`. Locals are used in place,
+  // anything else is evaluated into a new temporary.
+  auto CompileOperand(Expression* e) -> int {
+    if (e->tag == ExpressionKind::Variable) {
+      if (auto reg = LookupLocal(*e->u.variable.name)) {
+        return *reg;
+      }
+    }
+    int reg = AllocateRegister();
+    CompileExp(e, reg);
+    return reg;
+  }
+
+  void CompileExp(Expression* e, int dst) {
+    int mark = next_register_;
+    switch (e->tag) {
+      case ExpressionKind::Integer:
+        Emit(OpCode::LoadInt, dst, e->u.integer);
+        break;
+      case ExpressionKind::Boolean:
+        Emit(OpCode::LoadInt, dst, e->u.boolean ? 1 : 0);
+        break;
+      case ExpressionKind::Variable: {
+        auto reg = LookupLocal(*e->u.variable.name);
+        if (!reg) {
+          Fail(e->line_num, "`" + *e->u.variable.name + "` is not a local");
+        } else if (*reg != dst) {
+          Emit(OpCode::Move, dst, *reg);
+        }
+        break;
+      }
+      case ExpressionKind::Tuple:
+        // The empty tuple carries no information.
+        if (!e->u.tuple.fields->empty()) {
+          Fail(e->line_num, "tuple values");
+        }
+        Emit(OpCode::LoadInt, dst, 0);
+        break;
+      case ExpressionKind::PrimitiveOp: {
+        auto& args = *e->u.primitive_op.arguments;
+        int b = CompileOperand(args[0]);
+        int c = args.size() > 1 ? CompileOperand(args[1]) : 0;
+        switch (e->u.primitive_op.op) {
+          case Operator::Neg:
+            Emit(OpCode::Neg, dst, b);
+            break;
+          case Operator::Not:
+            Emit(OpCode::Not, dst, b);
+            break;
+          case Operator::Add:
+            Emit(OpCode::Add, dst, b, c);
+            break;
+          case Operator::Sub:
+            Emit(OpCode::Sub, dst, b, c);
+            break;
+          case Operator::And:
+            Emit(OpCode::And, dst, b, c);
+            break;
+          case Operator::Or:
+            Emit(OpCode::Or, dst, b, c);
+            break;
+          case Operator::Eq:
+            Emit(OpCode::Eq, dst, b, c);
+            break;
+        }
+        break;
+      }
+      case ExpressionKind::Call:
+        CompileCall(e, dst);
+        break;
+      default:
+        Fail(e->line_num, "this kind of expression");
+        break;
+    }
+    next_register_ = mark;
+  }
+
+  void CompileCall(Expression* e, int dst) {
+    Expression* fun = e->u.call.function;
+    Expression* arg = e->u.call.argument;
+    if (fun->tag != ExpressionKind::Variable ||
+        LookupLocal(*fun->u.variable.name)) {
+      Fail(e->line_num, "calls to function values");
+      return;
+    }
+    auto info = functions_.find(*fun->u.variable.name);
+    if (info == functions_.end()) {
+      Fail(e->line_num, "calls to `" + *fun->u.variable.name + "`");
+      return;
+    }
+    if (arg->tag != ExpressionKind::Tuple ||
+        arg->u.tuple.fields->size() != info->second.param_names.size()) {
+      Fail(e->line_num, "this form of argument list");
+      return;
+    }
+    // The arguments are evaluated in order into consecutive registers, which
+    // are copied into the callee's parameters.
+    int first = next_register_;
+    for (size_t i = 0; i < arg->u.tuple.fields->size(); ++i) {
+      AllocateRegister();
+    }
+    int i = 0;
+    for (auto& field : *arg->u.tuple.fields) {
+      if (field.first != info->second.param_names[i]) {
+        Fail(e->line_num, "arguments in a different order than parameters");
+      }
+      CompileExp(field.second, first + i);
+      ++i;
+    }
+    Emit(OpCode::Call, dst, info->second.index, first);
+  }
+
+  void CompileBranch(Statement* s) {
+    scopes_.emplace_back();
+    int mark = next_register_;
+    CompileStmt(s);
+    next_register_ = mark;
+    scopes_.pop_back();
+  }
+
+  void CompileStmt(Statement* s) {
+    if (!s) {
+      return;
+    }
+    int mark = next_register_;
+    switch (s->tag) {
+      case StatementKind::ExpressionStatement:
+        CompileExp(s->u.exp, AllocateRegister());
+        break;
+      case StatementKind::Assign: {
+        Expression* lhs = s->u.assign.lhs;
+        std::optional<int> reg;
+        if (lhs->tag == ExpressionKind::Variable) {
+          reg = LookupLocal(*lhs->u.variable.name);
+        }
+        if (!reg) {
+          Fail(s->line_num, "assignment to anything but a local");
+          break;
+        }
+        // Subexpressions go to temporaries, so `*reg` is only written by the
+        // last instruction.
+        CompileExp(s->u.assign.rhs, *reg);
+        break;
+      }
+      case StatementKind::VariableDefinition: {
+        Expression* pat = s->u.variable_definition.pat;
+        if (pat->tag != ExpressionKind::PatternVariable ||
+            !IsRegisterType(pat->u.pattern_variable.type,
+                            /*allow_auto=*/true)) {
+          Fail(s->line_num, "this kind of variable pattern");
+          break;
+        }
+        // The initializer is compiled before the name is in scope, since it
+        // may refer to a variable that the new one shadows.
+        int reg = AllocateRegister();
+        CompileExp(s->u.variable_definition.init, reg);
+        scopes_.back().push_back({*pat->u.pattern_variable.name, reg});
+        // The register stays allocated until the enclosing scope ends.
+        return;
+      }
+      case StatementKind::If: {
+        int cond = CompileOperand(s->u.if_stmt.cond);
+        int to_else = Emit(OpCode::JumpIfFalse, cond);
+        next_register_ = mark;
+        CompileBranch(s->u.if_stmt.then_stmt);
+        if (s->u.if_stmt.else_stmt) {
+          int to_end = Emit(OpCode::Jump);
+          out_->code[to_else].b = Here();
+          CompileBranch(s->u.if_stmt.else_stmt);
+          out_->code[to_end].a = Here();
+        } else {
+          out_->code[to_else].b = Here();
+        }
+        break;
+      }
+      case StatementKind::While: {
+        int top = Here();
+        int cond = CompileOperand(s->u.while_stmt.cond);
+        int to_end = Emit(OpCode::JumpIfFalse, cond);
+        next_register_ = mark;
+        loops_.push_back({.continue_target = top, .break_jumps = {}});
+        CompileBranch(s->u.while_stmt.body);
+        Emit(OpCode::Jump, top);
+        out_->code[to_end].b = Here();
+        for (int jump : loops_.back().break_jumps) {
+          out_->code[jump].a = Here();
+        }
+        loops_.pop_back();
+        break;
+      }
+      case StatementKind::Break:
+        if (loops_.empty()) {
+          Fail(s->line_num, "`break` outside of a loop");
+          break;
+        }
+        loops_.back().break_jumps.push_back(Emit(OpCode::Jump));
+        break;
+      case StatementKind::Continue:
+        if (loops_.empty()) {
+          Fail(s->line_num, "`continue` outside of a loop");
+          break;
+        }
+        Emit(OpCode::Jump, loops_.back().continue_target);
+        break;
+      case StatementKind::Return:
+        Emit(OpCode::Return, CompileOperand(s->u.return_stmt));
+        break;
+      case StatementKind::Sequence:
+        CompileStmt(s->u.sequence.stmt);
+        CompileStmt(s->u.sequence.next);
+        // Variables defined by the sequence stay in scope.
+        return;
+      case StatementKind::Block:
+        CompileBranch(s->u.block.stmt);
+        break;
+      case StatementKind::Match:
+        Fail(s->line_num, "`match`");
+        break;
+    }
+    next_register_ = mark;
+  }
+
+  const FunctionTable& functions_;
+  BytecodeFunction* out_;
+  std::vector<std::vector<std::pair<std::string, int>>> scopes_;
+  std::vector<Loop> loops_;
+  int next_register_ = 0;
+  std::optional<std::string> failure_;
+};
+
+// Records the signature of `def` in `functions`, or returns the reason it
+// can't be called by the VM.
+auto AddSignature(FunctionDefinition* def, int index, FunctionTable* functions)
+    -> std::optional<std::string> {
+  auto where = std::to_string(def->line_num) + ": ";
+  if (!def->body) {
+    return where + "functions without a body";
+  }
+  if (!IsRegisterType(def->return_type, /*allow_auto=*/false)) {
+    return where + "this return type";
+  }
+  if (def->param_pattern->tag != ExpressionKind::Tuple) {
+    return where + "this kind of parameter list";
+  }
+  FunctionInfo info = {.index = index, .param_names = {}};
+  for (auto& field : *def->param_pattern->u.tuple.fields) {
+    Expression* param = field.second;
+    if (param->tag != ExpressionKind::PatternVariable ||
+        !IsRegisterType(param->u.pattern_variable.type,
+                        /*allow_auto=*/false)) {
+      return where + "this kind of parameter";
+    }
+    info.param_names.push_back(field.first);
+  }
+  (*functions)[def->name] = std::move(info);
+  return std::nullopt;
+}
+
+}  // namespace
+
+auto CompileProgram(std::list<Declaration*>* fs, std::ostream& out)
+    -> std::optional<BytecodeProgram> {
+  BytecodeProgram program;
+  program.main_index = -1;
+  FunctionTable functions;
+  std::vector<FunctionDefinition*> defs;
+  for (auto& decl : *fs) {
+    if (decl->tag != DeclarationKind::FunctionDeclaration) {
+      // Only reachable through calls, which are rejected below.
+      continue;
+    }
+    FunctionDefinition* def = decl->u.fun_def;
+    int index = static_cast<int>(defs.size());
+    if (auto failure = AddSignature(def, index, &functions)) {
+      out << "bytecode compiler does not support " << def->name << ": "
+          << *failure << std::endl;
+      return std::nullopt;
+    }
+    if (def->name == "main") {
+      program.main_index = index;
+    }
+    defs.push_back(def);
+  }
+
+  for (auto* def : defs) {
+    int num_params = def->param_pattern->u.tuple.fields->size();
+    program.functions.push_back({.name = def->name,
+                                 .num_params = num_params,
+                                 .num_registers = 0,
+                                 .code = {}});
+  }
+  for (size_t i = 0; i < defs.size(); ++i) {
+    FunctionCompiler compiler(functions, &program.functions[i]);
+    if (auto failure = compiler.Compile(defs[i])) {
+      out << "bytecode compiler does not support " << defs[i]->name << ": "
+          << *failure << std::endl;
+      return std::nullopt;
+    }
+  }
+  return program;
+}
+
+static auto OpCodeName(OpCode op) -> const char* {
+  switch (op) {
+    case OpCode::LoadInt:
+      return "load_int";
+    case OpCode::Move:
+      return "move";
+    case OpCode::Neg:
+      return "neg";
+    case OpCode::Not:
+      return "not";
+    case OpCode::Add:
+      return "add";
+    case OpCode::Sub:
+      return "sub";
+    case OpCode::And:
+      return "and";
+    case OpCode::Or:
+      return "or";
+    case OpCode::Eq:
+      return "eq";
+    case OpCode::Jump:
+      return "jump";
+    case OpCode::JumpIfFalse:
+      return "jump_if_false";
+    case OpCode::Call:
+      return "call";
+    case OpCode::Return:
+      return "return";
+    case OpCode::FellOffEnd:
+      return "fell_off_end";
+  }
+  std::cerr << "internal error: unknown opcode " << static_cast<int>(op)
+            << std::endl;
+  exit(-1);
+}
+
+void PrintBytecode(const BytecodeProgram& program, std::ostream& out) {
+  for (const auto& function : program.functions) {
+    out << "fn " << function.name << " (params: " << function.num_params
+        << ", registers: " << function.num_registers << ")" << std::endl;
+    for (size_t pc = 0; pc < function.code.size(); ++pc) {
+      const Instruction& inst = function.code[pc];
+      out << "  " << pc << ": " << OpCodeName(inst.op) << " " << inst.a << " "
+          << inst.b << " " << inst.c << std::endl;
+    }
+  }
+}
+
+}  // namespace Cocktail
@@ -0,0 +1,68 @@
+#ifndef COCKTAIL_EXPERIMENTAL_INTERPRETER_BYTECODE_H
+#define COCKTAIL_EXPERIMENTAL_INTERPRETER_BYTECODE_H
+
+#include <iostream>
+#include <list>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "experimental/AST/Declaration.h"
+
+namespace Cocktail {
+
+// Instructions of the register VM. Unless noted otherwise, `a`, `b` and `c`
+// are register indices relative to the current call frame.
+enum class OpCode {
+  LoadInt,      // r[a] = b
+  Move,         // r[a] = r[b]
+  Neg,          // r[a] = -r[b]
+  Not,          // r[a] = !r[b]
+  Add,          // r[a] = r[b] + r[c]
+  Sub,          // r[a] = r[b] - r[c]
+  And,          // r[a] = r[b] && r[c]
+  Or,           // r[a] = r[b] || r[c]
+  Eq,           // r[a] = r[b] == r[c]
+  Jump,         // pc = a
+  JumpIfFalse,  // if (!r[a]) pc = b
+  Call,         // r[a] = function b applied to r[c], r[c + 1], ...
+  Return,       // return r[a]
+  FellOffEnd,   // runtime error, the function didn't `return`
+};
+
+struct Instruction {
+  OpCode op;
+  int a;
+  int b;
+  int c;
+};
+
+struct BytecodeFunction {
+  std::string name;
+  // The arguments are passed in registers [0, num_params).
+  int num_params;
+  int num_registers;
+  std::vector<Instruction> code;
+};
+
+struct BytecodeProgram {
+  std::vector<BytecodeFunction> functions;
+  int main_index;
+};
+
+// Compiles a type-checked program to bytecode. Integers and Booleans live
+// unboxed in registers and every variable is resolved to a register at
+// compile time, so the VM never looks up a name.
+//
+// The VM only covers programs whose values are all integers, Booleans and
+// the empty tuple. For anything else, such as structs, choices, `match` or
+// non-empty tuples, this prints the reason to `out` and returns
+// `std::nullopt`, and the program should be run by `InterpProgram` instead.
+auto CompileProgram(std::list<Declaration*>* fs, std::ostream& out)
+    -> std::optional<BytecodeProgram>;
+
+void PrintBytecode(const BytecodeProgram& program, std::ostream& out);
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_EXPERIMENTAL_INTERPRETER_BYTECODE_H
@@ -0,0 +1,275 @@
+#include "experimental/Interpreter/Heap.h"
+
+#include <algorithm>
+
+#include "experimental/Interpreter/Action.h"
+#include "experimental/Interpreter/Interpreter.h"
+
+namespace Cocktail {
+
+PoolAllocator interpreter_pool;
+bool report_heap_stats = false;
+
+/***** Pool Allocator *****/
+
+auto PoolAllocator::Allocate(size_t size) -> void* {
+  if (size == 0 || size > MaxSize) {
+    return ::operator new(size);
+  }
+  size_t c = (size - 1) / Granularity;
+  if (free_lists_[c] == nullptr) {
+    Refill(c);
+  }
+  FreeBlock* block = free_lists_[c];
+  free_lists_[c] = block->next;
+  return block;
+}
+
+void PoolAllocator::Deallocate(void* p, size_t size) {
+  if (size == 0 || size > MaxSize) {
+    ::operator delete(p);
+    return;
+  }
+  size_t c = (size - 1) / Granularity;
+  auto* block = static_cast<FreeBlock*>(p);
+  block->next = free_lists_[c];
+  free_lists_[c] = block;
+}
+
+void PoolAllocator::Refill(size_t c) {
+  size_t block_size = (c + 1) * Granularity;
+  chunks_.push_back(std::make_unique<char[]>(ChunkSize));
+  reserved_bytes_ += ChunkSize;
+  char* chunk = chunks_.back().get();
+  for (size_t offset = 0; offset + block_size <= ChunkSize;
+       offset += block_size) {
+    auto* block = reinterpret_cast<FreeBlock*>(chunk + offset);
+    block->next = free_lists_[c];
+    free_lists_[c] = block;
+  }
+}
+
+/***** Heap *****/
+
+// Frees `v` along with the element list that it owns. Names are interned,
+// and field and alternative lists of types can be shared between type
+// values, so they are left alone.
+static void FreeValue(Value* v) {
+  if (v->tag == ValKind::TupleV) {
+    delete v->u.tuple.elts;
+  }
+  delete v;
+}
+
+Heap::~Heap() {
+  for (Value* v : values_) {
+    FreeValue(v);
+  }
+  for (Action* act : actions_) {
+    delete act;
+  }
+}
+
+auto Heap::Allocate(Value* v) -> Address {
+  if (!free_slots_.empty()) {
+    Address a = free_slots_.back();
+    free_slots_.pop_back();
+    slots_[a] = v;
+    alive_[a] = true;
+    ++stats_.slots_reused;
+    return a;
+  }
+  Address a = slots_.size();
+  slots_.push_back(v);
+  alive_.push_back(true);
+  return a;
+}
+
+void Heap::Track(Value* v) {
+  ++stats_.values_allocated;
+  if (collecting_) {
+    values_.push_back(v);
+    stats_.peak_values =
+        std::max<uint64_t>(stats_.peak_values, values_.size());
+  }
+}
+
+void Heap::Track(Action* act) {
+  ++stats_.actions_allocated;
+  if (collecting_) {
+    actions_.push_back(act);
+  }
+}
+
+void Heap::MarkAddress(Address a) {
+  // Values computed by an earlier interpreter state can refer to slots
+  // that this heap never had.
+  if (a >= slots_.size() || slot_marks_[a] == epoch_) {
+    return;
+  }
+  slot_marks_[a] = epoch_;
+  if (slots_[a] != nullptr) {
+    MarkValue(slots_[a]);
+  }
+}
+
+void Heap::MarkValue(Value* v) {
+  if (v == nullptr) {
+    return;
+  }
+  if (IsImmediate(v)) {
+    if (KindOf(v) == ValKind::PtrV) {
+      MarkAddress(PtrOf(v));
+    }
+    return;
+  }
+  if (v->mark == epoch_) {
+    return;
+  }
+  v->mark = epoch_;
+  switch (v->tag) {
+    case ValKind::FunV:
+      MarkValue(v->u.fun.param);
+      break;
+    case ValKind::StructV:
+      MarkValue(v->u.struct_val.type);
+      MarkValue(v->u.struct_val.inits);
+      break;
+    case ValKind::AltV:
+      MarkValue(v->u.alt.arg);
+      break;
+    case ValKind::TupleV:
+      for (const auto& elt : *v->u.tuple.elts) {
+        MarkAddress(elt.second);
+      }
+      break;
+    case ValKind::VarPatV:
+      MarkValue(v->u.var_pat.type);
+      break;
+    case ValKind::FunctionTV:
+      MarkValue(v->u.fun_type.param);
+      MarkValue(v->u.fun_type.ret);
+      break;
+    case ValKind::PointerTV:
+      MarkValue(v->u.ptr_type.type);
+      break;
+    case ValKind::StructTV:
+      for (const auto& field : *v->u.struct_type.fields) {
+        MarkValue(field.second);
+      }
+      for (const auto& method : *v->u.struct_type.methods) {
+        MarkValue(method.second);
+      }
+      break;
+    case ValKind::TupleTV:
+      for (const auto& field : *v->u.tuple_type.fields) {
+        MarkValue(field.second);
+      }
+      break;
+    case ValKind::ChoiceTV:
+      for (const auto& alt : *v->u.choice_type.alternatives) {
+        MarkValue(alt.second);
+      }
+      break;
+    case ValKind::IntV:
+    case ValKind::BoolV:
+    case ValKind::PtrV:
+    case ValKind::VarTV:
+    case ValKind::IntTV:
+    case ValKind::BoolTV:
+    case ValKind::TypeTV:
+    case ValKind::AutoTV:
+    case ValKind::AltConsV:
+      break;
+  }
+}
+
+void Heap::MarkAction(Action* act) {
+  act->mark = epoch_;
+  switch (act->tag) {
+    case ActionKind::ValAction:
+      MarkValue(act->u.val);
+      break;
+    case ActionKind::DeleteTmpAction:
+      MarkAddress(act->u.delete_tmp);
+      break;
+    case ActionKind::LValAction:
+    case ActionKind::ExpressionAction:
+    case ActionKind::StatementAction:
+    case ActionKind::ExpToLValAction:
+      break;
+  }
+  for (Value* v : act->results) {
+    MarkValue(v);
+  }
+}
+
+void Heap::Sweep() {
+  for (Address a = 0; a < slots_.size(); ++a) {
+    if (slots_[a] != nullptr && slot_marks_[a] != epoch_) {
+      slots_[a] = nullptr;
+      free_slots_.push_back(a);
+    }
+  }
+  auto first_dead_value =
+      std::stable_partition(values_.begin(), values_.end(),
+                            [this](Value* v) { return v->mark == epoch_; });
+  for (auto i = first_dead_value; i != values_.end(); ++i) {
+    FreeValue(*i);
+  }
+  stats_.values_freed += values_.end() - first_dead_value;
+  values_.erase(first_dead_value, values_.end());
+
+  auto first_dead_action = std::stable_partition(
+      actions_.begin(), actions_.end(),
+      [this](Action* act) { return act->mark == epoch_; });
+  for (auto i = first_dead_action; i != actions_.end(); ++i) {
+    delete *i;
+  }
+  stats_.actions_freed += actions_.end() - first_dead_action;
+  actions_.erase(first_dead_action, actions_.end());
+}
+
+void CollectGarbage(State* state) {
+  Heap& heap = state->heap;
+  ++heap.epoch_;
+  ++heap.stats_.collections;
+  heap.slot_marks_.resize(heap.slots_.size(), heap.epoch_ - 1);
+
+  for (const auto& global : globals) {
+    heap.MarkAddress(global.second);
+  }
+  for (Value* type : state->types.values()) {
+    heap.MarkValue(type);
+  }
+  for (Frame* frame : state->stack) {
+    // This also keeps the slots of variables whose scope has ended, until
+    // the frame is popped or the slot is rebound.
+    for (Address a : frame->slots) {
+      heap.MarkAddress(a);
+    }
+    for (Action* act : frame->todo) {
+      heap.MarkAction(act);
+    }
+  }
+  heap.Sweep();
+
+  size_t live = heap.values_.size() + heap.actions_.size();
+  heap.next_collection_ = std::max<size_t>(1 << 16, 2 * live);
+}
+
+void PrintHeapStats(const Heap& heap, std::ostream& out) {
+  const HeapStats& stats = heap.stats();
+  out << "heap statistics:\n"
+      << "  values allocated: " << stats.values_allocated << "\n"
+      << "  values freed: " << stats.values_freed << "\n"
+      << "  peak values held: " << stats.peak_values << "\n"
+      << "  actions allocated: " << stats.actions_allocated << "\n"
+      << "  actions freed: " << stats.actions_freed << "\n"
+      << "  heap slots: " << heap.size() << "\n"
+      << "  slots reused: " << stats.slots_reused << "\n"
+      << "  collections: " << stats.collections << "\n"
+      << "  pool bytes: " << interpreter_pool.reserved_bytes() << "\n";
+}
+
+}  // namespace Cocktail
@@ -0,0 +1,140 @@
+#ifndef COCKTAIL_EXPERIMENTAL_INTERPRETER_HEAP_H
+#define COCKTAIL_EXPERIMENTAL_INTERPRETER_HEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "experimental/Interpreter/Value.h"
+
+namespace Cocktail {
+
+struct Action;
+struct State;
+
+/***** Pool Allocator *****/
+
+// Hands out small blocks from large chunks, keeping one free list per size
+// class so that freed blocks are recycled for objects of the same size.
+// Requests larger than the biggest size class go to `operator new`.
+class PoolAllocator {
+ public:
+  static constexpr size_t Granularity = 16;
+  static constexpr size_t MaxSize = 256;
+
+  auto Allocate(size_t size) -> void*;
+  void Deallocate(void* p, size_t size);
+
+  // The number of bytes taken from the system for pooled blocks.
+  auto reserved_bytes() const -> size_t { return reserved_bytes_; }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+  static constexpr size_t ChunkSize = 64 * 1024;
+  static constexpr size_t NumClasses = MaxSize / Granularity;
+
+  // Carves a fresh chunk into blocks of size class `c`.
+  void Refill(size_t c);
+
+  FreeBlock* free_lists_[NumClasses] = {};
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  size_t reserved_bytes_ = 0;
+};
+
+// The pool that `Value` and `Action` are allocated from.
+extern PoolAllocator interpreter_pool;
+
+/***** Heap *****/
+
+struct HeapStats {
+  uint64_t values_allocated = 0;
+  uint64_t values_freed = 0;
+  uint64_t actions_allocated = 0;
+  uint64_t actions_freed = 0;
+  // The most values held at once, live or awaiting collection.
+  uint64_t peak_values = 0;
+  uint64_t slots_reused = 0;
+  uint64_t collections = 0;
+};
+
+// The interpreter's memory: the address-indexed slots that variables and
+// tuple elements live in, plus the bookkeeping for the garbage collector.
+//
+// A slot's value is alive from `Allocate` until `Kill`. Killing a value
+// doesn't free its slot, which stays readable so that the interpreter can
+// report a use of the dead value.
+//
+// Once `EnableCollection` is called, every `Value` and `Action` allocated is
+// owned by this heap and is freed by `CollectGarbage` when it can no longer
+// be reached, or when the heap is destroyed. Slots that become unreachable
+// are reused by `AllocateValue`.
+class Heap {
+ public:
+  Heap() = default;
+  Heap(const Heap&) = delete;
+  auto operator=(const Heap&) -> Heap& = delete;
+  ~Heap();
+
+  auto operator[](Address a) -> Value*& { return slots_[a]; }
+  auto operator[](Address a) const -> Value* { return slots_[a]; }
+
+  // Stores `v` in a free slot and returns its address.
+  auto Allocate(Value* v) -> Address;
+
+  auto IsAlive(Address a) const -> bool { return alive_[a]; }
+  void Kill(Address a) { alive_[a] = false; }
+
+  void EnableCollection() { collecting_ = true; }
+  void Track(Value* v);
+  void Track(Action* act);
+
+  // Whether enough has been allocated since the last collection to make
+  // another one worthwhile.
+  auto ShouldCollect() const -> bool {
+    return collecting_ && values_.size() + actions_.size() >= next_collection_;
+  }
+
+  auto stats() const -> const HeapStats& { return stats_; }
+  auto size() const -> size_t { return slots_.size(); }
+
+ private:
+  friend void CollectGarbage(State* state);
+
+  void MarkAddress(Address a);
+  void MarkValue(Value* v);
+  void MarkAction(Action* act);
+  void Sweep();
+
+  std::vector<Value*> slots_;
+  std::vector<bool> alive_;
+  std::vector<Address> free_slots_;
+
+  bool collecting_ = false;
+  std::vector<Value*> values_;
+  std::vector<Action*> actions_;
+  size_t next_collection_ = 1 << 16;
+  // Bumped by every collection, so that an object or slot is marked iff its
+  // mark equals the current epoch and nothing has to be cleared up front.
+  uint32_t epoch_ = 0;
+  std::vector<uint32_t> slot_marks_;
+
+  HeapStats stats_;
+};
+
+// Frees the values, actions and slots of `state->heap` that can't be reached
+// from the frames on `state->stack` or from the global variables. Must only
+// be called between steps, when no value is held by a C++ local.
+void CollectGarbage(State* state);
+
+// Whether `ExecProgram` prints heap statistics when the program exits.
+extern bool report_heap_stats;
+
+void PrintHeapStats(const Heap& heap, std::ostream& out);
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_EXPERIMENTAL_INTERPRETER_HEAP_H
@@ -7,16 +7,23 @@
 #include <utility>
 #include <vector>
 
+#include "experimental/AST/Arena.h"
 #include "experimental/AST/Expression.h"
 #include "experimental/AST/FunctionDefinition.h"
+#include "experimental/Interpreter/Profile.h"
+#include "experimental/Interpreter/Resolve.h"
 #include "experimental/Interpreter/TypeCheck.h"
 
 namespace Cocktail {
 
 State* state = nullptr;
+Tracer* tracer = nullptr;
 
-auto PatternMatch(Value* pat, Value* val, Env*, std::list<std::string>*, int)
-    -> Env*;
+// Whether the step being taken is traced. Set by `Step`.
+static bool tracing_step = false;
+
+auto PatternMatch(Value* pat, Value* val, Frame* frame, Scope* scope,
+                  int line_num) -> bool;
 void HandleValue();
 
 template <class T>
@@ -38,17 +45,24 @@ auto AllocateValue(Value* v) -> Address {
   // ensures that we don't do anything else in between, which is really bad!
   // Consider whether to include a copy of the input v in this function
   // or to leave it up to the caller.
-  Address a = state->heap.size();
-  state->heap.push_back(v);
-  return a;
+  return state->heap.Allocate(v);
+}
+
+void CheckAlive(Address a, int line_num) {
+  if (!state->heap.IsAlive(a)) {
+    std::cerr << line_num << ": undefined behavior: access to dead value ";
+    PrintValue(state->heap[a], std::cerr);
+    std::cerr << std::endl;
+    exit(-1);
+  }
 }
 
 auto CopyVal(Value* val, int line_num) -> Value* {
-  CheckAlive(val, line_num);
-  switch (val->tag) {
+  switch (KindOf(val)) {
     case ValKind::TupleV: {
       auto elts = new std::vector<std::pair<std::string, Address>>();
       for (auto& i : *val->u.tuple.elts) {
+        CheckAlive(i.second, line_num);
         Value* elt = CopyVal(state->heap[i.second], line_num);
         elts->push_back(make_pair(i.first, AllocateValue(elt)));
       }
@@ -56,56 +70,29 @@ auto CopyVal(Value* val, int line_num) -> Value* {
     }
     case ValKind::AltV: {
       Value* arg = CopyVal(val->u.alt.arg, line_num);
-      return MakeAltVal(*val->u.alt.alt_name, *val->u.alt.choice_name, arg);
+      return MakeAltVal(val->u.alt.alt_name, val->u.alt.choice_name, arg);
     }
     case ValKind::StructV: {
       Value* inits = CopyVal(val->u.struct_val.inits, line_num);
       return MakeStructVal(val->u.struct_val.type, inits);
     }
-    case ValKind::IntV:
-      return MakeIntVal(val->u.integer);
-    case ValKind::BoolV:
-      return MakeBoolVal(val->u.boolean);
-    case ValKind::FunV:
-      return MakeFunVal(*val->u.fun.name, val->u.fun.param, val->u.fun.body);
-    case ValKind::PtrV:
-      return MakePtrVal(val->u.ptr);
-    case ValKind::FunctionTV:
-      return MakeFunTypeVal(CopyVal(val->u.fun_type.param, line_num),
-                            CopyVal(val->u.fun_type.ret, line_num));
-
-    case ValKind::PointerTV:
-      return MakePtrTypeVal(CopyVal(val->u.ptr_type.type, line_num));
-    case ValKind::IntTV:
-      return MakeIntTypeVal();
-    case ValKind::BoolTV:
-      return MakeBoolTypeVal();
-    case ValKind::TypeTV:
-      return MakeTypeTypeVal();
-    case ValKind::VarTV:
-      return MakeVarTypeVal(*val->u.var_type);
-    case ValKind::AutoTV:
-      return MakeAutoTypeVal();
-    case ValKind::TupleTV: {
-      auto new_fields = new VarValues();
-      for (auto& field : *val->u.tuple_type.fields) {
-        auto v = CopyVal(field.second, line_num);
-        new_fields->push_back(make_pair(field.first, v));
-      }
-      return MakeTupleTypeVal(new_fields);
-    }
-    case ValKind::StructTV:
-    case ValKind::ChoiceTV:
-    case ValKind::VarPatV:
-    case ValKind::AltConsV:
-      return val;  // no need to copy these because they are immutable?
-      // No, they need to be copied so they don't get killed. -Jeremy
+    default:
+      // Values are immutable and only tuples own slots, so every other
+      // value can be shared, which costs nothing for an immediate.
+      return val;
   }
 }
 
+void KillValue(Value* val);
+
+// Ends the lifetime of the value at `a` and of the values it contains.
+void KillAddress(Address a) {
+  state->heap.Kill(a);
+  KillValue(state->heap[a]);
+}
+
 void KillValue(Value* val) {
-  val->alive = false;
-  switch (val->tag) {
+  switch (KindOf(val)) {
     case ValKind::AltV:
       KillValue(val->u.alt.arg);
       break;
@@ -114,8 +101,8 @@ void KillValue(Value* val) {
       break;
     case ValKind::TupleV:
       for (auto& elt : *val->u.tuple.elts) {
-        if (state->heap[elt.second]->alive) {
-          KillValue(state->heap[elt.second]);
+        if (state->heap.IsAlive(elt.second)) {
+          KillAddress(elt.second);
         } else {
           std::cerr << "runtime error, killing an already dead value"
                     << std::endl;
@@ -128,12 +115,19 @@ void KillValue(Value* val) {
   }
 }
 
-void PrintEnv(Env* env, std::ostream& out) {
-  if (env) {
-    std::cout << env->key << ": ";
-    PrintValue(state->heap[env->value], out);
-    std::cout << ", ";
-    PrintEnv(env->next, out);
+// Prints the variables visible in `frame`, innermost first.
+void PrintEnv(Frame* frame, std::ostream& out) {
+  for (Scope* scope : frame->scopes) {
+    for (auto l = scope->locals.rbegin(); l != scope->locals.rend(); ++l) {
+      out << l->first << ": ";
+      PrintValue(state->heap[frame->slots[l->second]], out);
+      out << ", ";
+    }
+  }
+  for (auto g = globals.rbegin(); g != globals.rend(); ++g) {
+    out << g->first << ": ";
+    PrintValue(state->heap[g->second], out);
+    out << ", ";
   }
 }
 
@@ -146,20 +140,24 @@ void PrintFrame(Frame* frame, std::ostream& out) {
   out << "}";
 }
 
-void PrintStack(Cons<Frame*>* ls, std::ostream& out) {
-  if (ls) {
-    PrintFrame(ls->curr, out);
-    if (ls->next) {
+void PrintStack(const Stack<Frame*>& ls, std::ostream& out) {
+  bool first = true;
+  for (Frame* frame : ls) {
+    if (!first) {
       out << " :: ";
-      PrintStack(ls->next, out);
     }
+    first = false;
+    PrintFrame(frame, out);
   }
 }
 
-void PrintHeap(const std::vector<Value*>& heap, std::ostream& out) {
-  for (auto& iter : heap) {
-    if (iter) {
-      PrintValue(iter, out);
+void PrintHeap(const Heap& heap, std::ostream& out) {
+  for (Address a = 0; a < heap.size(); ++a) {
+    if (heap[a]) {
+      if (!heap.IsAlive(a)) {
+        out << "!!";
+      }
+      PrintValue(heap[a], out);
     } else {
       out << "_";
     }
@@ -167,29 +165,49 @@ void PrintHeap(const std::vector<Value*>& heap, std::ostream& out) {
   }
 }
 
-auto CurrentEnv(State* state) -> Env* {
-  Frame* frame = state->stack->curr;
-  return frame->scopes->curr->env;
+// Returns the address of variable `exp`, which is evaluated in `frame`.
+auto VariableAddress(Frame* frame, Expression* exp) -> Address {
+  int slot = exp->u.variable.slot;
+  if (slot < 0) {
+    std::cerr << exp->line_num << ": could not find `"
+              << *exp->u.variable.name << "`" << std::endl;
+    exit(-1);
+  }
+  return exp->u.variable.depth == 0 ? frame->slots[slot]
+                                    : globals[slot].second;
 }
 
 void PrintState(std::ostream& out) {
-  out << "{" << std::endl;
+  out << "{\n";
   out << "stack: ";
   PrintStack(state->stack, out);
-  out << std::endl << "heap: ";
+  out << "\nheap: ";
   PrintHeap(state->heap, out);
-  out << std::endl << "env: ";
-  PrintEnv(CurrentEnv(state), out);
-  out << std::endl << "}" << std::endl;
+  out << "\nenv: ";
+  PrintEnv(state->stack.Top(), out);
+  out << "\n}\n";
+}
+
+// Whether the current step should print what it does.
+static auto PrintingStep() -> bool { return tracing_step && tracer->prints(); }
+
+static void TraceCall(TraceEventKind kind, int line_num,
+                      const std::string& name) {
+  if (tracer->prints()) {
+    std::cout << "--- "
+              << (kind == TraceEventKind::Call ? "call " : "return from ")
+              << name << "\n";
+  } else {
+    tracer->Record(kind, line_num, state->stack.Count(), 0);
+  }
 }
 
 /***** Auxiliary Functions *****/
 
 auto ValToInt(Value* v, int line_num) -> int {
-  CheckAlive(v, line_num);
-  switch (v->tag) {
+  switch (KindOf(v)) {
     case ValKind::IntV:
-      return v->u.integer;
+      return IntOf(v);
     default:
       std::cerr << line_num << ": runtime error: expected an integer"
                 << std::endl;
@@ -198,23 +216,22 @@ auto ValToInt(Value* v, int line_num) -> int {
 }
 
 auto ValToBool(Value* v, int line_num) -> int {
-  CheckAlive(v, line_num);
-  switch (v->tag) {
+  switch (KindOf(v)) {
     case ValKind::BoolV:
-      return v->u.boolean;
+      return BoolOf(v);
     default:
-      std::cerr << "runtime type error: expected a Boolean" << std::endl;
+      std::cerr << line_num << ": runtime error: expected a Boolean"
+                << std::endl;
       exit(-1);
   }
 }
 
 auto ValToPtr(Value* v, int line_num) -> Address {
-  CheckAlive(v, line_num);
-  switch (v->tag) {
+  switch (KindOf(v)) {
     case ValKind::PtrV:
-      return v->u.ptr;
+      return PtrOf(v);
     default:
-      std::cerr << "runtime type error: expected a pointer, not ";
+      std::cerr << line_num << ": runtime error: expected a pointer, not ";
       PrintValue(v, std::cerr);
       std::cerr << std::endl;
       exit(-1);
@@ -245,10 +262,12 @@ auto EvalPrim(Operator op, const std::vector<Value*>& args, int line_num)
   }
 }
 
-Env* globals;
+std::vector<std::pair<std::string, Address>> globals;
 
+// Defines one global per declaration, in the order that `ResolveProgram`
+// numbers them.
 void InitGlobals(std::list<Declaration*>* fs) {
-  globals = nullptr;
+  globals.clear();
   for (auto& iter : *fs) {
     switch (iter->tag) {
       case DeclarationKind::ChoiceDeclaration: {
@@ -262,7 +281,7 @@ void InitGlobals(std::list<Declaration*>* fs) {
         }
         auto ct = MakeChoiceTypeVal(d->u.choice_def.name, alts);
         auto a = AllocateValue(ct);
-        globals = new Env(*d->u.choice_def.name, a, globals);
+        globals.push_back({*d->u.choice_def.name, a});
         break;
       }
       case DeclarationKind::StructDeclaration: {
@@ -280,18 +299,19 @@ void InitGlobals(std::list<Declaration*>* fs) {
             }
           }
         }
-        auto st = MakeStructTypeVal(*d->u.struct_def->name, fields, methods);
+        auto st = MakeStructTypeVal(d->u.struct_def->name, fields, methods);
         auto a = AllocateValue(st);
-        globals = new Env(*d->u.struct_def->name, a, globals);
+        globals.push_back({*d->u.struct_def->name, a});
         break;
       }
       case DeclarationKind::FunctionDeclaration: {
         struct FunctionDefinition* fun = iter->u.fun_def;
-        Env* env = nullptr;
-        auto pt = InterpExp(env, fun->param_pattern);
-        auto f = MakeFunVal(fun->name, pt, fun->body);
+        // This numbers the parameters from the first slot of an empty
+        // frame, just like `ResolveProgram`.
+        auto pt = InterpExp(nullptr, fun->param_pattern);
+        auto f = MakeFunVal(InternName(fun->name), pt, fun->body);
         Address a = AllocateValue(f);
-        globals = new Env(fun->name, a, globals);
+        globals.push_back({fun->name, a});
         break;
       }
     }
@@ -303,38 +323,42 @@ void InitGlobals(std::list<Declaration*>* fs) {
 //       E is the environment (functions + parameters + locals)
 //       F is the function
 void CallFunction(int line_num, std::vector<Value*> operas, State* state) {
-  CheckAlive(operas[0], line_num);
-  switch (operas[0]->tag) {
+  switch (KindOf(operas[0])) {
     case ValKind::FunV: {
-      // Bind arguments to parameters
-      std::list<std::string> params;
-      Env* env = PatternMatch(operas[0]->u.fun.param, operas[1], globals,
-                              &params, line_num);
-      if (!env) {
+      // Create the new frame and bind arguments to parameters
+      auto* scope = new Scope();
+      auto* frame = new Frame(*operas[0]->u.fun.name, scope,
+                              MakeStmtAct(operas[0]->u.fun.body));
+      if (!PatternMatch(operas[0]->u.fun.param, operas[1], frame, scope,
+                        line_num)) {
         std::cerr << "internal error in call_function, pattern match failed"
                   << std::endl;
         exit(-1);
       }
-      // Create the new frame and push it on the stack
-      auto* scope = new Scope(env, params);
-      auto* frame = new Frame(*operas[0]->u.fun.name, MakeCons(scope),
-                              MakeCons(MakeStmtAct(operas[0]->u.fun.body)));
-      state->stack = MakeCons(frame, state->stack);
+      // Push the new frame on the stack
+      state->stack.Push(frame);
+      if (tracer && tracer->traces_calls()) {
+        TraceCall(TraceEventKind::Call, line_num, frame->name);
+      }
+      if (profiler) {
+        profiler->Call(operas[0]->u.fun.name,
+                       state->heap.stats().values_allocated);
+      }
       break;
     }
     case ValKind::StructTV: {
       Value* arg = CopyVal(operas[1], line_num);
       Value* sv = MakeStructVal(operas[0], arg);
-      Frame* frame = state->stack->curr;
-      frame->todo = MakeCons(MakeValAct(sv), frame->todo);
+      Frame* frame = state->stack.Top();
+      frame->todo.Push(MakeValAct(sv));
       break;
     }
     case ValKind::AltConsV: {
       Value* arg = CopyVal(operas[1], line_num);
-      Value* av = MakeAltVal(*operas[0]->u.alt_cons.alt_name,
-                             *operas[0]->u.alt_cons.choice_name, arg);
-      Frame* frame = state->stack->curr;
-      frame->todo = MakeCons(MakeValAct(av), frame->todo);
+      Value* av = MakeAltVal(operas[0]->u.alt_cons.alt_name,
+                             operas[0]->u.alt_cons.choice_name, arg);
+      Frame* frame = state->stack.Top();
+      frame->todo.Push(MakeValAct(av));
       break;
     }
     default:
@@ -345,17 +369,15 @@ void CallFunction(int line_num, std::vector<Value*> operas, State* state) {
   }
 }
 
-void KillScope(int line_num, Scope* scope) {
+void KillScope(Frame* frame, Scope* scope) {
   for (const auto& l : scope->locals) {
-    Address a = Lookup(line_num, scope->env, l, PrintErrorString);
-    KillValue(state->heap[a]);
+    KillAddress(frame->slots[l.second]);
   }
 }
 
-void KillLocals(int line_num, Frame* frame) {
-  Cons<Scope*>* scopes = frame->scopes;
-  for (Scope* scope = scopes->curr; scopes; scopes = scopes->next) {
-    KillScope(line_num, scope);
+void KillLocals(Frame* frame) {
+  for (Scope* scope : frame->scopes) {
+    KillScope(frame, scope);
   }
 }
 
@@ -369,7 +391,8 @@ void CreateTuple(Frame* frame, Action* act, Expression* /*exp*/) {
     elts->push_back(make_pair(f->first, a));
   }
   Value* tv = MakeTupleVal(elts);
-  frame->todo = MakeCons(MakeValAct(tv), frame->todo->next);
+  frame->todo.Pop();
+  frame->todo.Push(MakeValAct(tv));
 }
 
 auto ToValue(Expression* value) -> Value* {
@@ -394,22 +417,30 @@ auto ToValue(Expression* value) -> Value* {
   }
 }
 
-// Returns 0 if the value doesn't match the pattern.
-auto PatternMatch(Value* p, Value* v, Env* env, std::list<std::string>* vars,
-                  int line_num) -> Env* {
-  std::cout << "pattern_match(";
-  PrintValue(p, std::cout);
-  std::cout << ", ";
-  PrintValue(v, std::cout);
-  std::cout << ")" << std::endl;
-  switch (p->tag) {
+// Binds the variables of pattern `p` in `frame`, recording them in `scope`.
+// Returns false if the value doesn't match the pattern.
+auto PatternMatch(Value* p, Value* v, Frame* frame, Scope* scope,
+                  int line_num) -> bool {
+  if (PrintingStep()) {
+    std::cout << "pattern_match(";
+    PrintValue(p, std::cout);
+    std::cout << ", ";
+    PrintValue(v, std::cout);
+    std::cout << ")\n";
+  }
+  switch (KindOf(p)) {
     case ValKind::VarPatV: {
       Address a = AllocateValue(CopyVal(v, line_num));
-      vars->push_back(*p->u.var_pat.name);
-      return new Env(*p->u.var_pat.name, a, env);
+      int slot = p->u.var_pat.slot;
+      if (slot >= static_cast<int>(frame->slots.size())) {
+        frame->slots.resize(slot + 1);
+      }
+      frame->slots[slot] = a;
+      scope->locals.push_back({*p->u.var_pat.name, slot});
+      return true;
     }
     case ValKind::TupleV:
-      switch (v->tag) {
+      switch (KindOf(v)) {
         case ValKind::TupleV: {
           if (p->u.tuple.elts->size() != v->u.tuple.elts->size()) {
             std::cerr << "runtime error: arity mismatch in tuple pattern match"
@@ -424,10 +455,12 @@ auto PatternMatch(Value* p, Value* v, Env* env, std::list<std::string>* vars,
               std::cerr << std::endl;
               exit(-1);
             }
-            env = PatternMatch(state->heap[elt.second], state->heap[*a], env,
-                               vars, line_num);
+            if (!PatternMatch(state->heap[elt.second], state->heap[*a], frame,
+                              scope, line_num)) {
+              return false;
+            }
           }
-          return env;
+          return true;
         }
         default:
           std::cerr
@@ -437,14 +470,14 @@ auto PatternMatch(Value* p, Value* v, Env* env, std::list<std::string>* vars,
           exit(-1);
       }
     case ValKind::AltV:
-      switch (v->tag) {
+      switch (KindOf(v)) {
         case ValKind::AltV: {
-          if (*p->u.alt.choice_name != *v->u.alt.choice_name ||
-              *p->u.alt.alt_name != *v->u.alt.alt_name) {
-            return nullptr;
+          if (p->u.alt.choice_name != v->u.alt.choice_name ||
+              p->u.alt.alt_name != v->u.alt.alt_name) {
+            return false;
           }
-          env = PatternMatch(p->u.alt.arg, v->u.alt.arg, env, vars, line_num);
-          return env;
+          return PatternMatch(p->u.alt.arg, v->u.alt.arg, frame, scope,
+                              line_num);
         }
         default:
           std::cerr
@@ -455,32 +488,27 @@ auto PatternMatch(Value* p, Value* v, Env* env, std::list<std::string>* vars,
           exit(-1);
       }
     case ValKind::FunctionTV:
-      switch (v->tag) {
+      switch (KindOf(v)) {
         case ValKind::FunctionTV:
-          env = PatternMatch(p->u.fun_type.param, v->u.fun_type.param, env,
-                             vars, line_num);
-          env = PatternMatch(p->u.fun_type.ret, v->u.fun_type.ret, env, vars,
-                             line_num);
-          return env;
+          return PatternMatch(p->u.fun_type.param, v->u.fun_type.param, frame,
+                              scope, line_num) &&
+                 PatternMatch(p->u.fun_type.ret, v->u.fun_type.ret, frame,
+                              scope, line_num);
         default:
-          return nullptr;
+          return false;
       }
     default:
-      if (ValueEqual(p, v, line_num)) {
-        return env;
-      } else {
-        return nullptr;
-      }
+      return ValueEqual(p, v, line_num);
   }
 }
 
 void PatternAssignment(Value* pat, Value* val, int line_num) {
-  switch (pat->tag) {
+  switch (KindOf(pat)) {
     case ValKind::PtrV:
       state->heap[ValToPtr(pat, line_num)] = val;
       break;
     case ValKind::TupleV: {
-      switch (val->tag) {
+      switch (KindOf(val)) {
         case ValKind::TupleV: {
           if (pat->u.tuple.elts->size() != val->u.tuple.elts->size()) {
             std::cerr << "runtime error: arity mismatch in tuple pattern match"
@@ -511,10 +539,10 @@ void PatternAssignment(Value* pat, Value* val, int line_num) {
       break;
     }
     case ValKind::AltV: {
-      switch (val->tag) {
+      switch (KindOf(val)) {
         case ValKind::AltV: {
-          if (*pat->u.alt.choice_name != *val->u.alt.choice_name ||
-              *pat->u.alt.alt_name != *val->u.alt.alt_name) {
+          if (pat->u.alt.choice_name != val->u.alt.choice_name ||
+              pat->u.alt.alt_name != val->u.alt.alt_name) {
             std::cerr << "internal error in pattern assignment" << std::endl;
             exit(-1);
           }
@@ -542,35 +570,35 @@ void PatternAssignment(Value* pat, Value* val, int line_num) {
 /***** state transitions for lvalues *****/
 
 void StepLvalue() {
-  Frame* frame = state->stack->curr;
-  Action* act = frame->todo->curr;
+  Frame* frame = state->stack.Top();
+  Action* act = frame->todo.Top();
   Expression* exp = act->u.exp;
-  std::cout << "--- step lvalue ";
-  PrintExp(exp);
-  std::cout << " --->" << std::endl;
+  if (PrintingStep()) {
+    std::cout << "--- step lvalue ";
+    PrintExp(exp);
+    std::cout << " --->\n";
+  }
   switch (exp->tag) {
     case ExpressionKind::Variable: {
       //    { {x :: C, E, F} :: S, H}
       // -> { {E(x) :: C, E, F} :: S, H}
-      Address a = Lookup(exp->line_num, CurrentEnv(state),
-                         *(exp->u.variable.name), PrintErrorString);
+      Address a = VariableAddress(frame, exp);
       Value* v = MakePtrVal(a);
-      CheckAlive(v, exp->line_num);
-      frame->todo = MakeCons(MakeValAct(v), frame->todo->next);
+      frame->todo.Pop();
+      frame->todo.Push(MakeValAct(v));
       break;
     }
     case ExpressionKind::GetField: {
       //    { {e.f :: C, E, F} :: S, H}
       // -> { e :: [].f :: C, E, F} :: S, H}
-      frame->todo =
-          MakeCons(MakeLvalAct(exp->u.get_field.aggregate), frame->todo);
+      frame->todo.Push(MakeLvalAct(exp->u.get_field.aggregate));
       act->pos++;
       break;
     }
     case ExpressionKind::Index: {
       //    { {e[i] :: C, E, F} :: S, H}
       // -> { e :: [][i] :: C, E, F} :: S, H}
-      frame->todo = MakeCons(MakeExpAct(exp->u.index.aggregate), frame->todo);
+      frame->todo.Push(MakeExpAct(exp->u.index.aggregate));
       act->pos++;
       break;
     }
@@ -578,7 +606,7 @@ void StepLvalue() {
       //    { {(f1=e1,...) :: C, E, F} :: S, H}
       // -> { {e1 :: (f1=[],...) :: C, E, F} :: S, H}
       Expression* e1 = (*exp->u.tuple.fields)[0].second;
-      frame->todo = MakeCons(MakeLvalAct(e1), frame->todo);
+      frame->todo.Push(MakeLvalAct(e1));
       act->pos++;
       break;
     }
@@ -592,8 +620,9 @@ void StepLvalue() {
     case ExpressionKind::FunctionT:
     case ExpressionKind::AutoT:
     case ExpressionKind::PatternVariable: {
-      frame->todo = MakeCons(MakeExpAct(exp),
-                             MakeCons(MakeExpToLvalAct(), frame->todo->next));
+      frame->todo.Pop();
+      frame->todo.Push(MakeExpToLvalAct());
+      frame->todo.Push(MakeExpAct(exp));
     }
   }
 }
@@ -601,23 +630,24 @@ void StepLvalue() {
 /***** state transitions for expressions *****/
 
 void StepExp() {
-  Frame* frame = state->stack->curr;
-  Action* act = frame->todo->curr;
+  Frame* frame = state->stack.Top();
+  Action* act = frame->todo.Top();
   Expression* exp = act->u.exp;
-  std::cout << "--- step exp ";
-  PrintExp(exp);
-  std::cout << " --->" << std::endl;
+  if (PrintingStep()) {
+    std::cout << "--- step exp ";
+    PrintExp(exp);
+    std::cout << " --->\n";
+  }
   switch (exp->tag) {
     case ExpressionKind::PatternVariable: {
-      frame->todo =
-          MakeCons(MakeExpAct(exp->u.pattern_variable.type), frame->todo);
+      frame->todo.Push(MakeExpAct(exp->u.pattern_variable.type));
       act->pos++;
       break;
     }
     case ExpressionKind::Index: {
       //    { { e[i] :: C, E, F} :: S, H}
       // -> { { e :: [][i] :: C, E, F} :: S, H}
-      frame->todo = MakeCons(MakeExpAct(exp->u.index.aggregate), frame->todo);
+      frame->todo.Push(MakeExpAct(exp->u.index.aggregate));
       act->pos++;
       break;
     }
@@ -626,7 +656,7 @@ void StepExp() {
         //    { {(f1=e1,...) :: C, E, F} :: S, H}
         // -> { {e1 :: (f1=[],...) :: C, E, F} :: S, H}
         Expression* e1 = (*exp->u.tuple.fields)[0].second;
-        frame->todo = MakeCons(MakeExpAct(e1), frame->todo);
+        frame->todo.Push(MakeExpAct(e1));
         act->pos++;
       } else {
         CreateTuple(frame, act, exp);
@@ -636,73 +666,76 @@ void StepExp() {
     case ExpressionKind::GetField: {
       //    { { e.f :: C, E, F} :: S, H}
       // -> { { e :: [].f :: C, E, F} :: S, H}
-      frame->todo =
-          MakeCons(MakeLvalAct(exp->u.get_field.aggregate), frame->todo);
+      frame->todo.Push(MakeLvalAct(exp->u.get_field.aggregate));
       act->pos++;
       break;
     }
     case ExpressionKind::Variable: {
       // { {x :: C, E, F} :: S, H} -> { {H(E(x)) :: C, E, F} :: S, H}
-      Address a = Lookup(exp->line_num, CurrentEnv(state),
-                         *(exp->u.variable.name), PrintErrorString);
+      Address a = VariableAddress(frame, exp);
+      CheckAlive(a, exp->line_num);
       Value* v = state->heap[a];
-      frame->todo = MakeCons(MakeValAct(v), frame->todo->next);
+      frame->todo.Pop();
+      frame->todo.Push(MakeValAct(v));
       break;
     }
     case ExpressionKind::Integer:
       // { {n :: C, E, F} :: S, H} -> { {n' :: C, E, F} :: S, H}
-      frame->todo =
-          MakeCons(MakeValAct(MakeIntVal(exp->u.integer)), frame->todo->next);
+      frame->todo.Pop();
+      frame->todo.Push(MakeValAct(MakeIntVal(exp->u.integer)));
       break;
     case ExpressionKind::Boolean:
       // { {n :: C, E, F} :: S, H} -> { {n' :: C, E, F} :: S, H}
-      frame->todo =
-          MakeCons(MakeValAct(MakeBoolVal(exp->u.boolean)), frame->todo->next);
+      frame->todo.Pop();
+      frame->todo.Push(MakeValAct(MakeBoolVal(exp->u.boolean)));
       break;
     case ExpressionKind::PrimitiveOp:
       if (exp->u.primitive_op.arguments->size() > 0) {
         //    { {op(e :: es) :: C, E, F} :: S, H}
         // -> { e :: op([] :: es) :: C, E, F} :: S, H}
-        frame->todo = MakeCons(
-            MakeExpAct(exp->u.primitive_op.arguments->front()), frame->todo);
+        frame->todo.Push(MakeExpAct(exp->u.primitive_op.arguments->front()));
         act->pos++;
       } else {
         //    { {v :: op(]) :: C, E, F} :: S, H}
         // -> { {eval_prim(op, ()) :: C, E, F} :: S, H}
         Value* v =
             EvalPrim(exp->u.primitive_op.op, act->results, exp->line_num);
-        frame->todo = MakeCons(MakeValAct(v), frame->todo->next->next);
+        frame->todo.Pop(2);
+        frame->todo.Push(MakeValAct(v));
       }
       break;
     case ExpressionKind::Call:
       //    { {e1(e2) :: C, E, F} :: S, H}
       // -> { {e1 :: [](e2) :: C, E, F} :: S, H}
-      frame->todo = MakeCons(MakeExpAct(exp->u.call.function), frame->todo);
+      frame->todo.Push(MakeExpAct(exp->u.call.function));
       act->pos++;
       break;
     case ExpressionKind::IntT: {
       Value* v = MakeIntTypeVal();
-      frame->todo = MakeCons(MakeValAct(v), frame->todo->next);
+      frame->todo.Pop();
+      frame->todo.Push(MakeValAct(v));
       break;
     }
     case ExpressionKind::BoolT: {
       Value* v = MakeBoolTypeVal();
-      frame->todo = MakeCons(MakeValAct(v), frame->todo->next);
+      frame->todo.Pop();
+      frame->todo.Push(MakeValAct(v));
       break;
     }
     case ExpressionKind::AutoT: {
       Value* v = MakeAutoTypeVal();
-      frame->todo = MakeCons(MakeValAct(v), frame->todo->next);
+      frame->todo.Pop();
+      frame->todo.Push(MakeValAct(v));
       break;
     }
     case ExpressionKind::TypeT: {
       Value* v = MakeTypeTypeVal();
-      frame->todo = MakeCons(MakeValAct(v), frame->todo->next);
+      frame->todo.Pop();
+      frame->todo.Push(MakeValAct(v));
       break;
     }
     case ExpressionKind::FunctionT: {
-      frame->todo =
-          MakeCons(MakeExpAct(exp->u.function_type.parameter), frame->todo);
+      frame->todo.Push(MakeExpAct(exp->u.function_type.parameter));
       act->pos++;
       break;
     }
@@ -740,109 +773,114 @@ auto IsBlockAct(Action* act) -> bool {
 }
 
 void StepStmt() {
-  Frame* frame = state->stack->curr;
-  Action* act = frame->todo->curr;
+  Frame* frame = state->stack.Top();
+  Action* act = frame->todo.Top();
   Statement* stmt = act->u.stmt;
-  std::cout << "--- step stmt ";
-  PrintStatement(stmt, 1);
-  std::cout << " --->" << std::endl;
+  if (PrintingStep()) {
+    std::cout << "--- step stmt ";
+    PrintStatement(stmt, 1);
+    std::cout << " --->\n";
+  }
   switch (stmt->tag) {
     case StatementKind::Match:
       //    { { (match (e) ...) :: C, E, F} :: S, H}
       // -> { { e :: (match ([]) ...) :: C, E, F} :: S, H}
-      frame->todo = MakeCons(MakeExpAct(stmt->u.match_stmt.exp), frame->todo);
+      frame->todo.Push(MakeExpAct(stmt->u.match_stmt.exp));
       act->pos++;
       break;
     case StatementKind::While:
       //    { { (while (e) s) :: C, E, F} :: S, H}
       // -> { { e :: (while ([]) s) :: C, E, F} :: S, H}
-      frame->todo = MakeCons(MakeExpAct(stmt->u.while_stmt.cond), frame->todo);
+      frame->todo.Push(MakeExpAct(stmt->u.while_stmt.cond));
       act->pos++;
       break;
     case StatementKind::Break:
       //    { { break; :: ... :: (while (e) s) :: C, E, F} :: S, H}
       // -> { { C, E', F} :: S, H}
-      frame->todo = frame->todo->next;
-      while (frame->todo && !IsWhileAct(frame->todo->curr)) {
-        if (IsBlockAct(frame->todo->curr)) {
-          KillScope(stmt->line_num, frame->scopes->curr);
-          frame->scopes = frame->scopes->next;
+      frame->todo.Pop();
+      while (!frame->todo.IsEmpty() && !IsWhileAct(frame->todo.Top())) {
+        if (IsBlockAct(frame->todo.Top())) {
+          Scope* scope = frame->scopes.Pop();
+          KillScope(frame, scope);
+          delete scope;
         }
-        frame->todo = frame->todo->next;
+        frame->todo.Pop();
       }
-      frame->todo = frame->todo->next;
+      frame->todo.Pop();
       break;
     case StatementKind::Continue:
       //    { { continue; :: ... :: (while (e) s) :: C, E, F} :: S, H}
       // -> { { (while (e) s) :: C, E', F} :: S, H}
-      frame->todo = frame->todo->next;
-      while (frame->todo && !IsWhileAct(frame->todo->curr)) {
-        if (IsBlockAct(frame->todo->curr)) {
-          KillScope(stmt->line_num, frame->scopes->curr);
-          frame->scopes = frame->scopes->next;
+      frame->todo.Pop();
+      while (!frame->todo.IsEmpty() && !IsWhileAct(frame->todo.Top())) {
+        if (IsBlockAct(frame->todo.Top())) {
+          Scope* scope = frame->scopes.Pop();
+          KillScope(frame, scope);
+          delete scope;
         }
-        frame->todo = frame->todo->next;
+        frame->todo.Pop();
       }
       break;
     case StatementKind::Block: {
       if (act->pos == -1) {
-        auto* scope = new Scope(CurrentEnv(state), std::list<std::string>());
-        frame->scopes = MakeCons(scope, frame->scopes);
-        frame->todo = MakeCons(MakeStmtAct(stmt->u.block.stmt), frame->todo);
+        frame->scopes.Push(new Scope());
+        // An empty block has no statement to run.
+        if (stmt->u.block.stmt) {
+          frame->todo.Push(MakeStmtAct(stmt->u.block.stmt));
+        }
         act->pos++;
       } else {
-        Scope* scope = frame->scopes->curr;
-        KillScope(stmt->line_num, scope);
-        frame->scopes = frame->scopes->next;
-        frame->todo = frame->todo->next;
+        Scope* scope = frame->scopes.Pop();
+        KillScope(frame, scope);
+        delete scope;
+        frame->todo.Pop();
       }
       break;
     }
     case StatementKind::VariableDefinition:
       //    { {(var x = e) :: C, E, F} :: S, H}
       // -> { {e :: (var x = []) :: C, E, F} :: S, H}
-      frame->todo =
-          MakeCons(MakeExpAct(stmt->u.variable_definition.init), frame->todo);
+      frame->todo.Push(MakeExpAct(stmt->u.variable_definition.init));
       act->pos++;
       break;
     case StatementKind::ExpressionStatement:
       //    { {e :: C, E, F} :: S, H}
       // -> { {e :: C, E, F} :: S, H}
-      frame->todo = MakeCons(MakeExpAct(stmt->u.exp), frame->todo);
+      frame->todo.Push(MakeExpAct(stmt->u.exp));
       break;
     case StatementKind::Assign:
       //    { {(lv = e) :: C, E, F} :: S, H}
       // -> { {lv :: ([] = e) :: C, E, F} :: S, H}
-      frame->todo = MakeCons(MakeLvalAct(stmt->u.assign.lhs), frame->todo);
+      frame->todo.Push(MakeLvalAct(stmt->u.assign.lhs));
       act->pos++;
       break;
     case StatementKind::If:
       //    { {(if (e) then_stmt else else_stmt) :: C, E, F} :: S, H}
       // -> { { e :: (if ([]) then_stmt else else_stmt) :: C, E, F} :: S, H}
-      frame->todo = MakeCons(MakeExpAct(stmt->u.if_stmt.cond), frame->todo);
+      frame->todo.Push(MakeExpAct(stmt->u.if_stmt.cond));
       act->pos++;
       break;
     case StatementKind::Return:
       //    { {return e :: C, E, F} :: S, H}
       // -> { {e :: return [] :: C, E, F} :: S, H}
-      frame->todo = MakeCons(MakeExpAct(stmt->u.return_stmt), frame->todo);
+      frame->todo.Push(MakeExpAct(stmt->u.return_stmt));
       act->pos++;
       break;
     case StatementKind::Sequence:
       //    { { (s1,s2) :: C, E, F} :: S, H}
       // -> { { s1 :: s2 :: C, E, F} :: S, H}
-      Cons<Action*>* todo = frame->todo->next;
+      frame->todo.Pop();
       if (stmt->u.sequence.next) {
-        todo = MakeCons(MakeStmtAct(stmt->u.sequence.next), todo);
+        frame->todo.Push(MakeStmtAct(stmt->u.sequence.next));
       }
-      frame->todo = MakeCons(MakeStmtAct(stmt->u.sequence.stmt), todo);
+      frame->todo.Push(MakeStmtAct(stmt->u.sequence.stmt));
       break;
   }
 }
 
 auto GetMember(Address a, const std::string& f) -> Address {
   Value* v = state->heap[a];
-  switch (v->tag) {
+  switch (KindOf(v)) {
     case ValKind::StructV: {
       auto a = FindField(f, *v->u.struct_val.inits->u.tuple.elts);
       if (a == std::nullopt) {
@@ -870,7 +908,7 @@ auto GetMember(Address a, const std::string& f) -> Address {
         std::cerr << std::endl;
         exit(-1);
       }
-      auto ac = MakeAltCons(f, *v->u.choice_type.name);
+      auto ac = MakeAltCons(InternName(f), v->u.choice_type.name);
       return AllocateValue(ac);
     }
     default:
@@ -881,53 +919,58 @@ auto GetMember(Address a, const std::string& f) -> Address {
   }
 }
 
-auto InsertDelete(Action* del, Cons<Action*>* todo) -> Cons<Action*>* {
-  if (todo) {
-    switch (todo->curr->tag) {
-      case ActionKind::StatementAction: {
+void InsertDelete(Action* del, Stack<Action*>& todo) {
+  int depth = 0;
+  while (depth < todo.Count()) {
+    switch (todo.Top(depth)->tag) {
+      case ActionKind::StatementAction:
         // This places the delete before the enclosing statement.
         // Not sure if that is OK. Conceptually it should go after
         // but that is tricky for some statements, like 'return'. -Jeremy
-        return MakeCons(del, todo);
-      }
+        todo.Insert(depth, del);
+        return;
       case ActionKind::LValAction:
       case ActionKind::ExpressionAction:
       case ActionKind::ValAction:
       case ActionKind::ExpToLValAction:
       case ActionKind::DeleteTmpAction:
-        return MakeCons(todo->curr, InsertDelete(del, todo->next));
+        ++depth;
+        break;
     }
-  } else {
-    return MakeCons(del, todo);
   }
+  todo.Insert(depth, del);
 }
 
 /***** State transition for handling a value *****/
 
 void HandleValue() {
-  Frame* frame = state->stack->curr;
-  Action* val_act = frame->todo->curr;
-  Action* act = frame->todo->next->curr;
+  Frame* frame = state->stack.Top();
+  Action* val_act = frame->todo.Top();
+  Action* act = frame->todo.Top(1);
   act->results.push_back(val_act->u.val);
   act->pos++;
 
-  std::cout << "--- handle value ";
-  PrintValue(val_act->u.val, std::cout);
-  std::cout << " with ";
-  PrintAct(act, std::cout);
-  std::cout << " --->" << std::endl;
+  if (PrintingStep()) {
+    std::cout << "--- handle value ";
+    PrintValue(val_act->u.val, std::cout);
+    std::cout << " with ";
+    PrintAct(act, std::cout);
+    std::cout << " --->\n";
+  }
 
   switch (act->tag) {
     case ActionKind::DeleteTmpAction: {
-      KillValue(state->heap[act->u.delete_tmp]);
-      frame->todo = MakeCons(val_act, frame->todo->next->next);
+      KillAddress(act->u.delete_tmp);
+      frame->todo.Pop(2);
+      frame->todo.Push(val_act);
       break;
     }
     case ActionKind::ExpToLValAction: {
       Address a = AllocateValue(act->results[0]);
       auto del = MakeDeleteAct(a);
-      frame->todo = MakeCons(MakeValAct(MakePtrVal(a)),
-                             InsertDelete(del, frame->todo->next->next));
+      frame->todo.Pop(2);
+      InsertDelete(del, frame->todo);
+      frame->todo.Push(MakeValAct(MakePtrVal(a)));
       break;
     }
     case ActionKind::LValAction: {
@@ -939,14 +982,14 @@ void HandleValue() {
           Value* str = act->results[0];
           Address a =
               GetMember(ValToPtr(str, exp->line_num), *exp->u.get_field.field);
-          frame->todo =
-              MakeCons(MakeValAct(MakePtrVal(a)), frame->todo->next->next);
+          frame->todo.Pop(2);
+          frame->todo.Push(MakeValAct(MakePtrVal(a)));
           break;
         }
         case ExpressionKind::Index: {
           if (act->pos == 1) {
-            frame->todo =
-                MakeCons(MakeExpAct(exp->u.index.offset), frame->todo->next);
+            frame->todo.Pop();
+            frame->todo.Push(MakeExpAct(exp->u.index.offset));
           } else if (act->pos == 2) {
             //    { v :: [][i] :: C, E, F} :: S, H}
             // -> { { &v[i] :: C, E, F} :: S, H }
@@ -959,8 +1002,8 @@ void HandleValue() {
               std::cerr << std::endl;
               exit(-1);
             }
-            frame->todo =
-                MakeCons(MakeValAct(MakePtrVal(*a)), frame->todo->next->next);
+            frame->todo.Pop(2);
+            frame->todo.Push(MakeValAct(MakePtrVal(*a)));
           }
           break;
         }
@@ -971,9 +1014,10 @@ void HandleValue() {
             // -> { { ek+1 :: (f1=v1,..., fk=vk, fk+1=[],...) :: C, E, F} :: S,
             // H}
             Expression* elt = (*exp->u.tuple.fields)[act->pos].second;
-            frame->todo = MakeCons(MakeLvalAct(elt), frame->todo->next);
+            frame->todo.Pop();
+            frame->todo.Push(MakeLvalAct(elt));
           } else {
-            frame->todo = frame->todo->next;
+            frame->todo.Pop();
             CreateTuple(frame, act, exp);
           }
           break;
@@ -989,9 +1033,10 @@ void HandleValue() {
       Expression* exp = act->u.exp;
       switch (exp->tag) {
         case ExpressionKind::PatternVariable: {
-          auto v =
-              MakeVarPatVal(*exp->u.pattern_variable.name, act->results[0]);
-          frame->todo = MakeCons(MakeValAct(v), frame->todo->next->next);
+          auto v = MakeVarPatVal(exp->u.pattern_variable.name,
+                                 act->results[0], exp->u.pattern_variable.slot);
+          frame->todo.Pop(2);
+          frame->todo.Push(MakeValAct(v));
           break;
         }
         case ExpressionKind::Tuple: {
@@ -1001,20 +1046,21 @@ void HandleValue() {
             // -> { { ek+1 :: (f1=v1,..., fk=vk, fk+1=[],...) :: C, E, F} :: S,
             // H}
             Expression* elt = (*exp->u.tuple.fields)[act->pos].second;
-            frame->todo = MakeCons(MakeExpAct(elt), frame->todo->next);
+            frame->todo.Pop();
+            frame->todo.Push(MakeExpAct(elt));
           } else {
-            frame->todo = frame->todo->next;
+            frame->todo.Pop();
             CreateTuple(frame, act, exp);
           }
           break;
         }
         case ExpressionKind::Index: {
           if (act->pos == 1) {
-            frame->todo =
-                MakeCons(MakeExpAct(exp->u.index.offset), frame->todo->next);
+            frame->todo.Pop();
+            frame->todo.Push(MakeExpAct(exp->u.index.offset));
           } else if (act->pos == 2) {
             auto tuple = act->results[0];
-            switch (tuple->tag) {
+            switch (KindOf(tuple)) {
               case ValKind::TupleV: {
                 //    { { v :: [][i] :: C, E, F} :: S, H}
                 // -> { { v_i :: C, E, F} : S, H}
@@ -1026,8 +1072,9 @@ void HandleValue() {
                   std::cerr << std::endl;
                   exit(-1);
                 }
-                frame->todo = MakeCons(MakeValAct(state->heap[*a]),
-                                       frame->todo->next->next);
+                CheckAlive(*a, exp->line_num);
+                frame->todo.Pop(2);
+                frame->todo.Push(MakeValAct(state->heap[*a]));
                 break;
               }
               default:
@@ -1045,8 +1092,9 @@ void HandleValue() {
           // -> { { v_f :: C, E, F} : S, H}
           auto a = GetMember(ValToPtr(act->results[0], exp->line_num),
                              *exp->u.get_field.field);
-          frame->todo =
-              MakeCons(MakeValAct(state->heap[a]), frame->todo->next->next);
+          CheckAlive(a, exp->line_num);
+          frame->todo.Pop(2);
+          frame->todo.Push(MakeValAct(state->heap[a]));
           break;
         }
         case ExpressionKind::PrimitiveOp: {
@@ -1055,13 +1103,15 @@ void HandleValue() {
             //    { {v :: op(vs,[],e,es) :: C, E, F} :: S, H}
             // -> { {e :: op(vs,v,[],es) :: C, E, F} :: S, H}
             Expression* arg = (*exp->u.primitive_op.arguments)[act->pos];
-            frame->todo = MakeCons(MakeExpAct(arg), frame->todo->next);
+            frame->todo.Pop();
+            frame->todo.Push(MakeExpAct(arg));
           } else {
             //    { {v :: op(vs,[]) :: C, E, F} :: S, H}
             // -> { {eval_prim(op, (vs,v)) :: C, E, F} :: S, H}
             Value* v =
                 EvalPrim(exp->u.primitive_op.op, act->results, exp->line_num);
-            frame->todo = MakeCons(MakeValAct(v), frame->todo->next->next);
+            frame->todo.Pop(2);
+            frame->todo.Push(MakeValAct(v));
           }
           break;
         }
@@ -1069,12 +1119,12 @@ void HandleValue() {
           if (act->pos == 1) {
             //    { { v :: [](e) :: C, E, F} :: S, H}
             // -> { { e :: v([]) :: C, E, F} :: S, H}
-            frame->todo =
-                MakeCons(MakeExpAct(exp->u.call.argument), frame->todo->next);
+            frame->todo.Pop();
+            frame->todo.Push(MakeExpAct(exp->u.call.argument));
           } else if (act->pos == 2) {
             //    { { v2 :: v1([]) :: C, E, F} :: S, H}
             // -> { {C',E',F'} :: {C, E, F} :: S, H}
-            frame->todo = frame->todo->next->next;
+            frame->todo.Pop(2);
             CallFunction(exp->line_num, act->results, state);
           } else {
             std::cerr << "internal error in handle_value with Call"
@@ -1088,12 +1138,13 @@ void HandleValue() {
             //    { { rt :: fn pt -> [] :: C, E, F} :: S, H}
             // -> { fn pt -> rt :: {C, E, F} :: S, H}
             Value* v = MakeFunTypeVal(act->results[0], act->results[1]);
-            frame->todo = MakeCons(MakeValAct(v), frame->todo->next->next);
+            frame->todo.Pop(2);
+            frame->todo.Push(MakeValAct(v));
           } else {
             //    { { pt :: fn [] -> e :: C, E, F} :: S, H}
             // -> { { e :: fn pt -> []) :: C, E, F} :: S, H}
-            frame->todo = MakeCons(MakeExpAct(exp->u.function_type.return_type),
-                                   frame->todo->next);
+            frame->todo.Pop();
+            frame->todo.Push(MakeExpAct(exp->u.function_type.return_type));
           }
           break;
         }
@@ -1114,29 +1165,27 @@ void HandleValue() {
       Statement* stmt = act->u.stmt;
       switch (stmt->tag) {
         case StatementKind::ExpressionStatement:
-          frame->todo = frame->todo->next->next;
+          frame->todo.Pop(2);
           break;
         case StatementKind::VariableDefinition: {
           if (act->pos == 1) {
-            frame->todo = MakeCons(MakeExpAct(stmt->u.variable_definition.pat),
-                                   frame->todo->next);
+            frame->todo.Pop();
+            frame->todo.Push(MakeExpAct(stmt->u.variable_definition.pat));
           } else if (act->pos == 2) {
             //    { { v :: (x = []) :: C, E, F} :: S, H}
             // -> { { C, E(x := a), F} :: S, H(a := copy(v))}
             Value* v = act->results[0];
             Value* p = act->results[1];
             // Address a = AllocateValue(CopyVal(v));
-            frame->scopes->curr->env =
-                PatternMatch(p, v, frame->scopes->curr->env,
-                             &frame->scopes->curr->locals, stmt->line_num);
-            if (!frame->scopes->curr->env) {
+            if (!PatternMatch(p, v, frame, frame->scopes.Top(),
+                              stmt->line_num)) {
               std::cerr
                   << stmt->line_num
                   << ": internal error in variable definition, match failed"
                   << std::endl;
               exit(-1);
             }
-            frame->todo = frame->todo->next->next;
+            frame->todo.Pop(2);
           }
           break;
         }
@@ -1144,15 +1193,15 @@ void HandleValue() {
           if (act->pos == 1) {
             //    { { a :: ([] = e) :: C, E, F} :: S, H}
             // -> { { e :: (a = []) :: C, E, F} :: S, H}
-            frame->todo =
-                MakeCons(MakeExpAct(stmt->u.assign.rhs), frame->todo->next);
+            frame->todo.Pop();
+            frame->todo.Push(MakeExpAct(stmt->u.assign.rhs));
           } else if (act->pos == 2) {
             //    { { v :: (a = []) :: C, E, F} :: S, H}
             // -> { { C, E, F} :: S, H(a := v)}
             auto pat = act->results[0];
             auto val = act->results[1];
             PatternAssignment(pat, val, stmt->line_num);
-            frame->todo = frame->todo->next->next;
+            frame->todo.Pop(2);
           }
           break;
         case StatementKind::If:
@@ -1160,30 +1209,32 @@ void HandleValue() {
             //    { {true :: if ([]) then_stmt else else_stmt :: C, E, F} ::
             //      S, H}
             // -> { { then_stmt :: C, E, F } :: S, H}
-            frame->todo = MakeCons(MakeStmtAct(stmt->u.if_stmt.then_stmt),
-                                   frame->todo->next->next);
+            frame->todo.Pop(2);
+            frame->todo.Push(MakeStmtAct(stmt->u.if_stmt.then_stmt));
           } else {
             //    { {false :: if ([]) then_stmt else else_stmt :: C, E, F} ::
             //      S, H}
             // -> { { else_stmt :: C, E, F } :: S, H}
-            frame->todo = MakeCons(MakeStmtAct(stmt->u.if_stmt.else_stmt),
-                                   frame->todo->next->next);
+            frame->todo.Pop(2);
+            if (stmt->u.if_stmt.else_stmt) {
+              frame->todo.Push(MakeStmtAct(stmt->u.if_stmt.else_stmt));
+            }
           }
           break;
         case StatementKind::While:
           if (ValToBool(act->results[0], stmt->line_num)) {
             //    { {true :: (while ([]) s) :: C, E, F} :: S, H}
             // -> { { s :: (while (e) s) :: C, E, F } :: S, H}
-            frame->todo->next->curr->pos = -1;
-            frame->todo->next->curr->results.clear();
-            frame->todo = MakeCons(MakeStmtAct(stmt->u.while_stmt.body),
-                                   frame->todo->next);
+            frame->todo.Top(1)->pos = -1;
+            frame->todo.Top(1)->results.clear();
+            frame->todo.Pop();
+            frame->todo.Push(MakeStmtAct(stmt->u.while_stmt.body));
           } else {
             //    { {false :: (while ([]) s) :: C, E, F} :: S, H}
             // -> { { C, E, F } :: S, H}
-            frame->todo->next->curr->pos = -1;
-            frame->todo->next->curr->results.clear();
-            frame->todo = frame->todo->next->next;
+            frame->todo.Top(1)->pos = -1;
+            frame->todo.Top(1)->results.clear();
+            frame->todo.Pop(2);
           }
           break;
         case StatementKind::Match: {
@@ -1199,7 +1250,7 @@ void HandleValue() {
           auto clause_num = (act->pos - 1) / 2;
           if (clause_num >=
               static_cast<int>(stmt->u.match_stmt.clauses->size())) {
-            frame->todo = frame->todo->next->next;
+            frame->todo.Pop(2);
             break;
           }
           auto c = stmt->u.match_stmt.clauses->begin();
@@ -1209,23 +1260,23 @@ void HandleValue() {
             // start interpreting the pattern of the clause
             //    { {v :: (match ([]) ...) :: C, E, F} :: S, H}
             // -> { {pi :: (match ([]) ...) :: C, E, F} :: S, H}
-            frame->todo = MakeCons(MakeExpAct(c->first), frame->todo->next);
+            frame->todo.Pop();
+            frame->todo.Push(MakeExpAct(c->first));
           } else {  // try to match
             auto v = act->results[0];
             auto pat = act->results[clause_num + 1];
-            auto env = CurrentEnv(state);
-            std::list<std::string> vars;
-            Env* new_env = PatternMatch(pat, v, env, &vars, stmt->line_num);
-            if (new_env) {  // we have a match, start the body
-              auto* new_scope = new Scope(new_env, vars);
-              frame->scopes = MakeCons(new_scope, frame->scopes);
+            auto* new_scope = new Scope();
+            if (PatternMatch(pat, v, frame, new_scope, stmt->line_num)) {
+              // we have a match, start the body
+              frame->scopes.Push(new_scope);
               Statement* body_block = MakeBlock(stmt->line_num, c->second);
               Action* body_act = MakeStmtAct(body_block);
               body_act->pos = 0;
-              frame->todo =
-                  MakeCons(MakeStmtAct(c->second),
-                           MakeCons(body_act, frame->todo->next->next));
+              frame->todo.Pop(2);
+              frame->todo.Push(body_act);
+              frame->todo.Push(MakeStmtAct(c->second));
             } else {
+              delete new_scope;
               act->pos++;
               clause_num = (act->pos - 1) / 2;
               if (clause_num <
@@ -1233,9 +1284,10 @@ void HandleValue() {
                 // move on to the next clause
                 c = stmt->u.match_stmt.clauses->begin();
                 std::advance(c, clause_num);
-                frame->todo = MakeCons(MakeExpAct(c->first), frame->todo->next);
+                frame->todo.Pop();
+                frame->todo.Push(MakeExpAct(c->first));
               } else {  // No more clauses in match
-                frame->todo = frame->todo->next->next;
+                frame->todo.Pop(2);
               }
             }
           }
@@ -1245,10 +1297,20 @@ void HandleValue() {
           //    { {v :: return [] :: C, E, F} :: {C', E', F'} :: S, H}
           // -> { {v :: C', E', F'} :: S, H}
           Value* ret_val = CopyVal(val_act->u.val, stmt->line_num);
-          KillLocals(stmt->line_num, frame);
-          state->stack = state->stack->next;
-          frame = state->stack->curr;
-          frame->todo = MakeCons(MakeValAct(ret_val), frame->todo);
+          KillLocals(frame);
+          if (tracer && tracer->traces_calls()) {
+            TraceCall(TraceEventKind::Return, stmt->line_num, frame->name);
+          }
+          if (profiler) {
+            profiler->Return(state->heap.stats().values_allocated);
+          }
+          state->stack.Pop();
+          for (Scope* scope : frame->scopes) {
+            delete scope;
+          }
+          delete frame;
+          frame = state->stack.Top();
+          frame->todo.Push(MakeValAct(ret_val));
           break;
         }
         case StatementKind::Block:
@@ -1268,16 +1330,46 @@ void HandleValue() {
   }  // switch act
 }
 
+static auto ActionLineNum(Action* act) -> int {
+  switch (act->tag) {
+    case ActionKind::LValAction:
+    case ActionKind::ExpressionAction:
+      return act->u.exp->line_num;
+    case ActionKind::StatementAction:
+      return act->u.stmt->line_num;
+    case ActionKind::ValAction:
+    case ActionKind::ExpToLValAction:
+    case ActionKind::DeleteTmpAction:
+      return 0;
+  }
+  std::cerr << "internal error: unknown action kind "
+            << static_cast<int>(act->tag) << std::endl;
+  exit(-1);
+}
+
 // State transition.
 void Step() {
-  Frame* frame = state->stack->curr;
-  if (!frame->todo) {
+  Frame* frame = state->stack.Top();
+  if (frame->todo.IsEmpty()) {
     std::cerr << "runtime error: fell off end of function " << frame->name
               << " without `return`" << std::endl;
     exit(-1);
   }
 
-  Action* act = frame->todo->curr;
+  Action* act = frame->todo.Top();
+  tracing_step = tracer && tracer->StartStep();
+  if (tracing_step && !tracer->prints()) {
+    tracer->Record(TraceEventKind::Step, ActionLineNum(act),
+                   state->stack.Count(), static_cast<uint8_t>(act->tag));
+  }
+  if (profiler) {
+    // A value is handed to the action below it, so that is the action whose
+    // line the step belongs to.
+    Action* owner = act->tag == ActionKind::ValAction && frame->todo.Count() > 1
+                        ? frame->todo.Top(1)
+                        : act;
+    profiler->Step(ActionLineNum(owner), state->heap.stats().values_allocated);
+  }
   switch (act->tag) {
     case ActionKind::DeleteTmpAction:
       std::cerr << "internal error in step, did not expect DeleteTmpAction"
@@ -1304,42 +1396,77 @@ void Step() {
 
 // Interpret the whole porogram.
 auto InterpProgram(std::list<Declaration*>* fs) -> int {
+  // Nothing refers to the previous state any more, and deleting it frees
+  // whatever its heap still owns.
+  delete state;
   state = new State();  // Runtime state.
-  std::cout << "********** initializing globals **********" << std::endl;
+  state->heap.EnableCollection();
+  delete tracer;
+  tracer = new Tracer(trace_options);
+  bool print_banners = tracer->traces_calls() && tracer->prints();
+  if (print_banners) {
+    std::cout << "********** initializing globals **********" << std::endl;
+  }
+  ResolveProgram(fs);
   InitGlobals(fs);
 
   Expression* arg =
-      MakeTuple(0, new std::vector<std::pair<std::string, Expression*>>());
-  Expression* call_main = MakeCall(0, MakeVar(0, "main"), arg);
-  Cons<Action*>* todo = MakeCons(MakeExpAct(call_main));
-  auto* scope = new Scope(globals, std::list<std::string>());
-  auto* frame = new Frame("top", MakeCons(scope), todo);
-  state->stack = MakeCons(frame);
+      MakeTuple(0, ast_arena.New<FieldList>());
+  Expression* main_var = MakeVar(0, "main");
+  // Like any other name, `main` refers to the last global of that name.
+  for (int slot = globals.size() - 1; slot >= 0; --slot) {
+    if (globals[slot].first == "main") {
+      main_var->u.variable.depth = 1;
+      main_var->u.variable.slot = slot;
+      break;
+    }
+  }
+  Expression* call_main = MakeCall(0, main_var, arg);
+  auto* frame = new Frame("top", new Scope(), MakeExpAct(call_main));
+  state->stack = Stack<Frame*>(frame);
 
-  std::cout << "********** calling main function **********" << std::endl;
-  PrintState(std::cout);
+  if (print_banners) {
+    std::cout << "********** calling main function **********" << std::endl;
+  }
+  bool print_state = tracer->traces_state() && tracer->prints();
+  if (print_state) {
+    PrintState(std::cout);
+  }
+  delete profiler;
+  profiler = profile_options.enabled
+                 ? new Profiler(InternName(frame->name),
+                                state->heap.stats().values_allocated)
+                 : nullptr;
 
-  while (Length(state->stack) > 1 || Length(state->stack->curr->todo) > 1 ||
-         state->stack->curr->todo->curr->tag != ActionKind::ValAction) {
+  while (state->stack.Count() > 1 || state->stack.Top()->todo.Count() > 1 ||
+         state->stack.Top()->todo.Top()->tag != ActionKind::ValAction) {
     Step();
-    PrintState(std::cout);
+    if (print_state && tracing_step) {
+      PrintState(std::cout);
+    }
+    if (state->heap.ShouldCollect()) {
+      CollectGarbage(state);
+    }
+  }
+  tracer->Flush();
+  if (profiler) {
+    profiler->Finish(state->heap.stats().values_allocated);
   }
-  Value* v = state->stack->curr->todo->curr->u.val;
+  Value* v = state->stack.Top()->todo.Top()->u.val;
   return ValToInt(v, 0);
 }
 
 // Interpret an expression at compile-time.
 auto InterpExp(Env* env, Expression* e) -> Value* {
-  Cons<Action*>* todo = MakeCons(MakeExpAct(e));
-  auto* scope = new Scope(env, std::list<std::string>());
-  auto* frame = new Frame("InterpExp", MakeCons(scope), todo);
-  state->stack = MakeCons(frame);
+  auto* frame = new Frame("InterpExp", new Scope(), MakeExpAct(e));
+  frame->slots = ResolveExp(e, env);
+  state->stack = Stack<Frame*>(frame);
 
-  while (Length(state->stack) > 1 || Length(state->stack->curr->todo) > 1 ||
-         state->stack->curr->todo->curr->tag != ActionKind::ValAction) {
+  while (state->stack.Count() > 1 || state->stack.Top()->todo.Count() > 1 ||
+         state->stack.Top()->todo.Top()->tag != ActionKind::ValAction) {
     Step();
   }
-  Value* v = state->stack->curr->todo->curr->u.val;
+  Value* v = state->stack.Top()->todo.Top()->u.val;
   return v;
 }
 
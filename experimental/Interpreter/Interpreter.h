@@ -8,40 +8,50 @@
 #include "experimental/AST/Declaration.h"
 #include "experimental/Interpreter/Action.h"
 #include "experimental/Interpreter/AssocList.h"
-#include "experimental/Interpreter/ConsList.h"
+#include "experimental/Interpreter/Heap.h"
+#include "experimental/Interpreter/Stack.h"
+#include "experimental/Interpreter/Trace.h"
+#include "experimental/Interpreter/TypeTable.h"
 #include "experimental/Interpreter/Value.h"
 
 namespace Cocktail {
 
-using Env = AssocList<std::string, Address>;
-
 /***** Scopes *****/
 
 struct Scope {
-  Scope(Env* e, std::list<std::string> l) : env(e), locals(std::move(l)) {}
-  Env* env;
-  std::list<std::string> locals;
+  // The frame slots bound in this scope, with the names they were bound to.
+  std::vector<std::pair<std::string, int>> locals;
 };
 
 /***** Frames and State *****/
 
 struct Frame {
   std::string name;
-  Cons<Scope*>* scopes;
-  Cons<Action*>* todo;
-
-  Frame(std::string n, Cons<Scope*>* s, Cons<Action*>* c)
-      : name(std::move(std::move(n))), scopes(s), todo(c) {}
+  Stack<Scope*> scopes;
+  Stack<Action*> todo;
+  // The addresses of the frame's variables, indexed by the slots that
+  // `ResolveProgram` gave them.
+  std::vector<Address> slots;
+
+  Frame(std::string n, Scope* s, Action* c)
+      : name(std::move(n)), scopes(s), todo(c) {}
 };
 
 struct State {
-  Cons<Frame*>* stack;
-  std::vector<Value*> heap;
+  Stack<Frame*> stack;
+  Heap heap;
+  // The types of the program being type checked.
+  TypeTable types;
 };
 
 extern State* state;
+// The global variables and their addresses, indexed by the slots that
+// `ResolveProgram` gave them.
+extern std::vector<std::pair<std::string, Address>> globals;
+// Traces the current or most recent `InterpProgram` run, which is traced as
+// configured by `trace_options`.
+extern Tracer* tracer;
 
-void PrintEnv(Env* env);
 auto AllocateValue(Value* v) -> Address;
 auto CopyVal(Value* val, int line_num) -> Value*;
 auto ToInteger(Value* v) -> int;
@@ -0,0 +1,199 @@
+#include "experimental/Interpreter/Profile.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <unordered_map>
+#include <utility>
+
+namespace Cocktail {
+
+ProfileOptions profile_options;
+Profiler* profiler = nullptr;
+
+Profiler::Profiler(Name root, uint64_t allocated)
+    : lines_(1), allocated_(allocated), since_(Clock::now()) {
+  nodes_.push_back({root, -1, {}});
+  nodes_[0].calls = 1;
+}
+
+void Profiler::ChargeTime() {
+  Clock::time_point now = Clock::now();
+  nodes_[current_].time += now - since_;
+  since_ = now;
+}
+
+void Profiler::Call(Name name, uint64_t allocated) {
+  Charge(allocated);
+  ChargeTime();
+  int child = -1;
+  for (int c : nodes_[current_].children) {
+    if (nodes_[c].name == name) {
+      child = c;
+      break;
+    }
+  }
+  if (child < 0) {
+    child = nodes_.size();
+    nodes_[current_].children.push_back(child);
+    nodes_.push_back({name, current_, {}});
+  }
+  ++nodes_[child].calls;
+  current_ = child;
+}
+
+void Profiler::Return(uint64_t allocated) {
+  Charge(allocated);
+  ChargeTime();
+  current_ = nodes_[current_].parent;
+}
+
+void Profiler::Finish(uint64_t allocated) {
+  Charge(allocated);
+  ChargeTime();
+}
+
+namespace {
+
+struct FunctionCounts {
+  Name name;
+  uint64_t calls = 0;
+  uint64_t self_steps = 0;
+  uint64_t total_steps = 0;
+  uint64_t allocations = 0;
+  double self_ms = 0;
+  double total_ms = 0;
+};
+
+auto Milliseconds(std::chrono::steady_clock::duration d) -> double {
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+auto Percent(uint64_t part, uint64_t whole) -> double {
+  return whole == 0 ? 0 : 100.0 * part / whole;
+}
+
+}  // namespace
+
+void Profiler::PrintFlat(std::ostream& out) const {
+  // Children are always created after their parents, so walking the nodes
+  // backwards sums each subtree before it reaches the subtree's root.
+  std::vector<uint64_t> subtree_steps(nodes_.size());
+  std::vector<Clock::duration> subtree_time(nodes_.size());
+  for (int i = nodes_.size() - 1; i >= 0; --i) {
+    subtree_steps[i] += nodes_[i].steps;
+    subtree_time[i] += nodes_[i].time;
+    if (nodes_[i].parent >= 0) {
+      subtree_steps[nodes_[i].parent] += subtree_steps[i];
+      subtree_time[nodes_[i].parent] += subtree_time[i];
+    }
+  }
+
+  std::unordered_map<Name, int> index;
+  std::vector<FunctionCounts> functions;
+  // How many calls to each function are on the path being walked. Only the
+  // outermost call of a recursive function counts towards its total, so
+  // that recursion doesn't count the same steps twice.
+  std::vector<int> active;
+  std::vector<std::pair<int, size_t>> walk = {{0, 0}};
+  auto enter = [&](int n) {
+    auto [it, inserted] = index.insert({nodes_[n].name, functions.size()});
+    if (inserted) {
+      functions.push_back({nodes_[n].name});
+      active.push_back(0);
+    }
+    FunctionCounts& f = functions[it->second];
+    f.calls += nodes_[n].calls;
+    f.self_steps += nodes_[n].steps;
+    f.allocations += nodes_[n].allocations;
+    f.self_ms += Milliseconds(nodes_[n].time);
+    if (active[it->second]++ == 0) {
+      f.total_steps += subtree_steps[n];
+      f.total_ms += Milliseconds(subtree_time[n]);
+    }
+  };
+  enter(0);
+  while (!walk.empty()) {
+    auto& [n, next_child] = walk.back();
+    if (next_child < nodes_[n].children.size()) {
+      int child = nodes_[n].children[next_child++];
+      enter(child);
+      walk.push_back({child, 0});
+    } else {
+      --active[index[nodes_[n].name]];
+      walk.pop_back();
+    }
+  }
+
+  std::sort(functions.begin(), functions.end(),
+            [](const FunctionCounts& a, const FunctionCounts& b) {
+              return a.self_steps > b.self_steps;
+            });
+  uint64_t steps = subtree_steps[0];
+  out << "flat profile (" << steps << " steps):\n"
+      << "   self steps      %  total steps     calls  allocations"
+      << "   self ms  total ms  function\n";
+  out << std::fixed;
+  for (const FunctionCounts& f : functions) {
+    out << std::setw(13) << f.self_steps << std::setw(7)
+        << std::setprecision(2) << Percent(f.self_steps, steps)
+        << std::setw(13) << f.total_steps << std::setw(10) << f.calls
+        << std::setw(13) << f.allocations << std::setprecision(3)
+        << std::setw(10) << f.self_ms << std::setw(10) << f.total_ms << "  "
+        << *f.name << "\n";
+  }
+
+  constexpr size_t HotLines = 10;
+  std::vector<int> hot;
+  for (size_t line = 0; line < lines_.size(); ++line) {
+    if (lines_[line].steps > 0 || lines_[line].allocations > 0) {
+      hot.push_back(line);
+    }
+  }
+  std::sort(hot.begin(), hot.end(), [&](int a, int b) {
+    return lines_[a].steps > lines_[b].steps ||
+           (lines_[a].steps == lines_[b].steps && a < b);
+  });
+  hot.resize(std::min(hot.size(), HotLines));
+  out << "hottest lines:\n"
+      << "        steps      %  allocations  line\n";
+  for (int line : hot) {
+    out << std::setw(13) << lines_[line].steps << std::setw(7)
+        << std::setprecision(2) << Percent(lines_[line].steps, steps)
+        << std::setw(13) << lines_[line].allocations << "  " << line << "\n";
+  }
+  out << std::defaultfloat;
+}
+
+void Profiler::WriteCollapsed(std::ostream& out) const {
+  // Walks the call tree depth first, keeping the path to the current node in
+  // `path`. Each entry of `walk` is a node, the next of its children to
+  // visit, and the length of `path` before the node was added to it.
+  struct Visit {
+    int node;
+    size_t next_child;
+    size_t path_length;
+  };
+  std::string path = *nodes_[0].name;
+  std::vector<Visit> walk = {{0, 0, 0}};
+  if (nodes_[0].steps > 0) {
+    out << path << " " << nodes_[0].steps << "\n";
+  }
+  while (!walk.empty()) {
+    Visit& visit = walk.back();
+    const Node& node = nodes_[visit.node];
+    if (visit.next_child < node.children.size()) {
+      int child = node.children[visit.next_child++];
+      walk.push_back({child, 0, path.size()});
+      path += ";";
+      path += *nodes_[child].name;
+      if (nodes_[child].steps > 0) {
+        out << path << " " << nodes_[child].steps << "\n";
+      }
+    } else {
+      path.resize(visit.path_length);
+      walk.pop_back();
+    }
+  }
+}
+
+}  // namespace Cocktail
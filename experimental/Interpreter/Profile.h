@@ -0,0 +1,102 @@
+#ifndef COCKTAIL_EXPERIMENTAL_INTERPRETER_PROFILE_H
+#define COCKTAIL_EXPERIMENTAL_INTERPRETER_PROFILE_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "experimental/AST/Name.h"
+
+namespace Cocktail {
+
+struct ProfileOptions {
+  bool enabled = false;
+  // Where `ExecProgram` writes the collapsed stacks. When empty, they go
+  // next to the input, in `<input>.folded`.
+  std::string collapsed_file;
+};
+
+// The options used by `InterpProgram`.
+extern ProfileOptions profile_options;
+
+// Counts the steps, value allocations and wall time spent in each call path
+// of a program, and the steps and allocations spent on each source line.
+//
+// The per-step work is a few increments; the clock is only read when a
+// function is called or returns.
+class Profiler {
+ public:
+  // Starts profiling in the frame named `root`. `allocated` is the heap's
+  // count of values allocated so far, as it is for the other methods.
+  Profiler(Name root, uint64_t allocated);
+
+  // Counts a step at `line_num` against the running function. Whatever the
+  // previous step allocated is charged to that step.
+  void Step(int line_num, uint64_t allocated) {
+    Charge(allocated);
+    ++nodes_[current_].steps;
+    if (static_cast<size_t>(line_num) >= lines_.size()) {
+      lines_.resize(line_num + 1);
+    }
+    ++lines_[line_num].steps;
+    line_ = line_num;
+  }
+
+  // Records that the running function called `name`, or returned.
+  void Call(Name name, uint64_t allocated);
+  void Return(uint64_t allocated);
+
+  // Charges the last step and the time since the last call or return.
+  void Finish(uint64_t allocated);
+
+  // Prints one line per function, hottest first, then the hottest lines.
+  void PrintFlat(std::ostream& out) const;
+  // Writes one line per call path in the collapsed format read by
+  // flamegraph tools, weighted by steps.
+  void WriteCollapsed(std::ostream& out) const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  // A node of the call tree: a function, reached by one particular path.
+  struct Node {
+    Name name;
+    int parent;
+    std::vector<int> children;
+    uint64_t calls = 0;
+    uint64_t steps = 0;
+    uint64_t allocations = 0;
+    Clock::duration time = Clock::duration::zero();
+  };
+
+  struct LineCounts {
+    uint64_t steps = 0;
+    uint64_t allocations = 0;
+  };
+
+  void Charge(uint64_t allocated) {
+    uint64_t n = allocated - allocated_;
+    allocated_ = allocated;
+    nodes_[current_].allocations += n;
+    lines_[line_].allocations += n;
+  }
+  // Charges the time since the last call or return to the running function.
+  void ChargeTime();
+
+  std::vector<Node> nodes_;
+  int current_ = 0;
+  std::vector<LineCounts> lines_;
+  int line_ = 0;
+  uint64_t allocated_ = 0;
+  Clock::time_point since_;
+};
+
+// Profiles the current or most recent `InterpProgram` run, or is null if
+// `profile_options` didn't ask for that.
+extern Profiler* profiler;
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_EXPERIMENTAL_INTERPRETER_PROFILE_H
@@ -0,0 +1,209 @@
+#include "experimental/Interpreter/Resolve.h"
+
+#include <map>
+#include <string>
+
+namespace Cocktail {
+
+namespace {
+
+class Resolver {
+ public:
+  // Variables that aren't found in any scope are looked up in `globals`,
+  // if given, and are otherwise left unresolved.
+  explicit Resolver(const std::map<std::string, int>* globals)
+      : globals_(globals) {}
+
+  // Starts the outermost scope with the variables in `env`, which take the
+  // first slots, and returns their addresses by slot.
+  auto Import(Env* env) -> std::vector<Address>;
+
+  void ResolveFunction(FunctionDefinition* f);
+  void ResolveExp(Expression* e);
+  void ResolveStmt(Statement* s);
+
+ private:
+  auto Declare(const std::string& name) -> int;
+
+  const std::map<std::string, int>* globals_;
+  // The scopes that are open, innermost last.
+  std::vector<std::map<std::string, int>> scopes_;
+  int num_slots_ = 0;
+};
+
+auto Resolver::Import(Env* env) -> std::vector<Address> {
+  std::vector<Address> slots;
+  scopes_.emplace_back();
+  for (; env != nullptr; env = env->next) {
+    // An inner binding shadows the outer ones.
+    if (scopes_.back().emplace(env->key, slots.size()).second) {
+      slots.push_back(env->value);
+    }
+  }
+  num_slots_ = slots.size();
+  return slots;
+}
+
+auto Resolver::Declare(const std::string& name) -> int {
+  scopes_.back()[name] = num_slots_;
+  return num_slots_++;
+}
+
+void Resolver::ResolveFunction(FunctionDefinition* f) {
+  num_slots_ = 0;
+  scopes_.emplace_back();
+  ResolveExp(f->param_pattern);
+  ResolveStmt(f->body);
+  scopes_.pop_back();
+}
+
+void Resolver::ResolveExp(Expression* e) {
+  switch (e->tag) {
+    case ExpressionKind::Variable: {
+      const std::string& name = *e->u.variable.name;
+      for (auto scope = scopes_.rbegin(); scope != scopes_.rend(); ++scope) {
+        auto slot = scope->find(name);
+        if (slot != scope->end()) {
+          e->u.variable.depth = 0;
+          e->u.variable.slot = slot->second;
+          return;
+        }
+      }
+      e->u.variable.depth = 0;
+      e->u.variable.slot = -1;
+      if (globals_ != nullptr) {
+        auto global = globals_->find(name);
+        if (global != globals_->end()) {
+          e->u.variable.depth = 1;
+          e->u.variable.slot = global->second;
+        }
+      }
+      break;
+    }
+    case ExpressionKind::PatternVariable:
+      ResolveExp(e->u.pattern_variable.type);
+      e->u.pattern_variable.slot = Declare(*e->u.pattern_variable.name);
+      break;
+    case ExpressionKind::GetField:
+      ResolveExp(e->u.get_field.aggregate);
+      break;
+    case ExpressionKind::Index:
+      ResolveExp(e->u.index.aggregate);
+      ResolveExp(e->u.index.offset);
+      break;
+    case ExpressionKind::Tuple:
+      for (auto& field : *e->u.tuple.fields) {
+        ResolveExp(field.second);
+      }
+      break;
+    case ExpressionKind::PrimitiveOp:
+      for (Expression* arg : *e->u.primitive_op.arguments) {
+        ResolveExp(arg);
+      }
+      break;
+    case ExpressionKind::Call:
+      ResolveExp(e->u.call.function);
+      ResolveExp(e->u.call.argument);
+      break;
+    case ExpressionKind::FunctionT:
+      ResolveExp(e->u.function_type.parameter);
+      ResolveExp(e->u.function_type.return_type);
+      break;
+    case ExpressionKind::AutoT:
+    case ExpressionKind::BoolT:
+    case ExpressionKind::Boolean:
+    case ExpressionKind::IntT:
+    case ExpressionKind::Integer:
+    case ExpressionKind::TypeT:
+      break;
+  }
+}
+
+void Resolver::ResolveStmt(Statement* s) {
+  if (s == nullptr) {
+    return;
+  }
+  switch (s->tag) {
+    case StatementKind::ExpressionStatement:
+      ResolveExp(s->u.exp);
+      break;
+    case StatementKind::Assign:
+      ResolveExp(s->u.assign.lhs);
+      ResolveExp(s->u.assign.rhs);
+      break;
+    case StatementKind::VariableDefinition:
+      // The initializer can't see the variables being defined.
+      ResolveExp(s->u.variable_definition.init);
+      ResolveExp(s->u.variable_definition.pat);
+      break;
+    case StatementKind::If:
+      ResolveExp(s->u.if_stmt.cond);
+      ResolveStmt(s->u.if_stmt.then_stmt);
+      ResolveStmt(s->u.if_stmt.else_stmt);
+      break;
+    case StatementKind::Return:
+      ResolveExp(s->u.return_stmt);
+      break;
+    case StatementKind::Sequence:
+      ResolveStmt(s->u.sequence.stmt);
+      ResolveStmt(s->u.sequence.next);
+      break;
+    case StatementKind::Block:
+      scopes_.emplace_back();
+      ResolveStmt(s->u.block.stmt);
+      scopes_.pop_back();
+      break;
+    case StatementKind::While:
+      ResolveExp(s->u.while_stmt.cond);
+      ResolveStmt(s->u.while_stmt.body);
+      break;
+    case StatementKind::Break:
+    case StatementKind::Continue:
+      break;
+    case StatementKind::Match:
+      ResolveExp(s->u.match_stmt.exp);
+      for (auto& clause : *s->u.match_stmt.clauses) {
+        scopes_.emplace_back();
+        ResolveExp(clause.first);
+        ResolveStmt(clause.second);
+        scopes_.pop_back();
+      }
+      break;
+  }
+}
+
+}  // namespace
+
+void ResolveProgram(std::list<Declaration*>* fs) {
+  std::map<std::string, int> globals;
+  int slot = 0;
+  for (Declaration* d : *fs) {
+    switch (d->tag) {
+      case DeclarationKind::FunctionDeclaration:
+        globals[d->u.fun_def->name] = slot;
+        break;
+      case DeclarationKind::StructDeclaration:
+        globals[*d->u.struct_def->name] = slot;
+        break;
+      case DeclarationKind::ChoiceDeclaration:
+        globals[*d->u.choice_def.name] = slot;
+        break;
+    }
+    ++slot;
+  }
+  Resolver resolver(&globals);
+  for (Declaration* d : *fs) {
+    if (d->tag == DeclarationKind::FunctionDeclaration) {
+      resolver.ResolveFunction(d->u.fun_def);
+    }
+  }
+}
+
+auto ResolveExp(Expression* e, Env* env) -> std::vector<Address> {
+  Resolver resolver(nullptr);
+  std::vector<Address> slots = resolver.Import(env);
+  resolver.ResolveExp(e);
+  return slots;
+}
+
+}  // namespace Cocktail
@@ -0,0 +1,28 @@
+#ifndef COCKTAIL_EXPERIMENTAL_INTERPRETER_RESOLVE_H
+#define COCKTAIL_EXPERIMENTAL_INTERPRETER_RESOLVE_H
+
+#include <list>
+#include <vector>
+
+#include "experimental/AST/Declaration.h"
+#include "experimental/Interpreter/Interpreter.h"
+
+namespace Cocktail {
+
+// Resolves each variable in the functions of the type-checked program `fs`
+// to a (depth, slot) pair, so that the interpreter finds a variable by
+// indexing into its frame or the globals instead of by name.
+//
+// The parameters of a function take the first slots of its frame, in the
+// order they appear in its parameter pattern, and every other variable that
+// the function defines gets a slot of its own. The `i`th global is the one
+// defined by the `i`th declaration of `fs`.
+void ResolveProgram(std::list<Declaration*>* fs);
+
+// Resolves the variables in `e`, which is about to be evaluated in `env`,
+// and returns the slots of the frame that it should be evaluated in.
+auto ResolveExp(Expression* e, Env* env) -> std::vector<Address>;
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_EXPERIMENTAL_INTERPRETER_RESOLVE_H
@@ -0,0 +1,70 @@
+#ifndef COCKTAIL_EXPERIMENTAL_INTERPRETER_STACK_H
+#define COCKTAIL_EXPERIMENTAL_INTERPRETER_STACK_H
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Cocktail {
+
+// A LIFO stack backed by a contiguous, growable buffer. Push and pop are
+// amortized O(1), the size is tracked rather than recomputed, and the buffer
+// is reused once it has grown, so a deep recursion allocates only on its way
+// down to a new maximum depth.
+//
+// Elements are addressed by their depth, where depth 0 is the top. Iteration
+// also runs from the top of the stack to the bottom.
+template <class T>
+class Stack {
+ public:
+  using const_iterator = typename std::vector<T>::const_reverse_iterator;
+
+  Stack() = default;
+
+  // Creates a stack holding just `x`.
+  explicit Stack(T x) : elements_({std::move(x)}) {}
+
+  void Push(T x) { elements_.push_back(std::move(x)); }
+
+  // Removes and returns the top element.
+  auto Pop() -> T {
+    assert(!IsEmpty() && "pop from an empty stack");
+    T top = std::move(elements_.back());
+    elements_.pop_back();
+    return top;
+  }
+
+  // Removes the top `n` elements.
+  void Pop(int n) {
+    assert(n <= Count() && "pop past the bottom of the stack");
+    elements_.resize(elements_.size() - n);
+  }
+
+  // Returns the element `depth` places below the top.
+  auto Top(int depth = 0) -> T& {
+    assert(depth < Count() && "read past the bottom of the stack");
+    return elements_[elements_.size() - 1 - depth];
+  }
+
+  // Inserts `x` so that it ends up `depth` places below the top; that is,
+  // below the `depth` elements that are currently on top of it.
+  void Insert(int depth, T x) {
+    assert(depth <= Count() && "insert past the bottom of the stack");
+    elements_.insert(elements_.end() - depth, std::move(x));
+  }
+
+  auto IsEmpty() const -> bool { return elements_.empty(); }
+
+  auto Count() const -> int { return static_cast<int>(elements_.size()); }
+
+  auto begin() const -> const_iterator { return elements_.rbegin(); }
+  auto end() const -> const_iterator { return elements_.rend(); }
+
+ private:
+  std::vector<T> elements_;
+};
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_EXPERIMENTAL_INTERPRETER_STACK_H
@@ -0,0 +1,59 @@
+#include "experimental/Interpreter/Trace.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace Cocktail {
+
+TraceOptions trace_options;
+
+auto ParseTraceLevel(const std::string& name) -> std::optional<TraceLevel> {
+  if (name == "none") {
+    return TraceLevel::None;
+  } else if (name == "calls") {
+    return TraceLevel::Calls;
+  } else if (name == "steps") {
+    return TraceLevel::Steps;
+  } else if (name == "full") {
+    return TraceLevel::Full;
+  } else {
+    return std::nullopt;
+  }
+}
+
+Tracer::Tracer(const TraceOptions& options)
+    : level_(options.level),
+      trace_steps_(options.level >= TraceLevel::Steps),
+      sample_every_(std::max(options.sample_every, 1)),
+      until_sample_(sample_every_) {
+  if (!options.binary_file.empty() && level_ != TraceLevel::None) {
+    binary_.open(options.binary_file, std::ios::binary | std::ios::trunc);
+    if (!binary_) {
+      std::cerr << "Error opening trace file '" << options.binary_file << "'"
+                << std::endl;
+      exit(-1);
+    }
+    binary_.write(TraceFileMagic, sizeof(TraceFileMagic));
+  }
+}
+
+void Tracer::Record(TraceEventKind kind, int line_num, int depth,
+                    uint8_t action) {
+  TraceRecord record = {
+      .step = steps_,
+      .line_num = line_num,
+      .depth = static_cast<uint16_t>(std::min(depth, 0xFFFF)),
+      .kind = kind,
+      .action = action};
+  binary_.write(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+void Tracer::Flush() {
+  if (binary_.is_open()) {
+    binary_.flush();
+  } else {
+    std::cout.flush();
+  }
+}
+
+}  // namespace Cocktail
@@ -0,0 +1,91 @@
+#ifndef COCKTAIL_EXPERIMENTAL_INTERPRETER_TRACE_H
+#define COCKTAIL_EXPERIMENTAL_INTERPRETER_TRACE_H
+
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+
+namespace Cocktail {
+
+// How much of the interpreter's execution is traced. Each level includes the
+// ones before it.
+enum class TraceLevel {
+  None,
+  // Function calls and returns.
+  Calls,
+  // One line describing each step.
+  Steps,
+  // The whole stack, heap and environment after each step.
+  Full,
+};
+
+auto ParseTraceLevel(const std::string& name) -> std::optional<TraceLevel>;
+
+struct TraceOptions {
+  TraceLevel level = TraceLevel::Full;
+  // At the `Steps` and `Full` levels, only every `sample_every`-th step is
+  // traced.
+  int sample_every = 1;
+  // When not empty, trace events are written to this file as `TraceRecord`s
+  // instead of being printed.
+  std::string binary_file;
+};
+
+// The options used by `InterpProgram`.
+extern TraceOptions trace_options;
+
+enum class TraceEventKind : uint8_t { Step, Call, Return };
+
+// A binary trace file is `TraceFileMagic` followed by these records, in host
+// byte order.
+struct TraceRecord {
+  // The number of steps taken before the event.
+  uint64_t step;
+  int32_t line_num;
+  // The number of frames on the stack.
+  uint16_t depth;
+  TraceEventKind kind;
+  // The `ActionKind` of the action being stepped, for `Step` events.
+  uint8_t action;
+};
+
+constexpr char TraceFileMagic[8] = {'C', 'K', 'T', 'R', 'A', 'C', 'E', '1'};
+
+class Tracer {
+ public:
+  explicit Tracer(const TraceOptions& options);
+
+  // Counts a step, and returns whether it is traced. This is the only work
+  // done per step when tracing is off.
+  auto StartStep() -> bool {
+    ++steps_;
+    if (!trace_steps_ || --until_sample_ > 0) {
+      return false;
+    }
+    until_sample_ = sample_every_;
+    return true;
+  }
+
+  auto traces_calls() const -> bool { return level_ >= TraceLevel::Calls; }
+  auto traces_state() const -> bool { return level_ == TraceLevel::Full; }
+  // Whether traced events should be printed to `std::cout`, rather than
+  // written with `Record`.
+  auto prints() const -> bool { return !binary_.is_open(); }
+  auto steps() const -> uint64_t { return steps_; }
+
+  void Record(TraceEventKind kind, int line_num, int depth, uint8_t action);
+  void Flush();
+
+ private:
+  TraceLevel level_;
+  bool trace_steps_;
+  int sample_every_;
+  int until_sample_;
+  uint64_t steps_ = 0;
+  std::ofstream binary_;
+};
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_EXPERIMENTAL_INTERPRETER_TRACE_H
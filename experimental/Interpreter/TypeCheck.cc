@@ -5,6 +5,7 @@
 #include <set>
 #include <vector>
 
+#include "experimental/AST/Arena.h"
 #include "experimental/AST/FunctionDefinition.h"
 #include "experimental/Interpreter/ConsList.h"
 #include "experimental/Interpreter/Interpreter.h"
@@ -26,7 +27,7 @@ auto Find(const std::string& s, Cons<std::string>* ls, int n) -> int {
 
 void ExpectType(int line_num, const std::string& context, Value* expected,
                 Value* actual) {
-  if (!TypeEqual(expected, actual)) {
+  if (!TypeEqual(state->types.Intern(expected), state->types.Intern(actual))) {
     std::cerr << line_num << ": type error in " << context << std::endl;
     std::cerr << "expected: ";
     PrintValue(expected, std::cerr);
@@ -50,7 +51,7 @@ void PrintTypeEnv(TypeEnv* env, std::ostream& out) {
 
 // Convert tuples to tuple types.
 auto ToType(int line_num, Value* val) -> Value* {
-  switch (val->tag) {
+  switch (KindOf(val)) {
     case ValKind::TupleV: {
       auto fields = new VarValues();
       for (auto& elt : *val->u.tuple.elts) {
@@ -75,8 +76,9 @@ auto ToType(int line_num, Value* val) -> Value* {
                             ToType(line_num, val->u.fun_type.ret));
     }
     case ValKind::VarPatV: {
-      return MakeVarPatVal(*val->u.var_pat.name,
-                           ToType(line_num, val->u.var_pat.type));
+      return MakeVarPatVal(val->u.var_pat.name,
+                           ToType(line_num, val->u.var_pat.type),
+                           val->u.var_pat.slot);
     }
     case ValKind::ChoiceTV:
     case ValKind::StructTV:
@@ -94,9 +96,21 @@ auto ToType(int line_num, Value* val) -> Value* {
   }
 }
 
+// Evaluates the type expression `e` in `ct_env`. A type expression is only
+// evaluated once in a given environment, and its type is canonical where
+// possible.
+auto InterpType(int line_num, Env* ct_env, Expression* e) -> Value* {
+  if (Value* t = state->types.FindEvaluated(e, ct_env)) {
+    return t;
+  }
+  Value* t = state->types.Intern(ToType(line_num, InterpExp(ct_env, e)));
+  state->types.RememberEvaluated(e, ct_env, t);
+  return t;
+}
+
 // Reify type to type expression.
 auto ReifyType(Value* t, int line_num) -> Expression* {
-  switch (t->tag) {
+  switch (KindOf(t)) {
     case ValKind::VarTV:
       return MakeVar(0, *t->u.var_type);
     case ValKind::IntTV:
@@ -109,7 +123,7 @@ auto ReifyType(Value* t, int line_num) -> Expression* {
       return MakeFunType(0, ReifyType(t->u.fun_type.param, line_num),
                          ReifyType(t->u.fun_type.ret, line_num));
     case ValKind::TupleTV: {
-      auto args = new std::vector<std::pair<std::string, Expression*>>();
+      auto args = ast_arena.New<FieldList>();
       for (auto& field : *t->u.tuple_type.fields) {
         args->push_back(
             make_pair(field.first, ReifyType(field.second, line_num)));
@@ -157,9 +171,8 @@ auto TypeCheckExp(Expression* e, TypeEnv* env, Env* ct_env, Value* expected,
                "pattern context"
             << std::endl;
       }
-      auto t =
-          ToType(e->line_num, InterpExp(ct_env, e->u.pattern_variable.type));
-      if (t->tag == ValKind::AutoTV) {
+      auto t = InterpType(e->line_num, ct_env, e->u.pattern_variable.type);
+      if (KindOf(t) == ValKind::AutoTV) {
         if (expected == nullptr) {
           std::cerr << e->line_num
                     << ": compilation error, auto not allowed here"
@@ -178,7 +191,7 @@ auto TypeCheckExp(Expression* e, TypeEnv* env, Env* ct_env, Value* expected,
       auto res = TypeCheckExp(e->u.get_field.aggregate, env, ct_env, nullptr,
                               TCContext::ValueContext);
       auto t = res.type;
-      switch (t->tag) {
+      switch (KindOf(t)) {
         case ValKind::TupleTV: {
           auto i = ToInteger(InterpExp(ct_env, e->u.index.offset));
           std::string f = std::to_string(i);
@@ -200,14 +213,14 @@ auto TypeCheckExp(Expression* e, TypeEnv* env, Env* ct_env, Value* expected,
       }
     }
     case ExpressionKind::Tuple: {
-      auto new_args = new std::vector<std::pair<std::string, Expression*>>();
+      auto new_args = ast_arena.New<FieldList>();
       auto arg_types = new VarValues();
       auto new_env = env;
       int i = 0;
       for (auto arg = e->u.tuple.fields->begin();
            arg != e->u.tuple.fields->end(); ++arg, ++i) {
         Value* arg_expected = nullptr;
-        if (expected && expected->tag == ValKind::TupleTV) {
+        if (expected && KindOf(expected) == ValKind::TupleTV) {
           arg_expected =
               FindInVarValues(arg->first, expected->u.tuple_type.fields);
           if (arg_expected == nullptr) {
@@ -230,7 +243,7 @@ auto TypeCheckExp(Expression* e, TypeEnv* env, Env* ct_env, Value* expected,
       auto res = TypeCheckExp(e->u.get_field.aggregate, env, ct_env, nullptr,
                               TCContext::ValueContext);
       auto t = res.type;
-      switch (t->tag) {
+      switch (KindOf(t)) {
         case ValKind::StructTV:
           // Search for a field
           for (auto& field : *t->u.struct_type.fields) {
@@ -298,7 +311,7 @@ auto TypeCheckExp(Expression* e, TypeEnv* env, Env* ct_env, Value* expected,
     case ExpressionKind::Boolean:
       return TCResult(e, MakeBoolTypeVal(), env);
     case ExpressionKind::PrimitiveOp: {
-      auto es = new std::vector<Expression*>();
+      auto es = ast_arena.New<ExpressionList>();
       std::vector<Value*> ts;
       auto new_env = env;
       for (auto& argument : *e->u.primitive_op.arguments) {
@@ -339,7 +352,7 @@ auto TypeCheckExp(Expression* e, TypeEnv* env, Env* ct_env, Value* expected,
     case ExpressionKind::Call: {
       auto fun_res = TypeCheckExp(e->u.call.function, env, ct_env, nullptr,
                                   TCContext::ValueContext);
-      switch (fun_res.type->tag) {
+      switch (KindOf(fun_res.type)) {
         case ValKind::FunctionTV: {
           auto fun_t = fun_res.type;
           auto arg_res =
@@ -365,10 +378,10 @@ auto TypeCheckExp(Expression* e, TypeEnv* env, Env* ct_env, Value* expected,
       switch (context) {
         case TCContext::ValueContext:
         case TCContext::TypeContext: {
-          auto pt = ToType(e->line_num,
-                           InterpExp(ct_env, e->u.function_type.parameter));
-          auto rt = ToType(e->line_num,
-                           InterpExp(ct_env, e->u.function_type.return_type));
+          auto pt =
+              InterpType(e->line_num, ct_env, e->u.function_type.parameter);
+          auto rt =
+              InterpType(e->line_num, ct_env, e->u.function_type.return_type);
           auto new_e = MakeFunType(e->line_num, ReifyType(pt, e->line_num),
                                    ReifyType(rt, e->line_num));
           return TCResult(new_e, MakeTypeTypeVal(), env);
@@ -419,7 +432,8 @@ auto TypeCheckStmt(Statement* s, TypeEnv* env, Env* ct_env, Value* ret_type)
       auto res = TypeCheckExp(s->u.match_stmt.exp, env, ct_env, nullptr,
                               TCContext::ValueContext);
       auto res_type = res.type;
-      auto new_clauses = new std::list<std::pair<Expression*, Statement*>>();
+      auto new_clauses =
+          ast_arena.New<std::list<std::pair<Expression*, Statement*>>>();
       for (auto& clause : *s->u.match_stmt.clauses) {
         new_clauses->push_back(TypecheckCase(
             res_type, clause.first, clause.second, env, ct_env, ret_type));
@@ -494,7 +508,7 @@ auto TypeCheckStmt(Statement* s, TypeEnv* env, Env* ct_env, Value* ret_type)
     case StatementKind::Return: {
       auto res = TypeCheckExp(s->u.return_stmt, env, ct_env, nullptr,
                               TCContext::ValueContext);
-      if (ret_type->tag == ValKind::AutoTV) {
+      if (KindOf(ret_type) == ValKind::AutoTV) {
         // The following infers the return type from the first 'return'
         // statement. This will get more difficult with subtyping, when we
         // should infer the least-upper bound of all the 'return' statements.
@@ -511,7 +525,7 @@ auto CheckOrEnsureReturn(Statement* stmt, bool void_return, int line_num)
     -> Statement* {
   if (!stmt) {
     if (void_return) {
-      auto args = new std::vector<std::pair<std::string, Expression*>>();
+      auto args = ast_arena.New<FieldList>();
       return MakeReturn(line_num, MakeTuple(line_num, args));
     } else {
       std::cerr
@@ -522,7 +536,8 @@ auto CheckOrEnsureReturn(Statement* stmt, bool void_return, int line_num)
   }
   switch (stmt->tag) {
     case StatementKind::Match: {
-      auto new_clauses = new std::list<std::pair<Expression*, Statement*>>();
+      auto new_clauses =
+          ast_arena.New<std::list<std::pair<Expression*, Statement*>>>();
       for (auto i = stmt->u.match_stmt.clauses->begin();
            i != stmt->u.match_stmt.clauses->end(); ++i) {
         auto s = CheckOrEnsureReturn(i->second, void_return, stmt->line_num);
@@ -558,7 +573,7 @@ auto CheckOrEnsureReturn(Statement* stmt, bool void_return, int line_num)
     case StatementKind::Continue:
     case StatementKind::VariableDefinition:
       if (void_return) {
-        auto args = new std::vector<std::pair<std::string, Expression*>>();
+        auto args = ast_arena.New<FieldList>();
         return MakeSeq(
             stmt->line_num, stmt,
             MakeReturn(stmt->line_num, MakeTuple(stmt->line_num, args)));
@@ -577,7 +592,7 @@ auto TypeCheckFunDef(struct FunctionDefinition* f, TypeEnv* env, Env* ct_env)
     -> struct FunctionDefinition* {
   auto param_res = TypeCheckExp(f->param_pattern, env, ct_env, nullptr,
                                 TCContext::PatternContext);
-  auto return_type = ToType(f->line_num, InterpExp(ct_env, f->return_type));
+  auto return_type = InterpType(f->line_num, ct_env, f->return_type);
   if (f->name == "main") {
     ExpectType(f->line_num, "return type of `main`", MakeIntTypeVal(),
                return_type);
@@ -595,10 +610,10 @@ auto TypeOfFunDef(TypeEnv* env, Env* ct_env, struct FunctionDefinition* fun_def)
   auto param_res = TypeCheckExp(fun_def->param_pattern, env, ct_env, nullptr,
                                 TCContext::PatternContext);
   auto param_type = ToType(fun_def->line_num, param_res.type);
-  auto ret = InterpExp(ct_env, fun_def->return_type);
-  if (ret->tag == ValKind::AutoTV) {
+  auto ret = InterpType(fun_def->line_num, ct_env, fun_def->return_type);
+  if (KindOf(ret) == ValKind::AutoTV) {
     auto f = TypeCheckFunDef(fun_def, env, ct_env);
-    ret = InterpExp(ct_env, f->return_type);
+    ret = InterpType(fun_def->line_num, ct_env, f->return_type);
   }
   return MakeFunTypeVal(param_type, ret);
 }
@@ -609,11 +624,11 @@ auto TypeOfStructDef(struct StructDefinition* sd, TypeEnv* /*env*/, Env* ct_top)
   auto methods = new VarValues();
   for (auto m = sd->members->begin(); m != sd->members->end(); ++m) {
     if ((*m)->tag == MemberKind::FieldMember) {
-      auto t = ToType(sd->line_num, InterpExp(ct_top, (*m)->u.field.type));
+      auto t = InterpType(sd->line_num, ct_top, (*m)->u.field.type);
       fields->push_back(std::make_pair(*(*m)->u.field.name, t));
     }
   }
-  return MakeStructTypeVal(*sd->name, fields, methods);
+  return MakeStructTypeVal(sd->name, fields, methods);
 }
 
 auto NameOfDecl(Declaration* d) -> std::string {
@@ -630,7 +645,7 @@ auto NameOfDecl(Declaration* d) -> std::string {
 auto TypeCheckDecl(Declaration* d, TypeEnv* env, Env* ct_env) -> Declaration* {
   switch (d->tag) {
     case DeclarationKind::StructDeclaration: {
-      auto members = new std::list<Member*>();
+      auto members = ast_arena.New<std::list<Member*>>();
       for (auto& member : *d->u.struct_def->members) {
         switch (member->tag) {
           case MemberKind::FieldMember: {
@@ -677,8 +692,7 @@ auto TopLevel(std::list<Declaration*>* fs) -> std::pair<TypeEnv*, Env*> {
         auto alts = new VarValues();
         for (auto i = d->u.choice_def.alternatives->begin();
              i != d->u.choice_def.alternatives->end(); ++i) {
-          auto t =
-              ToType(d->u.choice_def.line_num, InterpExp(ct_top, i->second));
+          auto t = InterpType(d->u.choice_def.line_num, ct_top, i->second);
           alts->push_back(std::make_pair(i->first, t));
         }
         auto ct = MakeChoiceTypeVal(d->u.choice_def.name, alts);
@@ -0,0 +1,141 @@
+#include "experimental/Interpreter/TypeTable.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace Cocktail {
+
+// The key of the type `t`, whose components are all canonical. Tuple types
+// are equal regardless of the order of their fields, so their fields are
+// keyed in a fixed order.
+static auto KeyOf(Value* t) -> std::vector<uintptr_t> {
+  std::vector<uintptr_t> key = {static_cast<uintptr_t>(t->tag)};
+  auto add = [&key](const void* p) {
+    key.push_back(reinterpret_cast<uintptr_t>(p));
+  };
+  switch (t->tag) {
+    case ValKind::PointerTV:
+      add(t->u.ptr_type.type);
+      break;
+    case ValKind::FunctionTV:
+      add(t->u.fun_type.param);
+      add(t->u.fun_type.ret);
+      break;
+    case ValKind::TupleTV: {
+      std::vector<std::pair<uintptr_t, uintptr_t>> fields;
+      for (const auto& field : *t->u.tuple_type.fields) {
+        fields.push_back(
+            {reinterpret_cast<uintptr_t>(InternName(field.first)),
+             reinterpret_cast<uintptr_t>(field.second)});
+      }
+      std::sort(fields.begin(), fields.end());
+      for (const auto& field : fields) {
+        key.push_back(field.first);
+        key.push_back(field.second);
+      }
+      break;
+    }
+    case ValKind::VarTV:
+      add(t->u.var_type);
+      break;
+    case ValKind::StructTV:
+      add(t->u.struct_type.name);
+      break;
+    case ValKind::ChoiceTV:
+      add(t->u.choice_type.name);
+      break;
+    default:
+      break;
+  }
+  return key;
+}
+
+auto TypeTable::KeyHash::operator()(const Key& key) const -> size_t {
+  size_t h = 0;
+  for (uintptr_t k : key) {
+    h = (h ^ std::hash<uintptr_t>()(k)) * 1099511628211u;
+  }
+  return h;
+}
+
+static auto IsCanonical(Value* t) -> bool {
+  return !IsImmediate(t) && t->canonical;
+}
+
+auto TypeTable::Intern(Value* t) -> Value* {
+  if (IsImmediate(t) || t->canonical) {
+    return t;
+  }
+  // Intern the components first, so that the key can refer to them by
+  // address. If they are all canonical already, `t` itself can serve as
+  // the canonical copy.
+  Value* c = t;
+  switch (t->tag) {
+    case ValKind::PointerTV: {
+      Value* type = Intern(t->u.ptr_type.type);
+      if (!IsCanonical(type)) {
+        return t;
+      }
+      if (type != t->u.ptr_type.type) {
+        c = MakePtrTypeVal(type);
+      }
+      break;
+    }
+    case ValKind::FunctionTV: {
+      Value* param = Intern(t->u.fun_type.param);
+      Value* ret = Intern(t->u.fun_type.ret);
+      if (!IsCanonical(param) || !IsCanonical(ret)) {
+        return t;
+      }
+      if (param != t->u.fun_type.param || ret != t->u.fun_type.ret) {
+        c = MakeFunTypeVal(param, ret);
+      }
+      break;
+    }
+    case ValKind::TupleTV: {
+      auto fields = new VarValues();
+      bool changed = false;
+      for (const auto& field : *t->u.tuple_type.fields) {
+        Value* type = Intern(field.second);
+        if (!IsCanonical(type)) {
+          delete fields;
+          return t;
+        }
+        changed = changed || type != field.second;
+        fields->push_back({field.first, type});
+      }
+      if (changed) {
+        c = MakeTupleTypeVal(fields);
+      } else {
+        delete fields;
+      }
+      break;
+    }
+    case ValKind::IntTV:
+    case ValKind::BoolTV:
+    case ValKind::VarTV:
+    case ValKind::StructTV:
+    case ValKind::ChoiceTV:
+      break;
+    default:
+      return t;
+  }
+  auto [entry, inserted] = canonical_.insert({KeyOf(c), c});
+  if (inserted) {
+    c->canonical = true;
+    values_.push_back(c);
+  }
+  return entry->second;
+}
+
+auto TypeTable::FindEvaluated(Expression* e, Env* env) const -> Value* {
+  auto entry = evaluated_.find({e, env});
+  return entry == evaluated_.end() ? nullptr : entry->second;
+}
+
+void TypeTable::RememberEvaluated(Expression* e, Env* env, Value* t) {
+  evaluated_[{e, env}] = t;
+  values_.push_back(t);
+}
+
+}  // namespace Cocktail
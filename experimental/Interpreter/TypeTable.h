@@ -0,0 +1,51 @@
+#ifndef COCKTAIL_EXPERIMENTAL_INTERPRETER_TYPE_TABLE_H
+#define COCKTAIL_EXPERIMENTAL_INTERPRETER_TYPE_TABLE_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "experimental/AST/Expression.h"
+#include "experimental/Interpreter/AssocList.h"
+#include "experimental/Interpreter/Value.h"
+
+namespace Cocktail {
+
+using Env = AssocList<std::string, Address>;
+
+// Hash-conses the types that the type checker works with, so that each
+// distinct type has a single canonical `Value`. Two canonical types are
+// `TypeEqual` iff they are the same object.
+//
+// Types that `TypeEqual` doesn't consider equal to themselves, such as
+// `auto` and `Type`, and any type containing one, are never made canonical.
+class TypeTable {
+ public:
+  // Returns the canonical copy of `t`, or `t` itself if it can't have one.
+  auto Intern(Value* t) -> Value*;
+
+  // The memoized type that the type expression `e` evaluates to in `env`,
+  // or null if it hasn't been evaluated yet.
+  auto FindEvaluated(Expression* e, Env* env) const -> Value*;
+  void RememberEvaluated(Expression* e, Env* env, Value* t);
+
+  // Every value held by the table, for the garbage collector.
+  auto values() const -> const std::vector<Value*>& { return values_; }
+
+ private:
+  using Key = std::vector<uintptr_t>;
+  struct KeyHash {
+    auto operator()(const Key& key) const -> size_t;
+  };
+
+  std::unordered_map<Key, Value*, KeyHash> canonical_;
+  std::map<std::pair<Expression*, Env*>, Value*> evaluated_;
+  std::vector<Value*> values_;
+};
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_EXPERIMENTAL_INTERPRETER_TYPE_TABLE_H
@@ -0,0 +1,109 @@
+#include "experimental/Interpreter/VM.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace Cocktail {
+
+namespace {
+
+// Where to resume when the current call returns.
+struct CallFrame {
+  const BytecodeFunction* function;
+  const Instruction* return_pc;
+  int base;
+  int result;
+};
+
+}  // namespace
+
+auto RunBytecode(const BytecodeProgram& program) -> int {
+  const BytecodeFunction* function = &program.functions[program.main_index];
+  const Instruction* pc = function->code.data();
+  // The registers of all active calls, each call's window starting at `base`.
+  std::vector<int> registers(std::max(1024, function->num_registers));
+  int base = 0;
+  std::vector<CallFrame> frames;
+
+  while (true) {
+    const Instruction& inst = *pc++;
+    int* r = registers.data() + base;
+    switch (inst.op) {
+      case OpCode::LoadInt:
+        r[inst.a] = inst.b;
+        break;
+      case OpCode::Move:
+        r[inst.a] = r[inst.b];
+        break;
+      case OpCode::Neg:
+        r[inst.a] = -r[inst.b];
+        break;
+      case OpCode::Not:
+        r[inst.a] = !r[inst.b];
+        break;
+      case OpCode::Add:
+        r[inst.a] = r[inst.b] + r[inst.c];
+        break;
+      case OpCode::Sub:
+        r[inst.a] = r[inst.b] - r[inst.c];
+        break;
+      case OpCode::And:
+        r[inst.a] = r[inst.b] && r[inst.c];
+        break;
+      case OpCode::Or:
+        r[inst.a] = r[inst.b] || r[inst.c];
+        break;
+      case OpCode::Eq:
+        r[inst.a] = r[inst.b] == r[inst.c];
+        break;
+      case OpCode::Jump:
+        pc = function->code.data() + inst.a;
+        break;
+      case OpCode::JumpIfFalse:
+        if (!r[inst.a]) {
+          pc = function->code.data() + inst.b;
+        }
+        break;
+      case OpCode::Call: {
+        const BytecodeFunction& callee = program.functions[inst.b];
+        size_t callee_base = base + function->num_registers;
+        size_t needed = callee_base + callee.num_registers;
+        if (registers.size() < needed) {
+          registers.resize(std::max(needed, 2 * registers.size()));
+          r = registers.data() + base;
+        }
+        std::copy(r + inst.c, r + inst.c + callee.num_params,
+                  registers.data() + callee_base);
+        frames.push_back({.function = function,
+                          .return_pc = pc,
+                          .base = base,
+                          .result = inst.a});
+        function = &callee;
+        pc = callee.code.data();
+        base = callee_base;
+        break;
+      }
+      case OpCode::Return: {
+        int result = r[inst.a];
+        if (frames.empty()) {
+          return result;
+        }
+        const CallFrame& caller = frames.back();
+        function = caller.function;
+        pc = caller.return_pc;
+        base = caller.base;
+        registers[base + caller.result] = result;
+        frames.pop_back();
+        break;
+      }
+      case OpCode::FellOffEnd:
+        std::cerr << "runtime error: fell off end of function "
+                  << function->name << " without `return`" << std::endl;
+        exit(-1);
+    }
+  }
+}
+
+}  // namespace Cocktail
@@ -0,0 +1,14 @@
+#ifndef COCKTAIL_EXPERIMENTAL_INTERPRETER_VM_H
+#define COCKTAIL_EXPERIMENTAL_INTERPRETER_VM_H
+
+#include "experimental/Interpreter/Bytecode.h"
+
+namespace Cocktail {
+
+// Runs `main` of a program produced by `CompileProgram` and returns its
+// result, which is the same as `InterpProgram` returns for the source.
+auto RunBytecode(const BytecodeProgram& program) -> int;
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_EXPERIMENTAL_INTERPRETER_VM_H
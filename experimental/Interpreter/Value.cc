@@ -32,43 +32,29 @@ auto FieldsEqual(VarValues* ts1, VarValues* ts2) -> bool {
   }
 }
 
-auto MakeIntVal(int i) -> Value* {
-  auto* v = new Value();
-  v->alive = true;
-  v->tag = ValKind::IntV;
-  v->u.integer = i;
-  return v;
+auto Value::operator new(size_t size) -> void* {
+  void* p = interpreter_pool.Allocate(size);
+  if (state) {
+    state->heap.Track(static_cast<Value*>(p));
+  }
+  return p;
 }
 
-auto MakeBoolVal(bool b) -> Value* {
-  auto* v = new Value();
-  v->alive = true;
-  v->tag = ValKind::BoolV;
-  v->u.boolean = b;
-  return v;
+void Value::operator delete(void* p, size_t size) {
+  interpreter_pool.Deallocate(p, size);
 }
 
-auto MakeFunVal(std::string name, Value* param, Statement* body) -> Value* {
+auto MakeFunVal(Name name, Value* param, Statement* body) -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::FunV;
-  v->u.fun.name = new std::string(std::move(name));
+  v->u.fun.name = name;
   v->u.fun.param = param;
   v->u.fun.body = body;
   return v;
 }
 
-auto MakePtrVal(Address addr) -> Value* {
-  auto* v = new Value();
-  v->alive = true;
-  v->tag = ValKind::PtrV;
-  v->u.ptr = addr;
-  return v;
-}
-
 auto MakeStructVal(Value* type, Value* inits) -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::StructV;
   v->u.struct_val.type = type;
   v->u.struct_val.inits = inits;
@@ -78,80 +64,70 @@ auto MakeStructVal(Value* type, Value* inits) -> Value* {
 auto MakeTupleVal(std::vector<std::pair<std::string, Address>>* elts)
     -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::TupleV;
   v->u.tuple.elts = elts;
   return v;
 }
 
-auto MakeAltVal(std::string alt_name, std::string choice_name, Value* arg)
-    -> Value* {
+auto MakeAltVal(Name alt_name, Name choice_name, Value* arg) -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::AltV;
-  v->u.alt.alt_name = new std::string(std::move(alt_name));
-  v->u.alt.choice_name = new std::string(std::move(choice_name));
+  v->u.alt.alt_name = alt_name;
+  v->u.alt.choice_name = choice_name;
   v->u.alt.arg = arg;
   return v;
 }
 
-auto MakeAltCons(std::string alt_name, std::string choice_name) -> Value* {
+auto MakeAltCons(Name alt_name, Name choice_name) -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::AltConsV;
-  v->u.alt.alt_name = new std::string(std::move(alt_name));
-  v->u.alt.choice_name = new std::string(std::move(choice_name));
+  v->u.alt.alt_name = alt_name;
+  v->u.alt.choice_name = choice_name;
   return v;
 }
 
-auto MakeVarPatVal(std::string name, Value* type) -> Value* {
+auto MakeVarPatVal(Name name, Value* type, int slot) -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::VarPatV;
-  v->u.var_pat.name = new std::string(std::move(name));
+  v->u.var_pat.name = name;
   v->u.var_pat.type = type;
+  v->u.var_pat.slot = slot;
   return v;
 }
 
-auto MakeVarTypeVal(std::string name) -> Value* {
+auto MakeVarTypeVal(Name name) -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::VarTV;
-  v->u.var_type = new std::string(std::move(name));
+  v->u.var_type = name;
   return v;
 }
 
 auto MakeIntTypeVal() -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::IntTV;
   return v;
 }
 
 auto MakeBoolTypeVal() -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::BoolTV;
   return v;
 }
 
 auto MakeTypeTypeVal() -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::TypeTV;
   return v;
 }
 
 auto MakeAutoTypeVal() -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::AutoTV;
   return v;
 }
 
 auto MakeFunTypeVal(Value* param, Value* ret) -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::FunctionTV;
   v->u.fun_type.param = param;
   v->u.fun_type.ret = ret;
@@ -160,18 +136,16 @@ auto MakeFunTypeVal(Value* param, Value* ret) -> Value* {
 
 auto MakePtrTypeVal(Value* type) -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::PointerTV;
   v->u.ptr_type.type = type;
   return v;
 }
 
-auto MakeStructTypeVal(std::string name, VarValues* fields, VarValues* methods)
+auto MakeStructTypeVal(Name name, VarValues* fields, VarValues* methods)
     -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::StructTV;
-  v->u.struct_type.name = new std::string(std::move(name));
+  v->u.struct_type.name = name;
   v->u.struct_type.fields = fields;
   v->u.struct_type.methods = methods;
   return v;
@@ -179,7 +153,6 @@ auto MakeStructTypeVal(std::string name, VarValues* fields, VarValues* methods)
 
 auto MakeTupleTypeVal(VarValues* fields) -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::TupleTV;
   v->u.tuple_type.fields = fields;
   return v;
@@ -187,17 +160,13 @@ auto MakeTupleTypeVal(VarValues* fields) -> Value* {
 
 auto MakeVoidTypeVal() -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::TupleTV;
   v->u.tuple_type.fields = new VarValues();
   return v;
 }
 
-auto MakeChoiceTypeVal(std::string* name,
-                       std::list<std::pair<std::string, Value*>>* alts)
-    -> Value* {
+auto MakeChoiceTypeVal(Name name, VarValues* alts) -> Value* {
   auto* v = new Value();
-  v->alive = true;
   v->tag = ValKind::ChoiceTV;
   v->u.choice_type.name = name;
   v->u.choice_type.alternatives = alts;
@@ -205,10 +174,7 @@ auto MakeChoiceTypeVal(std::string* name,
 }
 
 void PrintValue(Value* val, std::ostream& out) {
-  if (!val->alive) {
-    out << "!!";
-  }
-  switch (val->tag) {
+  switch (KindOf(val)) {
     case ValKind::AltConsV: {
       out << *val->u.alt_cons.choice_name << "." << *val->u.alt_cons.alt_name;
       break;
@@ -240,6 +206,9 @@ void PrintValue(Value* val, std::ostream& out) {
         }
 
         out << elt.first << " = ";
+        if (!state->heap.IsAlive(elt.second)) {
+          out << "!!";
+        }
         PrintValue(state->heap[elt.second], out);
         out << "@" << elt.second;
       }
@@ -247,16 +216,16 @@ void PrintValue(Value* val, std::ostream& out) {
       break;
     }
     case ValKind::IntV:
-      out << val->u.integer;
+      out << IntOf(val);
       break;
     case ValKind::BoolV:
-      out << std::boolalpha << val->u.boolean;
+      out << std::boolalpha << BoolOf(val);
       break;
     case ValKind::FunV:
       out << "fun<" << *val->u.fun.name << ">";
       break;
     case ValKind::PtrV:
-      out << "ptr<" << val->u.ptr << ">";
+      out << "ptr<" << PtrOf(val) << ">";
       break;
     case ValKind::BoolTV:
       out << "Bool";
@@ -310,21 +279,25 @@ void PrintValue(Value* val, std::ostream& out) {
 }
 
 auto TypeEqual(Value* t1, Value* t2) -> bool {
-  if (t1->tag != t2->tag) {
+  if (!IsImmediate(t1) && t1->canonical && !IsImmediate(t2) &&
+      t2->canonical) {
+    return t1 == t2;
+  }
+  if (KindOf(t1) != KindOf(t2)) {
     return false;
   }
-  switch (t1->tag) {
+  switch (KindOf(t1)) {
     case ValKind::VarTV:
-      return *t1->u.var_type == *t2->u.var_type;
+      return t1->u.var_type == t2->u.var_type;
     case ValKind::PointerTV:
       return TypeEqual(t1->u.ptr_type.type, t2->u.ptr_type.type);
     case ValKind::FunctionTV:
       return TypeEqual(t1->u.fun_type.param, t2->u.fun_type.param) &&
              TypeEqual(t1->u.fun_type.ret, t2->u.fun_type.ret);
     case ValKind::StructTV:
-      return *t1->u.struct_type.name == *t2->u.struct_type.name;
+      return t1->u.struct_type.name == t2->u.struct_type.name;
     case ValKind::ChoiceTV:
-      return *t1->u.choice_type.name == *t2->u.choice_type.name;
+      return t1->u.choice_type.name == t2->u.choice_type.name;
     case ValKind::TupleTV:
       return FieldsEqual(t1->u.tuple_type.fields, t2->u.tuple_type.fields);
     case ValKind::IntTV:
@@ -353,18 +326,15 @@ static auto FieldsValueEqual(VarValues* ts1, VarValues* ts2, int line_num)
 }
 
 auto ValueEqual(Value* v1, Value* v2, int line_num) -> bool {
-  CheckAlive(v1, line_num);
-  CheckAlive(v2, line_num);
-  if (v1->tag != v2->tag) {
+  if (KindOf(v1) != KindOf(v2)) {
     return false;
   }
-  switch (v1->tag) {
+  switch (KindOf(v1)) {
     case ValKind::IntV:
-      return v1->u.integer == v2->u.integer;
     case ValKind::BoolV:
-      return v1->u.boolean == v2->u.boolean;
     case ValKind::PtrV:
-      return v1->u.ptr == v2->u.ptr;
+      // Equal immediates have equal bits.
+      return v1 == v2;
     case ValKind::FunV:
       return v1->u.fun.body == v2->u.fun.body;
     case ValKind::TupleV:
@@ -376,9 +346,9 @@ auto ValueEqual(Value* v1, Value* v2, int line_num) -> bool {
 }
 
 auto ToInteger(Value* v) -> int {
-  switch (v->tag) {
+  switch (KindOf(v)) {
     case ValKind::IntV:
-      return v->u.integer;
+      return IntOf(v);
     default:
       std::cerr << "expected an integer, not ";
       PrintValue(v, std::cerr);
@@ -386,13 +356,4 @@ auto ToInteger(Value* v) -> int {
   }
 }
 
-void CheckAlive(Value* v, int line_num) {
-  if (!v->alive) {
-    std::cerr << line_num << ": undefined behavior: access to dead value ";
-    PrintValue(v, std::cerr);
-    std::cerr << std::endl;
-    exit(-1);
-  }
-}
-
 }  // namespace Cocktail
\ No newline at end of file
@@ -1,21 +1,26 @@
 #ifndef COCKTAIL_EXPERIMENTAL_INTERPRETER_VALUE_H
 #define COCKTAIL_EXPERIMENTAL_INTERPRETER_VALUE_H
 
+#include <cstddef>
+#include <cstdint>
 #include <list>
+#include <string>
 #include <vector>
 
+#include "experimental/AST/Name.h"
 #include "experimental/AST/Statement.h"
 
 namespace Cocktail {
 
 struct Value;
 using Address = unsigned int;
+
 using VarValues = std::list<std::pair<std::string, Value*>>;
 
 auto FindInVarValues(const std::string& field, VarValues* inits) -> Value*;
 auto FieldsEqual(VarValues* ts1, VarValues* ts2) -> bool;
 
-enum class ValKind {
+enum class ValKind : uint8_t {
   IntV,
   FunV,
   PtrV,
@@ -38,13 +43,21 @@ enum class ValKind {
 };
 
 struct Value {
+  // Values come from `interpreter_pool`, and while a program runs they are
+  // owned by its heap; see Heap.h.
+  static auto operator new(size_t size) -> void*;
+  static void operator delete(void* p, size_t size);
+
+  // Only meaningful for boxed values; use `KindOf` to find the kind of any
+  // value.
   ValKind tag;
-  bool alive;
+  // Whether this is the canonical copy of a type in a `TypeTable`.
+  bool canonical;
+  // The garbage collector's mark.
+  uint32_t mark;
   union {
-    int integer;
-    bool boolean;
     struct {
-      std::string* name;
+      Name name;
       Value* param;
       Statement* body;
     } fun;
@@ -53,22 +66,22 @@ struct Value {
       Value* inits;
     } struct_val;
     struct {
-      std::string* alt_name;
-      std::string* choice_name;
+      Name alt_name;
+      Name choice_name;
     } alt_cons;
     struct {
-      std::string* alt_name;
-      std::string* choice_name;
+      Name alt_name;
+      Name choice_name;
       Value* arg;
     } alt;
     struct {
       std::vector<std::pair<std::string, Address>>* elts;
     } tuple;
-    Address ptr;
-    std::string* var_type;
+    Name var_type;
     struct {
-      std::string* name;
+      Name name;
       Value* type;
+      int slot;  // the frame slot that a match binds
     } var_pat;
     struct {
       Value* param;
@@ -78,7 +91,7 @@ struct Value {
       Value* type;
     } ptr_type;
     struct {
-      std::string* name;
+      Name name;
       VarValues* fields;
       VarValues* methods;
     } struct_type;
@@ -87,7 +100,7 @@ struct Value {
       VarValues* fields;
     } tuple_type;
     struct {
-      std::string* name;
+      Name name;
       VarValues* alternatives;
     } choice_type;
     struct {
@@ -97,30 +110,94 @@ struct Value {
   } u;
 };
 
-auto MakeIntVal(int i) -> Value*;
-auto MakeBoolVal(bool b) -> Value*;
-auto MakeFunVal(std::string name, Value* param, Statement* body) -> Value*;
-auto MakePtrVal(Address addr) -> Value*;
+/***** Immediate Values *****/
+
+// Integers, Booleans and pointers are never boxed: the value is encoded in
+// the bits of the `Value*` itself, so making one allocates nothing. The low
+// bit of an immediate is set, which no `Value` allocation has, the next two
+// bits hold its kind, and the upper 32 bits hold its payload. An immediate
+// must not be dereferenced.
+static_assert(sizeof(uintptr_t) == 8, "immediates need 64-bit pointers");
+
+namespace ImmediateBits {
+constexpr uintptr_t Tag = 1;
+constexpr uintptr_t IntKind = 0 << 1;
+constexpr uintptr_t BoolKind = 1 << 1;
+constexpr uintptr_t PtrKind = 2 << 1;
+constexpr uintptr_t KindMask = 3 << 1;
+constexpr int PayloadShift = 32;
+}  // namespace ImmediateBits
+
+inline auto IsImmediate(const Value* v) -> bool {
+  return (reinterpret_cast<uintptr_t>(v) & ImmediateBits::Tag) != 0;
+}
+
+inline auto MakeImmediate(uintptr_t kind, uint32_t payload) -> Value* {
+  return reinterpret_cast<Value*>(
+      (static_cast<uintptr_t>(payload) << ImmediateBits::PayloadShift) | kind |
+      ImmediateBits::Tag);
+}
+
+inline auto ImmediatePayload(const Value* v) -> uint32_t {
+  return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(v) >>
+                               ImmediateBits::PayloadShift);
+}
+
+inline auto KindOf(const Value* v) -> ValKind {
+  if (!IsImmediate(v)) {
+    return v->tag;
+  }
+  switch (reinterpret_cast<uintptr_t>(v) & ImmediateBits::KindMask) {
+    case ImmediateBits::IntKind:
+      return ValKind::IntV;
+    case ImmediateBits::BoolKind:
+      return ValKind::BoolV;
+    default:
+      return ValKind::PtrV;
+  }
+}
+
+inline auto MakeIntVal(int i) -> Value* {
+  return MakeImmediate(ImmediateBits::IntKind, static_cast<uint32_t>(i));
+}
+
+inline auto MakeBoolVal(bool b) -> Value* {
+  return MakeImmediate(ImmediateBits::BoolKind, b ? 1 : 0);
+}
+
+inline auto MakePtrVal(Address addr) -> Value* {
+  return MakeImmediate(ImmediateBits::PtrKind, addr);
+}
+
+// These expect a value of the corresponding kind.
+inline auto IntOf(const Value* v) -> int {
+  return static_cast<int>(ImmediatePayload(v));
+}
+inline auto BoolOf(const Value* v) -> bool { return ImmediatePayload(v) != 0; }
+inline auto PtrOf(const Value* v) -> Address { return ImmediatePayload(v); }
+
+/***** Boxed Values *****/
+
+auto MakeFunVal(Name name, Value* param, Statement* body) -> Value*;
 auto MakeStructVal(Value* type, Value* inits) -> Value*;
 auto MakeTupleVal(std::vector<std::pair<std::string, Address>>* elts) -> Value*;
-auto MakeAltVal(std::string alt_name, std::string choice_name, Value* arg)
-    -> Value*;
-auto MakeAltCons(std::string alt_name, std::string choice_name) -> Value*;
+auto MakeAltVal(Name alt_name, Name choice_name, Value* arg) -> Value*;
+auto MakeAltCons(Name alt_name, Name choice_name) -> Value*;
 
-auto MakeVarPatVal(std::string name, Value* type) -> Value*;
+auto MakeVarPatVal(Name name, Value* type, int slot) -> Value*;
 
-auto MakeVarTypeVal(std::string name) -> Value*;
+auto MakeVarTypeVal(Name name) -> Value*;
 auto MakeIntTypeVal() -> Value*;
 auto MakeAutoTypeVal() -> Value*;
 auto MakeBoolTypeVal() -> Value*;
 auto MakeTypeTypeVal() -> Value*;
 auto MakeFunTypeVal(Value* param, Value* ret) -> Value*;
 auto MakePtrTypeVal(Value* type) -> Value*;
-auto MakeStructTypeVal(std::string name, VarValues* fields, VarValues* methods)
+auto MakeStructTypeVal(Name name, VarValues* fields, VarValues* methods)
     -> Value*;
 auto MakeTupleTypeVal(VarValues* fields) -> Value*;
 auto MakeVoidTypeVal() -> Value*;
-auto MakeChoiceTypeVal(std::string* name, VarValues* alts) -> Value*;
+auto MakeChoiceTypeVal(Name name, VarValues* alts) -> Value*;
 
 void PrintValue(Value* val, std::ostream& out);
 
@@ -128,7 +205,6 @@ auto TypeEqual(Value* t1, Value* t2) -> bool;
 auto ValueEqual(Value* v1, Value* v2, int line_num) -> bool;
 
 auto ToInteger(Value* v) -> int;
-void CheckAlive(Value* v, int line_num);
 
 }  // namespace Cocktail
 
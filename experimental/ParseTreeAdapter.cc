@@ -0,0 +1,592 @@
+#include "experimental/ParseTreeAdapter.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Cocktail/Diagnostics/DiagnosticEmitter.h"
+#include "Cocktail/Source/SourceBuffer.h"
+#include "experimental/AST/Arena.h"
+#include "llvm/Support/VirtualFileSystem.h"
+
+namespace Cocktail {
+
+namespace {
+
+// Something built from a parse node that its parent hasn't used yet. Which
+// fields are set depends on `kind`:
+//
+// - For an expression, `exp`.
+// - For a statement, `stmt`. An assignment is a statement, even though it
+//   is parsed as an infix operator.
+// - For `var` and `let`, the pattern in `exp` and the initializer, if any,
+//   in `init`.
+// - For a declaration, `decl`.
+// - For a name or a field designator, `name`.
+// - For a node that opens a bracketed range, such as `CodeBlockStart`,
+//   nothing; it only marks where the range starts. Some of these also carry
+//   what was parsed before the range, such as the callee of a call.
+struct Fragment {
+  Parse::NodeKind kind;
+  int line_num;
+  std::string name = "";
+  Expression* exp = nullptr;
+  Expression* init = nullptr;
+  Statement* stmt = nullptr;
+  Declaration* decl = nullptr;
+};
+
+class ASTBuilder {
+ public:
+  ASTBuilder(const Lex::TokenizedBuffer& tokens, const Parse::Tree& tree)
+      : tokens_(tokens), tree_(tree) {}
+
+  auto Build() -> std::list<Declaration*>*;
+
+ private:
+  void Handle(Parse::Node node);
+  void HandleLiteral(Parse::Node node, int line_num);
+  void HandlePrefixOperator(Parse::Node node, int line_num);
+  void HandleInfixOperator(Parse::Node node, int line_num);
+  void HandleFunctionSignature(Parse::Node node, int line_num);
+
+  [[noreturn]] void Error(int line_num, const std::string& message);
+
+  void Push(Fragment fragment) { stack_.push_back(std::move(fragment)); }
+  // Pops a fragment built from a node of the given kind.
+  auto Pop(Parse::NodeKind kind) -> Fragment;
+  auto PopExp() -> Expression*;
+  // Pops everything above the innermost `start` node, and the `start` node
+  // itself, which is returned. The rest are left in `children`, in order.
+  auto PopBracketed(Parse::NodeKind start, std::vector<Fragment>* children)
+      -> Fragment;
+
+  auto ToStatement(const Fragment& fragment) -> Statement*;
+  // Chains `children` into a sequence, or returns null if there are none.
+  auto ToStatementList(const std::vector<Fragment>& children) -> Statement*;
+
+  const Lex::TokenizedBuffer& tokens_;
+  const Parse::Tree& tree_;
+  std::vector<Fragment> stack_;
+};
+
+auto ASTBuilder::Build() -> std::list<Declaration*>* {
+  stack_.reserve(64);
+  for (Parse::Node node : tree_.postorder()) {
+    Handle(node);
+  }
+  auto* decls = ast_arena.New<std::list<Declaration*>>();
+  for (const Fragment& fragment : stack_) {
+    if (fragment.decl == nullptr) {
+      Error(fragment.line_num,
+            "only functions and classes may be declared at file scope");
+    }
+    decls->push_back(fragment.decl);
+  }
+  return decls;
+}
+
+void ASTBuilder::Error(int line_num, const std::string& message) {
+  std::cerr << tokens_.filename().str() << ":" << line_num << ": " << message
+            << std::endl;
+  exit(-1);
+}
+
+auto ASTBuilder::Pop(Parse::NodeKind kind) -> Fragment {
+  if (stack_.empty() || stack_.back().kind != kind) {
+    std::cerr << "internal error in BuildProgram, expected "
+              << kind.name().str() << std::endl;
+    exit(-1);
+  }
+  Fragment fragment = std::move(stack_.back());
+  stack_.pop_back();
+  return fragment;
+}
+
+auto ASTBuilder::PopExp() -> Expression* {
+  Fragment& fragment = stack_.back();
+  if (fragment.exp == nullptr || fragment.stmt != nullptr) {
+    Error(fragment.line_num, fragment.stmt != nullptr
+                                 ? "assignment is only allowed as a statement"
+                                 : "expected an expression");
+  }
+  Expression* exp = fragment.exp;
+  stack_.pop_back();
+  return exp;
+}
+
+auto ASTBuilder::PopBracketed(Parse::NodeKind start,
+                              std::vector<Fragment>* children) -> Fragment {
+  size_t first = stack_.size();
+  while (first > 0 && stack_[first - 1].kind != start) {
+    --first;
+  }
+  if (first == 0) {
+    std::cerr << "internal error in BuildProgram, no " << start.name().str()
+              << std::endl;
+    exit(-1);
+  }
+  if (children) {
+    children->assign(std::make_move_iterator(stack_.begin() + first),
+                     std::make_move_iterator(stack_.end()));
+  }
+  stack_.resize(first);
+  return Pop(start);
+}
+
+auto ASTBuilder::ToStatement(const Fragment& fragment) -> Statement* {
+  if (fragment.kind == Parse::NodeKind::VariableDeclaration ||
+      fragment.kind == Parse::NodeKind::LetDeclaration) {
+    if (fragment.init == nullptr) {
+      Error(fragment.line_num, "a local variable must be initialized");
+    }
+    return MakeVarDef(fragment.line_num, fragment.exp, fragment.init);
+  }
+  if (fragment.stmt == nullptr) {
+    Error(fragment.line_num, "expected a statement");
+  }
+  return fragment.stmt;
+}
+
+auto ASTBuilder::ToStatementList(const std::vector<Fragment>& children)
+    -> Statement* {
+  Statement* seq = nullptr;
+  for (auto child = children.rbegin(); child != children.rend(); ++child) {
+    seq = MakeSeq(child->line_num, ToStatement(*child), seq);
+  }
+  return seq;
+}
+
+void ASTBuilder::HandleLiteral(Parse::Node node, int line_num) {
+  Lex::Token token = tree_.node_token(node);
+  Expression* exp = nullptr;
+  switch (tokens_.GetKind(token)) {
+    case Lex::TokenKind::IntegerLiteral: {
+      const llvm::APInt& value = tokens_.GetIntegerLiteral(token);
+      if (value.getActiveBits() > 31) {
+        Error(line_num, "integer literal is too large");
+      }
+      exp = MakeInt(line_num, value.getZExtValue());
+      break;
+    }
+    case Lex::TokenKind::True:
+    case Lex::TokenKind::False:
+      exp = MakeBool(line_num,
+                     tokens_.GetKind(token) == Lex::TokenKind::True);
+      break;
+    case Lex::TokenKind::IntegerTypeLiteral:
+      if (tokens_.GetTokenText(token) != "i32") {
+        Error(line_num, "i32 is the only integer type");
+      }
+      exp = MakeIntType(line_num);
+      break;
+    case Lex::TokenKind::Bool:
+      exp = MakeBoolType(line_num);
+      break;
+    case Lex::TokenKind::Type:
+      exp = MakeTypeType(line_num);
+      break;
+    default:
+      Error(line_num, "unsupported literal `" +
+                          tokens_.GetTokenText(token).str() + "`");
+  }
+  Push({Parse::NodeKind::Literal, line_num, "", exp});
+}
+
+void ASTBuilder::HandlePrefixOperator(Parse::Node node, int line_num) {
+  Expression* arg = PopExp();
+  Operator op;
+  switch (tokens_.GetKind(tree_.node_token(node))) {
+    case Lex::TokenKind::Minus:
+      op = Operator::Neg;
+      break;
+    case Lex::TokenKind::Not:
+      op = Operator::Not;
+      break;
+    default:
+      Error(line_num, "unsupported operator `" +
+                          tree_.GetNodeText(node).str() + "`");
+  }
+  Push({Parse::NodeKind::PrefixOperator, line_num, "",
+        MakeUnOp(line_num, op, arg)});
+}
+
+void ASTBuilder::HandleInfixOperator(Parse::Node node, int line_num) {
+  Expression* rhs = PopExp();
+  Expression* lhs = PopExp();
+  Operator op;
+  switch (tokens_.GetKind(tree_.node_token(node))) {
+    case Lex::TokenKind::Equal:
+      Push({Parse::NodeKind::InfixOperator, line_num, "", nullptr, nullptr,
+            MakeAssign(line_num, lhs, rhs)});
+      return;
+    case Lex::TokenKind::Plus:
+      op = Operator::Add;
+      break;
+    case Lex::TokenKind::Minus:
+      op = Operator::Sub;
+      break;
+    case Lex::TokenKind::EqualEqual:
+      op = Operator::Eq;
+      break;
+    case Lex::TokenKind::And:
+      op = Operator::And;
+      break;
+    case Lex::TokenKind::Or:
+      op = Operator::Or;
+      break;
+    default:
+      Error(line_num, "unsupported operator `" +
+                          tree_.GetNodeText(node).str() + "`");
+  }
+  Push({Parse::NodeKind::InfixOperator, line_num, "",
+        MakeBinOp(line_num, op, lhs, rhs)});
+}
+
+// Pops the name, parameters and return type of a function, and pushes them
+// as one fragment of the given node's kind: the parameters in `exp` and the
+// return type in `init`.
+void ASTBuilder::HandleFunctionSignature(Parse::Node node, int line_num) {
+  // A missing return type means the empty tuple, as in the bison grammar.
+  Expression* return_type =
+      stack_.back().kind == Parse::NodeKind::ReturnType
+          ? Pop(Parse::NodeKind::ReturnType).exp
+          : MakeTuple(line_num, ast_arena.New<FieldList>());
+  Expression* params = Pop(Parse::NodeKind::ParameterList).exp;
+  if (stack_.back().kind != Parse::NodeKind::Name) {
+    Error(line_num, "functions must have a plain name");
+  }
+  std::string name = Pop(Parse::NodeKind::Name).name;
+  Fragment introducer = Pop(Parse::NodeKind::FunctionIntroducer);
+  Push({tree_.node_kind(node), introducer.line_num, std::move(name), params,
+        return_type});
+}
+
+void ASTBuilder::Handle(Parse::Node node) {
+  Parse::NodeKind kind = tree_.node_kind(node);
+  int line_num = tokens_.GetLineNumber(tree_.node_token(node));
+  std::vector<Fragment> children;
+  switch (kind) {
+    case Parse::NodeKind::FileStart:
+    case Parse::NodeKind::FileEnd:
+    case Parse::NodeKind::EmptyDeclaration:
+    // Separators and the nodes that introduce the initializer of a `var` or
+    // `let` are implied by the shape of their parent.
+    case Parse::NodeKind::ParameterListComma:
+    case Parse::NodeKind::TupleLiteralComma:
+    case Parse::NodeKind::CallExpressionComma:
+    case Parse::NodeKind::StructComma:
+    case Parse::NodeKind::VariableInitializer:
+    case Parse::NodeKind::LetInitializer:
+    // The left operand of `and` and `or` is already on the stack.
+    case Parse::NodeKind::ShortCircuitOperand:
+      break;
+
+    // Nodes that open a bracketed range, or that their parent looks for.
+    case Parse::NodeKind::FunctionIntroducer:
+    case Parse::NodeKind::ClassIntroducer:
+    case Parse::NodeKind::ParameterListStart:
+    case Parse::NodeKind::CodeBlockStart:
+    case Parse::NodeKind::VariableIntroducer:
+    case Parse::NodeKind::LetIntroducer:
+    case Parse::NodeKind::ReturnStatementStart:
+    case Parse::NodeKind::BreakStatementStart:
+    case Parse::NodeKind::ContinueStatementStart:
+    case Parse::NodeKind::IfConditionStart:
+    case Parse::NodeKind::IfStatementElse:
+    case Parse::NodeKind::WhileConditionStart:
+    case Parse::NodeKind::ParenExpressionOrTupleLiteralStart:
+    case Parse::NodeKind::StructLiteralOrStructTypeLiteralStart:
+      Push({kind, line_num});
+      break;
+
+    case Parse::NodeKind::Name:
+      Push({kind, line_num, tree_.GetNodeText(node).str()});
+      break;
+    case Parse::NodeKind::NameExpression:
+      Push({kind, line_num, "",
+            MakeVar(line_num, tree_.GetNodeText(node).str())});
+      break;
+    case Parse::NodeKind::Literal:
+      HandleLiteral(node, line_num);
+      break;
+    case Parse::NodeKind::PrefixOperator:
+      HandlePrefixOperator(node, line_num);
+      break;
+    case Parse::NodeKind::InfixOperator:
+      HandleInfixOperator(node, line_num);
+      break;
+
+    case Parse::NodeKind::ParenExpression: {
+      Expression* exp = PopExp();
+      Pop(Parse::NodeKind::ParenExpressionOrTupleLiteralStart);
+      Push({kind, line_num, "", exp});
+      break;
+    }
+    case Parse::NodeKind::TupleLiteral: {
+      Fragment start = PopBracketed(
+          Parse::NodeKind::ParenExpressionOrTupleLiteralStart, &children);
+      auto* fields = ast_arena.New<FieldList>();
+      for (Fragment& child : children) {
+        stack_.push_back(std::move(child));
+        fields->push_back({"", PopExp()});
+      }
+      Push({kind, start.line_num, "", MakeTuple(start.line_num, fields)});
+      break;
+    }
+    case Parse::NodeKind::StructFieldDesignator:
+      Push({kind, line_num, Pop(Parse::NodeKind::Name).name});
+      break;
+    case Parse::NodeKind::StructFieldValue: {
+      Expression* exp = PopExp();
+      std::string field = Pop(Parse::NodeKind::StructFieldDesignator).name;
+      Push({kind, line_num, std::move(field), exp});
+      break;
+    }
+    case Parse::NodeKind::StructLiteral: {
+      Fragment start = PopBracketed(
+          Parse::NodeKind::StructLiteralOrStructTypeLiteralStart, &children);
+      auto* fields = ast_arena.New<FieldList>();
+      for (const Fragment& child : children) {
+        fields->push_back({child.name, child.exp});
+      }
+      Push({kind, start.line_num, "", MakeTuple(start.line_num, fields)});
+      break;
+    }
+    case Parse::NodeKind::MemberAccessExpression: {
+      std::string field = Pop(Parse::NodeKind::Name).name;
+      Expression* aggregate = PopExp();
+      Push({kind, line_num, "",
+            MakeGetField(line_num, aggregate, std::move(field))});
+      break;
+    }
+    case Parse::NodeKind::IndexExpressionStart:
+      Push({kind, line_num, "", PopExp()});
+      break;
+    case Parse::NodeKind::IndexExpression: {
+      Expression* index = PopExp();
+      Fragment start = Pop(Parse::NodeKind::IndexExpressionStart);
+      Push({kind, line_num, "", MakeIndex(line_num, start.exp, index)});
+      break;
+    }
+    case Parse::NodeKind::CallExpressionStart:
+      Push({kind, line_num, "", PopExp()});
+      break;
+    case Parse::NodeKind::CallExpression: {
+      Fragment start =
+          PopBracketed(Parse::NodeKind::CallExpressionStart, &children);
+      Expression* arg;
+      if (children.size() == 1 &&
+          children[0].kind == Parse::NodeKind::StructLiteral) {
+        // `F({.a = 1})` passes named arguments, which is how structs are
+        // constructed.
+        arg = children[0].exp;
+      } else {
+        auto* fields = ast_arena.New<FieldList>();
+        for (Fragment& child : children) {
+          stack_.push_back(std::move(child));
+          fields->push_back({"", PopExp()});
+        }
+        arg = MakeTuple(start.line_num, fields);
+      }
+      Push({kind, start.line_num, "",
+            MakeCall(start.line_num, start.exp, arg)});
+      break;
+    }
+
+    case Parse::NodeKind::PatternBinding: {
+      Expression* type = PopExp();
+      std::string name = Pop(Parse::NodeKind::Name).name;
+      Push({kind, line_num, "", MakeVarPat(line_num, std::move(name), type)});
+      break;
+    }
+    case Parse::NodeKind::ParameterList: {
+      Fragment start =
+          PopBracketed(Parse::NodeKind::ParameterListStart, &children);
+      auto* fields = ast_arena.New<FieldList>();
+      for (const Fragment& child : children) {
+        fields->push_back({"", child.exp});
+      }
+      Push({kind, start.line_num, "", MakeTuple(start.line_num, fields)});
+      break;
+    }
+    case Parse::NodeKind::ReturnType:
+      Push({kind, line_num, "", PopExp()});
+      break;
+    case Parse::NodeKind::FunctionDefinitionStart:
+      HandleFunctionSignature(node, line_num);
+      break;
+    case Parse::NodeKind::FunctionDefinition: {
+      Fragment sig =
+          PopBracketed(Parse::NodeKind::FunctionDefinitionStart, &children);
+      Statement* body = ToStatementList(children);
+      Fragment decl = {kind, sig.line_num};
+      decl.decl = MakeFunDecl(
+          MakeFunDef(sig.line_num, sig.name, sig.init, sig.exp, body));
+      Push(std::move(decl));
+      break;
+    }
+    case Parse::NodeKind::FunctionDeclaration: {
+      HandleFunctionSignature(node, line_num);
+      Fragment sig = Pop(kind);
+      sig.decl = MakeFunDecl(
+          MakeFunDef(sig.line_num, sig.name, sig.init, sig.exp, nullptr));
+      Push(std::move(sig));
+      break;
+    }
+
+    case Parse::NodeKind::ClassDefinitionStart: {
+      if (stack_.back().kind != Parse::NodeKind::Name) {
+        Error(line_num, "classes must have a plain name");
+      }
+      std::string name = Pop(Parse::NodeKind::Name).name;
+      Fragment introducer = Pop(Parse::NodeKind::ClassIntroducer);
+      Push({kind, introducer.line_num, std::move(name)});
+      break;
+    }
+    case Parse::NodeKind::ClassDefinition: {
+      Fragment start =
+          PopBracketed(Parse::NodeKind::ClassDefinitionStart, &children);
+      auto* members = ast_arena.New<std::list<Member*>>();
+      for (const Fragment& child : children) {
+        if (child.kind != Parse::NodeKind::VariableDeclaration ||
+            child.exp->tag != ExpressionKind::PatternVariable ||
+            child.init != nullptr) {
+          Error(child.line_num,
+                "a class may only hold uninitialized `var` fields");
+        }
+        members->push_back(MakeField(child.line_num,
+                                     *child.exp->u.pattern_variable.name,
+                                     child.exp->u.pattern_variable.type));
+      }
+      Fragment decl = {kind, start.line_num};
+      decl.decl = MakeStructDecl(start.line_num, start.name, members);
+      Push(std::move(decl));
+      break;
+    }
+
+    case Parse::NodeKind::CodeBlock: {
+      Fragment start = PopBracketed(Parse::NodeKind::CodeBlockStart, &children);
+      Fragment block = {kind, start.line_num};
+      block.stmt = MakeBlock(start.line_num, ToStatementList(children));
+      Push(std::move(block));
+      break;
+    }
+    case Parse::NodeKind::ExpressionStatement: {
+      Fragment exp = std::move(stack_.back());
+      stack_.pop_back();
+      Fragment stmt = {kind, line_num};
+      stmt.stmt = exp.stmt != nullptr ? exp.stmt
+                                      : MakeExpStmt(exp.line_num, exp.exp);
+      Push(std::move(stmt));
+      break;
+    }
+    case Parse::NodeKind::VariableDeclaration:
+    case Parse::NodeKind::LetDeclaration: {
+      // `let` is treated as `var`, since the interpreter doesn't have
+      // immutable bindings.
+      Expression* init = stack_.back().kind != Parse::NodeKind::PatternBinding
+                             ? PopExp()
+                             : nullptr;
+      Expression* pattern = Pop(Parse::NodeKind::PatternBinding).exp;
+      Fragment start = Pop(kind == Parse::NodeKind::VariableDeclaration
+                               ? Parse::NodeKind::VariableIntroducer
+                               : Parse::NodeKind::LetIntroducer);
+      Push({kind, start.line_num, "", pattern, init});
+      break;
+    }
+    case Parse::NodeKind::ReturnStatement: {
+      Fragment start =
+          PopBracketed(Parse::NodeKind::ReturnStatementStart, &children);
+      Expression* exp;
+      if (children.empty()) {
+        exp = MakeTuple(start.line_num, ast_arena.New<FieldList>());
+      } else {
+        stack_.push_back(std::move(children[0]));
+        exp = PopExp();
+      }
+      Fragment stmt = {kind, start.line_num};
+      stmt.stmt = MakeReturn(start.line_num, exp);
+      Push(std::move(stmt));
+      break;
+    }
+    case Parse::NodeKind::BreakStatement:
+    case Parse::NodeKind::ContinueStatement: {
+      Pop(kind == Parse::NodeKind::BreakStatement
+              ? Parse::NodeKind::BreakStatementStart
+              : Parse::NodeKind::ContinueStatementStart);
+      Fragment stmt = {kind, line_num};
+      stmt.stmt = kind == Parse::NodeKind::BreakStatement
+                      ? MakeBreak(line_num)
+                      : MakeContinue(line_num);
+      Push(std::move(stmt));
+      break;
+    }
+    case Parse::NodeKind::IfCondition:
+    case Parse::NodeKind::WhileCondition: {
+      Expression* cond = PopExp();
+      Fragment start = Pop(kind == Parse::NodeKind::IfCondition
+                               ? Parse::NodeKind::IfConditionStart
+                               : Parse::NodeKind::WhileConditionStart);
+      Push({kind, start.line_num, "", cond});
+      break;
+    }
+    case Parse::NodeKind::IfStatement: {
+      Statement* else_stmt = nullptr;
+      if (stack_.size() >= 2 &&
+          stack_[stack_.size() - 2].kind == Parse::NodeKind::IfStatementElse) {
+        else_stmt = Pop(stack_.back().kind).stmt;
+        Pop(Parse::NodeKind::IfStatementElse);
+      }
+      Statement* then_stmt = Pop(Parse::NodeKind::CodeBlock).stmt;
+      Fragment cond = Pop(Parse::NodeKind::IfCondition);
+      Fragment stmt = {kind, cond.line_num};
+      stmt.stmt = MakeIf(cond.line_num, cond.exp, then_stmt, else_stmt);
+      Push(std::move(stmt));
+      break;
+    }
+    case Parse::NodeKind::WhileStatement: {
+      Statement* body = Pop(Parse::NodeKind::CodeBlock).stmt;
+      Fragment cond = Pop(Parse::NodeKind::WhileCondition);
+      Fragment stmt = {kind, cond.line_num};
+      stmt.stmt = MakeWhile(cond.line_num, cond.exp, body);
+      Push(std::move(stmt));
+      break;
+    }
+
+    default:
+      Error(line_num, "`" + kind.name().str() +
+                          "` is not supported by the interpreter");
+  }
+}
+
+}  // namespace
+
+auto BuildProgram(const Lex::TokenizedBuffer& tokens, const Parse::Tree& tree)
+    -> std::list<Declaration*>* {
+  return ASTBuilder(tokens, tree).Build();
+}
+
+auto ParseFile(const char* filename) -> std::list<Declaration*>* {
+  DiagnosticConsumer& consumer = ConsoleDiagnosticConsumer();
+  auto fs = llvm::vfs::getRealFileSystem();
+  std::optional<SourceBuffer> source =
+      SourceBuffer::CreateFromFile(*fs, filename, consumer);
+  if (!source) {
+    exit(-1);
+  }
+  auto tokens = Lex::TokenizedBuffer::Lex(*source, consumer);
+  if (tokens.has_errors()) {
+    exit(-1);
+  }
+  auto tree = Parse::Tree::Parse(tokens, consumer, /*vlog_stream=*/nullptr);
+  if (tree.has_errors()) {
+    exit(-1);
+  }
+  return BuildProgram(tokens, tree);
+}
+
+}  // namespace Cocktail
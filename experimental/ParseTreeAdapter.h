@@ -0,0 +1,31 @@
+#ifndef COCKTAIL_EXPERIMENTAL_PARSE_TREE_ADAPTER_H
+#define COCKTAIL_EXPERIMENTAL_PARSE_TREE_ADAPTER_H
+
+#include <list>
+
+#include "Cocktail/Lex/TokenizedBuffer.h"
+#include "Cocktail/Parse/Tree.h"
+#include "experimental/AST/Declaration.h"
+
+namespace Cocktail {
+
+// Builds the experimental AST for a file that the toolchain's lexer and
+// parser have already handled, in a single postorder walk of `tree`. `tree`
+// must not have errors.
+//
+// Only the subset of the language that the interpreter runs is accepted:
+// functions, classes with fields, `var` and `let`, `if`, `while`, `return`,
+// `break` and `continue`, and `i32`, `bool` and tuple values. Anything else
+// is reported as an error, with the program's line number, and the process
+// exits.
+auto BuildProgram(const Lex::TokenizedBuffer& tokens, const Parse::Tree& tree)
+    -> std::list<Declaration*>*;
+
+// Lexes, parses and builds the program in `filename` with the toolchain's
+// front end. Diagnostics go to the console, and the process exits if there
+// are any errors.
+auto ParseFile(const char* filename) -> std::list<Declaration*>*;
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_EXPERIMENTAL_PARSE_TREE_ADAPTER_H
@@ -1,13 +1,19 @@
 #include "experimental/SyntaxHelper.h"
 
+#include <fstream>
 #include <iostream>
+#include <string>
 
+#include "experimental/Interpreter/Bytecode.h"
 #include "experimental/Interpreter/Interpreter.h"
+#include "experimental/Interpreter/Profile.h"
 #include "experimental/Interpreter/TypeCheck.h"
+#include "experimental/Interpreter/VM.h"
 
 namespace Cocktail {
 
 char* input_filename = nullptr;
+Engine engine = Engine::TreeWalker;
 
 void PrintSyntaxError(char* error, int line_num) {
   std::cerr << input_filename << ":" << line_num << ": " << error << std::endl;
@@ -33,9 +39,38 @@ void ExecProgram(std::list<Declaration*>* fs) {
   for (const auto& decl : new_decls) {
     PrintDecl(decl);
   }
+  if (engine == Engine::Bytecode) {
+    std::cout << "********** compiling to bytecode **********" << std::endl;
+    if (auto program = CompileProgram(&new_decls, std::cout)) {
+      PrintBytecode(*program, std::cout);
+      std::cout << "********** starting execution **********" << std::endl;
+      int result = RunBytecode(*program);
+      std::cout << "result: " << result << std::endl;
+      return;
+    }
+  }
   std::cout << "********** starting execution **********" << std::endl;
   int result = InterpProgram(&new_decls);
   std::cout << "result: " << result << std::endl;
+  if (report_heap_stats) {
+    PrintHeapStats(state->heap, std::cout);
+  }
+  if (profiler) {
+    profiler->PrintFlat(std::cout);
+    std::string file = profile_options.collapsed_file;
+    if (file.empty()) {
+      file = std::string(input_filename ? input_filename : "cocktail") +
+             ".folded";
+    }
+    std::ofstream collapsed(file, std::ios::trunc);
+    if (!collapsed) {
+      std::cerr << "Error opening '" << file << "' for the profile"
+                << std::endl;
+      exit(-1);
+    }
+    profiler->WriteCollapsed(collapsed);
+    std::cout << "collapsed stacks written to " << file << std::endl;
+  }
 }
 
 }  // namespace Cocktail
\ No newline at end of file
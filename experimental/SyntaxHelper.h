@@ -9,6 +9,16 @@ namespace Cocktail {
 
 extern char* input_filename;
 
+enum class Engine {
+  // Steps through the type-checked AST with `InterpProgram`.
+  TreeWalker,
+  // Compiles to bytecode and runs it on the register VM, falling back to the
+  // tree walker for programs the bytecode compiler doesn't support.
+  Bytecode,
+};
+
+extern Engine engine;
+
 void PrintSyntaxError(char* error, int line_num);
 
 void ExecProgram(std::list<Declaration*>* fs);
@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+
+#include <iostream>
+#include <list>
+
+#include "experimental/Interpreter/Bytecode.h"
+#include "experimental/Interpreter/Interpreter.h"
+#include "experimental/Interpreter/Trace.h"
+#include "experimental/Interpreter/VM.h"
+#include "experimental/benchmarks/Programs.h"
+
+namespace {
+
+using namespace Cocktail;
+using namespace Cocktail::Benchmarks;
+
+void RunTreeWalker(benchmark::State& bench_state,
+                   std::list<Declaration*>* program) {
+  auto decls = TypeCheckProgram(program);
+  trace_options.level = TraceLevel::None;
+  for (auto _ : bench_state) {
+    benchmark::DoNotOptimize(InterpProgram(decls));
+  }
+}
+
+void RunBytecodeVM(benchmark::State& bench_state,
+                   std::list<Declaration*>* program) {
+  auto decls = TypeCheckProgram(program);
+  auto bytecode = CompileProgram(decls, std::cerr);
+  if (!bytecode) {
+    bench_state.SkipWithError("Program not supported by the bytecode VM");
+    return;
+  }
+  for (auto _ : bench_state) {
+    benchmark::DoNotOptimize(RunBytecode(*bytecode));
+  }
+}
+
+static void BM_Engine_TreeWalkerFib(benchmark::State& state) {
+  RunTreeWalker(state, MakeFibProgram(state.range(0)));
+}
+static void BM_Engine_BytecodeFib(benchmark::State& state) {
+  RunBytecodeVM(state, MakeFibProgram(state.range(0)));
+}
+static void BM_Engine_TreeWalkerLoop(benchmark::State& state) {
+  RunTreeWalker(state, MakeLoopProgram(state.range(0)));
+}
+static void BM_Engine_BytecodeLoop(benchmark::State& state) {
+  RunBytecodeVM(state, MakeLoopProgram(state.range(0)));
+}
+
+BENCHMARK(BM_Engine_TreeWalkerFib)->Arg(5)->Arg(10)->Arg(15);
+BENCHMARK(BM_Engine_BytecodeFib)->Arg(5)->Arg(10)->Arg(15)->Arg(20);
+BENCHMARK(BM_Engine_TreeWalkerLoop)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_Engine_BytecodeLoop)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+}  // namespace
+
+BENCHMARK_MAIN();
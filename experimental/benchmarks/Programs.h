@@ -0,0 +1,146 @@
+#ifndef COCKTAIL_EXPERIMENTAL_BENCHMARKS_PROGRAMS_H
+#define COCKTAIL_EXPERIMENTAL_BENCHMARKS_PROGRAMS_H
+
+#include <iostream>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "experimental/AST/Arena.h"
+#include "experimental/AST/Declaration.h"
+#include "experimental/AST/FunctionDefinition.h"
+#include "experimental/Interpreter/Interpreter.h"
+#include "experimental/Interpreter/TypeCheck.h"
+
+// Programs for the interpreter benchmarks, built directly as ASTs since the
+// benchmarks don't link the parser.
+
+namespace Cocktail::Benchmarks {
+
+class NullBuffer : public std::streambuf {
+ protected:
+  auto overflow(int c) -> int override { return c; }
+};
+
+// Discards everything written to `std::cout` while alive.
+class SilenceStdout {
+ public:
+  SilenceStdout() : old_(std::cout.rdbuf(&null_)) {}
+  ~SilenceStdout() { std::cout.rdbuf(old_); }
+
+ private:
+  NullBuffer null_;
+  std::streambuf* old_;
+};
+
+inline auto Args(std::vector<Expression*> args) -> Expression* {
+  auto fields = ast_arena.New<FieldList>();
+  for (auto* arg : args) {
+    fields->push_back({"", arg});
+  }
+  return MakeTuple(0, fields);
+}
+
+inline auto Seq(std::vector<Statement*> stmts) -> Statement* {
+  Statement* seq = nullptr;
+  for (auto s = stmts.rbegin(); s != stmts.rend(); ++s) {
+    seq = MakeSeq(0, *s, seq);
+  }
+  return seq;
+}
+
+inline auto IntVar(const std::string& name) -> Expression* {
+  return MakeVarPat(0, name, MakeIntType(0));
+}
+
+inline auto MakeMain(Statement* body) -> Declaration* {
+  return MakeFunDecl(MakeFunDef(0, "main", MakeIntType(0), Args({}), body));
+}
+
+// fn fib(n: Int) -> Int {
+//   if (n == 0) { return 0; }
+//   else if (n == 1) { return 1; }
+//   else { return fib(n - 1) + fib(n - 2); }
+// }
+// fn main() -> Int { return fib(n); }
+inline auto MakeFibProgram(int n) -> std::list<Declaration*>* {
+  auto n_var = [] { return MakeVar(0, "n"); };
+  auto fib_of = [&](int k) {
+    return MakeCall(0, MakeVar(0, "fib"),
+                    Args({MakeBinOp(0, Operator::Sub, n_var(), MakeInt(0, k))}));
+  };
+  Statement* body = MakeIf(
+      0, MakeBinOp(0, Operator::Eq, n_var(), MakeInt(0, 0)),
+      MakeBlock(0, MakeReturn(0, MakeInt(0, 0))),
+      MakeIf(0, MakeBinOp(0, Operator::Eq, n_var(), MakeInt(0, 1)),
+             MakeBlock(0, MakeReturn(0, MakeInt(0, 1))),
+             MakeBlock(0, MakeReturn(0, MakeBinOp(0, Operator::Add, fib_of(1),
+                                                  fib_of(2))))));
+  auto fib = MakeFunDecl(
+      MakeFunDef(0, "fib", MakeIntType(0), Args({IntVar("n")}), body));
+  auto main = MakeMain(MakeReturn(
+      0, MakeCall(0, MakeVar(0, "fib"), Args({MakeInt(0, n)}))));
+  return new std::list<Declaration*>({fib, main});
+}
+
+// fn main() -> Int {
+//   var Int: i = 0;
+//   var Int: sum = 0;
+//   while (not (i == n)) { sum = sum + i; i = i + 1; }
+//   return sum;
+// }
+inline auto MakeLoopProgram(int n) -> std::list<Declaration*>* {
+  auto var = [](const char* name) { return MakeVar(0, name); };
+  Statement* loop = MakeWhile(
+      0,
+      MakeUnOp(0, Operator::Not,
+               MakeBinOp(0, Operator::Eq, var("i"), MakeInt(0, n))),
+      MakeBlock(
+          0, Seq({MakeAssign(0, var("sum"),
+                             MakeBinOp(0, Operator::Add, var("sum"), var("i"))),
+                  MakeAssign(0, var("i"), MakeBinOp(0, Operator::Add, var("i"),
+                                                    MakeInt(0, 1)))})));
+  return new std::list<Declaration*>(
+      {MakeMain(Seq({MakeVarDef(0, IntVar("i"), MakeInt(0, 0)),
+                     MakeVarDef(0, IntVar("sum"), MakeInt(0, 0)), loop,
+                     MakeReturn(0, var("sum"))}))});
+}
+
+// fn count(n: Int) -> Int {
+//   if (n == 0) { return 0; } else { return 1 + count(n - 1); }
+// }
+// fn main() -> Int { return count(n); }
+inline auto MakeDeepRecursionProgram(int n) -> std::list<Declaration*>* {
+  auto n_var = [] { return MakeVar(0, "n"); };
+  Expression* recurse = MakeCall(
+      0, MakeVar(0, "count"),
+      Args({MakeBinOp(0, Operator::Sub, n_var(), MakeInt(0, 1))}));
+  Statement* body = MakeIf(
+      0, MakeBinOp(0, Operator::Eq, n_var(), MakeInt(0, 0)),
+      MakeBlock(0, MakeReturn(0, MakeInt(0, 0))),
+      MakeBlock(0, MakeReturn(0, MakeBinOp(0, Operator::Add, MakeInt(0, 1),
+                                           recurse))));
+  auto count = MakeFunDecl(
+      MakeFunDef(0, "count", MakeIntType(0), Args({IntVar("n")}), body));
+  auto main = MakeMain(MakeReturn(
+      0, MakeCall(0, MakeVar(0, "count"), Args({MakeInt(0, n)}))));
+  return new std::list<Declaration*>({count, main});
+}
+
+// Type checks `fs` the same way as `ExecProgram`.
+inline auto TypeCheckProgram(std::list<Declaration*>* fs)
+    -> std::list<Declaration*>* {
+  SilenceStdout silence;
+  state = new State();
+  auto [top, ct_top] = TopLevel(fs);
+  auto new_decls = new std::list<Declaration*>();
+  for (auto* decl : *fs) {
+    new_decls->push_back(TypeCheckDecl(decl, top, ct_top));
+  }
+  return new_decls;
+}
+
+}  // namespace Cocktail::Benchmarks
+
+#endif  // COCKTAIL_EXPERIMENTAL_BENCHMARKS_PROGRAMS_H
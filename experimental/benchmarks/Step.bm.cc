@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+
+#include "experimental/Interpreter/Interpreter.h"
+#include "experimental/Interpreter/Trace.h"
+#include "experimental/benchmarks/Programs.h"
+
+namespace {
+
+using namespace Cocktail;
+using namespace Cocktail::Benchmarks;
+
+// Runs a counting loop under `options` and reports interpreter steps per
+// second.
+static void RunSteps(benchmark::State& bench_state,
+                     const TraceOptions& options) {
+  auto decls = TypeCheckProgram(MakeLoopProgram(bench_state.range(0)));
+  trace_options = options;
+  SilenceStdout silence;
+  uint64_t steps = 0;
+  for (auto _ : bench_state) {
+    benchmark::DoNotOptimize(InterpProgram(decls));
+    steps += tracer->steps();
+  }
+  bench_state.counters["steps"] =
+      benchmark::Counter(steps, benchmark::Counter::kIsRate);
+  trace_options = TraceOptions();
+}
+
+static void BM_Step_TraceNone(benchmark::State& state) {
+  RunSteps(state, {.level = TraceLevel::None});
+}
+
+static void BM_Step_TraceCalls(benchmark::State& state) {
+  RunSteps(state, {.level = TraceLevel::Calls});
+}
+
+static void BM_Step_TraceStepsSampled(benchmark::State& state) {
+  RunSteps(state, {.level = TraceLevel::Steps, .sample_every = 1000});
+}
+
+static void BM_Step_TraceStepsBinary(benchmark::State& state) {
+  RunSteps(state,
+           {.level = TraceLevel::Steps, .binary_file = "step_bm.trace"});
+  std::remove("step_bm.trace");
+}
+
+static void BM_Step_TraceFull(benchmark::State& state) {
+  RunSteps(state, {.level = TraceLevel::Full});
+}
+
+// The call depth grows with the argument, so the time per step should stay
+// flat as the argument grows.
+static void BM_Step_DeepRecursion(benchmark::State& bench_state) {
+  auto decls =
+      TypeCheckProgram(MakeDeepRecursionProgram(bench_state.range(0)));
+  trace_options = {.level = TraceLevel::None};
+  uint64_t steps = 0;
+  for (auto _ : bench_state) {
+    benchmark::DoNotOptimize(InterpProgram(decls));
+    steps += tracer->steps();
+  }
+  bench_state.counters["steps"] =
+      benchmark::Counter(steps, benchmark::Counter::kIsRate);
+  trace_options = TraceOptions();
+}
+
+BENCHMARK(BM_Step_TraceNone)->Arg(100)->Arg(1000);
+BENCHMARK(BM_Step_TraceCalls)->Arg(100)->Arg(1000);
+BENCHMARK(BM_Step_TraceStepsSampled)->Arg(100)->Arg(1000);
+BENCHMARK(BM_Step_TraceStepsBinary)->Arg(100)->Arg(1000);
+// Printing the whole state makes each step cost O(heap size).
+BENCHMARK(BM_Step_TraceFull)->Arg(100);
+BENCHMARK(BM_Step_DeepRecursion)->Arg(500)->Arg(2000)->Arg(8000);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -1,8 +1,16 @@
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <string>
 
+#include "experimental/Interpreter/Heap.h"
+#include "experimental/Interpreter/Profile.h"
+#include "experimental/Interpreter/Trace.h"
 #include "experimental/SyntaxHelper.h"
+#ifdef COCKTAIL_EXPERIMENTAL_PARSE_TREE
+#include "experimental/ParseTreeAdapter.h"
+#endif
 
 extern FILE* yyin;
 extern auto yyparse() -> int;  // NOLINT(readability-identifier-naming)
@@ -10,11 +18,80 @@ extern auto yyparse() -> int;  // NOLINT(readability-identifier-naming)
 int main(int argc, char* argv[]) {
   // yydebug = 1;
 
-  if (argc > 1) {
-    Cocktail::input_filename = argv[1];
-    yyin = fopen(argv[1], "r");
+  // Whether to read the program with the toolchain's lexer and parser,
+  // rather than the bison grammar.
+  bool use_parse_tree = false;
+  int arg = 1;
+  for (; arg < argc && strncmp(argv[arg], "--", 2) == 0; ++arg) {
+    std::string option = argv[arg];
+    std::string value = option.substr(option.find('=') + 1);
+    if (option.rfind("--engine=", 0) == 0) {
+      if (value == "bytecode") {
+        Cocktail::engine = Cocktail::Engine::Bytecode;
+      } else if (value != "tree") {
+        std::cerr << "Unknown engine '" << value
+                  << "', expected 'tree' or 'bytecode'" << std::endl;
+        return 1;
+      }
+    } else if (option.rfind("--frontend=", 0) == 0) {
+      if (value == "parse-tree") {
+        use_parse_tree = true;
+      } else if (value != "bison") {
+        std::cerr << "Unknown front end '" << value
+                  << "', expected 'bison' or 'parse-tree'" << std::endl;
+        return 1;
+      }
+    } else if (option.rfind("--trace=", 0) == 0) {
+      auto level = Cocktail::ParseTraceLevel(value);
+      if (!level) {
+        std::cerr << "Unknown trace level '" << value
+                  << "', expected 'none', 'calls', 'steps' or 'full'"
+                  << std::endl;
+        return 1;
+      }
+      Cocktail::trace_options.level = *level;
+    } else if (option.rfind("--trace-sample=", 0) == 0) {
+      Cocktail::trace_options.sample_every = atoi(value.c_str());
+      if (Cocktail::trace_options.sample_every < 1) {
+        std::cerr << "--trace-sample expects a positive number" << std::endl;
+        return 1;
+      }
+    } else if (option.rfind("--trace-file=", 0) == 0) {
+      Cocktail::trace_options.binary_file = value;
+    } else if (option == "--heap-stats") {
+      Cocktail::report_heap_stats = true;
+    } else if (option == "--profile") {
+      Cocktail::profile_options.enabled = true;
+    } else if (option.rfind("--profile=", 0) == 0) {
+      Cocktail::profile_options.enabled = true;
+      Cocktail::profile_options.collapsed_file = value;
+    } else {
+      std::cerr << "Unknown option '" << option << "'" << std::endl;
+      return 1;
+    }
+  }
+
+  if (use_parse_tree) {
+#ifdef COCKTAIL_EXPERIMENTAL_PARSE_TREE
+    if (arg >= argc) {
+      std::cerr << "--frontend=parse-tree needs an input file" << std::endl;
+      return 1;
+    }
+    Cocktail::input_filename = argv[arg];
+    Cocktail::ExecProgram(Cocktail::ParseFile(argv[arg]));
+    return 0;
+#else
+    std::cerr << "This build doesn't include the toolchain's front end"
+              << std::endl;
+    return 1;
+#endif
+  }
+
+  if (arg < argc) {
+    Cocktail::input_filename = argv[arg];
+    yyin = fopen(argv[arg], "r");
     if (yyin == nullptr) {
-      std::cerr << "Error opening '" << argv[1] << "': " << strerror(errno)
+      std::cerr << "Error opening '" << argv[arg] << "': " << strerror(errno)
                 << std::endl;
       return 1;
     }
@@ -0,0 +1,32 @@
+# Runs `EXEC` on `BISON_INPUT` with the bison front end and on
+# `PARSE_TREE_INPUT` with `--frontend=parse-tree`, under each engine, and
+# checks that every run succeeds and reports `result: EXPECTED_RESULT`.
+#
+# Usage: cmake -DEXEC=... -DBISON_INPUT=... -DPARSE_TREE_INPUT=...
+#              -DEXPECTED_RESULT=... -P CompareFrontEnds.cmake
+
+foreach(engine tree bytecode)
+  foreach(frontend bison parse-tree)
+    if(frontend STREQUAL "bison")
+      set(input ${BISON_INPUT})
+    else()
+      set(input ${PARSE_TREE_INPUT})
+    endif()
+    execute_process(
+      COMMAND ${EXEC} --engine=${engine} --frontend=${frontend} ${input}
+      OUTPUT_VARIABLE output
+      ERROR_VARIABLE errors
+      RESULT_VARIABLE status)
+    if(NOT status EQUAL 0)
+      message(FATAL_ERROR
+        "--engine=${engine} --frontend=${frontend} ${input} exited with "
+        "${status}:\n${errors}")
+    endif()
+    string(REGEX MATCH "result: [-0-9]+" result "${output}")
+    if(NOT result STREQUAL "result: ${EXPECTED_RESULT}")
+      message(FATAL_ERROR
+        "--engine=${engine} --frontend=${frontend} ${input} reported "
+        "'${result}', expected 'result: ${EXPECTED_RESULT}':\n${output}")
+    endif()
+  endforeach()
+endforeach()
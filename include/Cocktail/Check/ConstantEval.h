@@ -0,0 +1,42 @@
+#ifndef COCKTAIL_CHECK_CONSTANT_EVAL_H
+#define COCKTAIL_CHECK_CONSTANT_EVAL_H
+
+#include "Cocktail/Check/Context.h"
+#include "Cocktail/SemIR/Node.h"
+
+namespace Cocktail::Check {
+
+// Returns the canonical constant node that `node_id` evaluates to, or
+// `NodeId::Invalid` if it isn't a compile-time constant. Literals are added to
+// the constant table the first time they're queried.
+auto GetConstantValue(Context& context, SemIR::NodeId node_id)
+    -> SemIR::NodeId;
+
+// Attempts to fold `node_id`, which has just been added, to a constant. If all
+// of its operands are constants, records and returns its constant value.
+// Otherwise, returns `NodeId::Invalid`.
+//
+// Handles integer addition, `not`, and tuple and struct values whose elements
+// are scalar constants.
+auto TryEvalNode(Context& context, SemIR::NodeId node_id) -> SemIR::NodeId;
+
+// Attempts to fold the result `result_id` of a short-circuiting `and` (if
+// `is_and`) or `or` with the given operands. This succeeds if the first
+// operand is a constant that decides the result, or if both operands are
+// constants.
+auto TryEvalShortCircuitOperator(Context& context, SemIR::NodeId result_id,
+                                 bool is_and, SemIR::NodeId lhs_id,
+                                 SemIR::NodeId rhs_id) -> SemIR::NodeId;
+
+// Attempts to fold the call `call_id`, which has just been added, by
+// interpreting the callee. This succeeds if the callee is fully defined,
+// returns `i32` or `bool`, and all arguments are constants, and if the
+// interpreter finishes within the check-time step and call depth limits.
+// Nothing is folded once an error has been diagnosed, and a call that fails
+// to fold is remembered so that the same callee and arguments aren't run
+// again.
+auto TryEvalCall(Context& context, SemIR::NodeId call_id) -> SemIR::NodeId;
+
+}  // namespace Cocktail::Check
+
+#endif  // COCKTAIL_CHECK_CONSTANT_EVAL_H
@@ -11,6 +11,7 @@
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/FoldingSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringSet.h"
 
 namespace Cocktail::Check {
 
@@ -20,6 +21,7 @@ class Context {
   // Stores references for work.
   explicit Context(const Lex::TokenizedBuffer& tokens,
                    DiagnosticEmitter<Parse::Node>& emitter,
+                   const ErrorTrackingDiagnosticConsumer& err_tracker,
                    const Parse::Tree& parse_tree, SemIR::File& semantics,
                    llvm::raw_ostream* vlog_stream);
 
@@ -166,6 +168,10 @@ class Context {
 
   auto emitter() -> DiagnosticEmitter<Parse::Node>& { return *emitter_; }
 
+  // Returns whether an error has been diagnosed so far. `has_errors` on the
+  // SemIR is only set once checking finishes.
+  auto seen_error() const -> bool { return err_tracker_->seen_error(); }
+
   auto parse_tree() -> const Parse::Tree& { return *parse_tree_; }
 
   auto semantics_ir() -> SemIR::File& { return *semantics_ir_; }
@@ -186,6 +192,8 @@ class Context {
     return declaration_name_stack_;
   }
 
+  auto failed_call_evals() -> llvm::StringSet<>& { return failed_call_evals_; }
+
  private:
   // A FoldingSet node for a type.
   class TypeNode : public llvm::FastFoldingSetNode {
@@ -238,6 +246,9 @@ class Context {
   // Handles diagnostics.
   DiagnosticEmitter<Parse::Node>* emitter_;
 
+  // Tracks whether `emitter_` has reported an error.
+  const ErrorTrackingDiagnosticConsumer* err_tracker_;
+
   // The file's parse tree.
   const Parse::Tree* parse_tree_;
 
@@ -294,6 +305,11 @@ class Context {
   // Storage for the nodes in canonical_type_nodes_. This stores in pointers so
   // that FoldingSet can have stable pointers.
   llvm::SmallVector<std::unique_ptr<TypeNode>> type_node_storage_;
+
+  // Calls that couldn't be folded at check time, keyed by the callee and the
+  // constant arguments, so that repeating such a call doesn't run the
+  // interpreter again. See `TryEvalCall`.
+  llvm::StringSet<> failed_call_evals_;
 };
 
 // Parse node handlers. Returns false for unrecoverable errors.
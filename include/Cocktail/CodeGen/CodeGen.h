@@ -1,6 +1,7 @@
 #ifndef COCKTAIL_CODEGEN_CODE_GEN_H
 #define COCKTAIL_CODEGEN_CODE_GEN_H
 
+#include <memory>
 #include <optional>
 
 #include "llvm/IR/Module.h"
@@ -13,6 +14,18 @@ class CodeGen {
   static auto Create(llvm::Module& module, llvm::StringRef target_triple,
                      llvm::raw_pwrite_stream& errors) -> std::optional<CodeGen>;
 
+  // Creates a code generator that uses an existing target machine, which must
+  // outlive it. This lets callers that compile many modules for the same
+  // target create the target machine once.
+  static auto Create(llvm::Module& module, llvm::TargetMachine& target_machine,
+                     llvm::raw_pwrite_stream& errors) -> CodeGen;
+
+  // Creates a target machine for `target_triple`. Returns null and prints an
+  // error to `errors` if the target is invalid.
+  static auto CreateTargetMachine(llvm::StringRef target_triple,
+                                  llvm::raw_pwrite_stream& errors)
+      -> std::unique_ptr<llvm::TargetMachine>;
+
   // Generates the object code file.
   // Returns false in case of failure, and any information about the failure is
   // printed to the error stream.
@@ -29,9 +42,21 @@ class CodeGen {
   // patching the output.
   auto EmitAssembly(llvm::raw_pwrite_stream& out) -> bool;
 
+  // Writes the module as LLVM bitcode, without running the backend.
+  // Returns false in case of failure, and any information about the failure is
+  // printed to the error stream.
+  auto EmitBitcode(llvm::raw_pwrite_stream& out) -> bool;
+
+  // Writes the module as LLVM bitcode with a ThinLTO module summary, so that
+  // it can take part in a ThinLTO link alongside other languages' bitcode.
+  // Returns false in case of failure, and any information about the failure is
+  // printed to the error stream.
+  auto EmitThinLTOBitcode(llvm::raw_pwrite_stream& out) -> bool;
+
  private:
-  explicit CodeGen(llvm::Module& module, llvm::raw_pwrite_stream& errors)
-      : module_(module), errors_(errors) {}
+  explicit CodeGen(llvm::Module& module, llvm::TargetMachine& target_machine,
+                   llvm::raw_pwrite_stream& errors)
+      : module_(module), errors_(errors), target_machine_(&target_machine) {}
 
   // Using the llvm pass emits either assembly or object code to dest.
   // Returns false in case of failure, and any information about the failure is
@@ -41,7 +66,9 @@ class CodeGen {
 
   llvm::Module& module_;
   llvm::raw_pwrite_stream& errors_;
-  std::unique_ptr<llvm::TargetMachine> target_machine_;
+  // Set when the code generator created its own target machine.
+  std::unique_ptr<llvm::TargetMachine> owned_target_machine_;
+  llvm::TargetMachine* target_machine_;
 };
 
 }  // namespace Cocktail
@@ -0,0 +1,23 @@
+#ifndef COCKTAIL_CODEGEN_TARGETS_H
+#define COCKTAIL_CODEGEN_TARGETS_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace Cocktail {
+
+// Returns the names of the LLVM backends compiled into the toolchain, as
+// listed in Backends.def.
+auto GetCompiledInBackends() -> llvm::ArrayRef<llvm::StringLiteral>;
+
+// Initializes the LLVM backend for the architecture of `target_triple`. Each
+// backend is initialized at most once per process, and only when a triple
+// needs it. Returns false and prints an error to `errors` if no compiled-in
+// backend handles the triple.
+auto InitializeTargetForTriple(llvm::StringRef target_triple,
+                               llvm::raw_ostream& errors) -> bool;
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_CODEGEN_TARGETS_H
@@ -19,6 +19,8 @@
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Allocator.h"
+#include "llvm/Support/StringSaver.h"
+#include "llvm/Support/VirtualFileSystem.h"
 
 // # Command-line argument parsing library.
 //
@@ -665,6 +667,20 @@ auto Parse(llvm::ArrayRef<llvm::StringRef> unparsed_args,
            const CommandInfo& command_info,
            llvm::function_ref<void(CommandBuilder&)> build) -> ParseResult;
 
+// Expands `@FILE` response-file arguments ahead of `Parse`.
+//
+// Each `@FILE` argument is replaced by the arguments held in `FILE`, which are
+// split the way a GNU-style shell splits a command line, and may themselves
+// include further `@FILE` arguments. All other arguments are passed through
+// unchanged. The result is appended to `expanded_args`; strings read from
+// response files are allocated in `saver`, which must outlive any use of the
+// parsed arguments. Returns false and prints to `errors` if a response file
+// can't be read or response files nest too deeply.
+auto ExpandResponseFiles(llvm::ArrayRef<llvm::StringRef> args,
+                         llvm::vfs::FileSystem& fs, llvm::StringSaver& saver,
+                         llvm::SmallVectorImpl<llvm::StringRef>& expanded_args,
+                         llvm::raw_ostream& errors) -> bool;
+
 // Implementation details only below.
 
 // The internal representation of a parsable argument description.
@@ -1,16 +1,23 @@
 #ifndef COCKTAIL_DIAGNOSTICS_DIAGNOSTIC_EMITTER_H
 #define COCKTAIL_DIAGNOSTICS_DIAGNOSTIC_EMITTER_H
 
-#include <functional>
+#include <cstdint>
+#include <memory>
+#include <new>
 #include <string>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 #include "Cocktail/Common/Check.h"
 #include "Cocktail/Diagnostics/DiagnosticKind.h"
-#include "llvm/ADT/Any.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/APSInt.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -41,28 +48,58 @@ struct DiagnosticLocation {
   int32_t column_number;
 };
 
+/// 延迟解析的诊断位置。
+///
+/// 保存一个在诊断被消费之前始终有效的上下文（例如源缓冲区）和上下文中的偏移量，
+/// 只有在输出诊断时才计算文件名、行号、列号和行文本。
+struct DeferredDiagnosticLocation {
+  // 解析出完整的诊断位置。
+  auto Resolve() const -> DiagnosticLocation {
+    return resolve_fn(context, offset);
+  }
+
+  // 解析位置所需的上下文。
+  const void* context;
+  // 位置在上下文中的偏移量，例如源缓冲区中的字节偏移量。来自同一转换器的
+  // 诊断可以按偏移量排序。
+  int64_t offset;
+  // 根据上下文和偏移量解析位置的函数。
+  auto (*resolve_fn)(const void* context, int64_t offset) -> DiagnosticLocation;
+};
+
+/// 诊断参数的存储区域，由诊断消费者持有。
+///
+/// 参数在构建诊断时写入，并一直保留到持有它的消费者被刷新为止，因此诊断本身
+/// 不需要为参数单独分配堆内存。
+using DiagnosticArena = llvm::BumpPtrAllocator;
+
 /// 用于表示一个诊断消息。
+///
+/// 消息只保存格式字符串和指向 arena 中参数的指针，格式化被推迟到消费者真正
+/// 需要输出文本时，通过 Format 或 FormatTo 完成。
 struct DiagnosticMessage {
-  explicit DiagnosticMessage(
-      DiagnosticKind kind, DiagnosticLocation location,
-      llvm::StringLiteral format, llvm::SmallVector<llvm::Any> format_args,
-      std::function<std::string(const DiagnosticMessage&)> format_fn)
-      : kind(kind),
-        location(location),
-        format(format),
-        format_args(std::move(format_args)),
-        format_fn(std::move(format_fn)) {}
+  // 格式化消息文本。
+  auto Format() const -> std::string {
+    std::string result;
+    llvm::raw_string_ostream out(result);
+    FormatTo(out);
+    return result;
+  }
+
+  // 将消息文本直接格式化到输出流中，不构造中间字符串。
+  auto FormatTo(llvm::raw_ostream& out) const -> void { format_fn(*this, out); }
 
   // 诊断类型。
   DiagnosticKind kind;
-  // 诊断位置。
-  DiagnosticLocation location;
-  // 诊断的格式字符串。这将与format_args一起传递给format_fn。
+  // 诊断位置，在需要时通过 location.Resolve() 解析。
+  DeferredDiagnosticLocation location;
+  // 诊断的格式字符串。
   llvm::StringLiteral format;
-  // 格式化参数列表。
-  llvm::SmallVector<llvm::Any> format_args;
-  // 返回格式化字符串。默认情况下使用llvm::formatv。
-  std::function<std::string(const DiagnosticMessage&)> format_fn;
+  // 指向 arena 中按类型存储的格式化参数；没有参数时为空。
+  const void* format_args;
+  // 使用 format_args 格式化 format 并写入输出流的函数。
+  auto (*format_fn)(const DiagnosticMessage& message, llvm::raw_ostream& out)
+      -> void;
 };
 
 /// 用于表示一个完整的诊断，包括级别、主消息和附加注释。
@@ -80,15 +117,30 @@ class DiagnosticConsumer {
  public:
   virtual ~DiagnosticConsumer() = default;
 
+  // 返回用于存储发往此消费者的诊断参数的 arena。只转发诊断的消费者应返回
+  // 下一个消费者的 arena，以便由最终持有诊断的消费者决定参数的生命周期。
+  virtual auto arena() -> DiagnosticArena& { return arena_; }
+
   // 用于处理一个诊断（错误、警告或注释）。
   //
-  // 诊断对象目前是在栈上分配的，因此它们的生命周期是`HandleDiagnostic`函数的生命周期。
+  // 诊断对象按值传递，其格式化参数存储在`arena()`中，直到该消费者被刷新。
   // `SortingDiagnosticConsumer`类需要更长的诊断对象生命周期，直到所有诊断信息已生成。
   // 目前没有持久地存储诊断，因为在集成开发环境（IDE）中，通常是立即打印并丢弃诊断。
   virtual auto HandleDiagnostic(Diagnostic diagnostic) -> void = 0;
 
   // 用于刷新任何缓冲的输入。
   virtual auto Flush() -> void {}
+
+  // 返回产生诊断的阶段是否应尽早停止，例如错误数量已经达到上限。阶段在停止时
+  // 会将结果标记为有错误。只转发诊断的消费者应询问下一个消费者。
+  virtual auto ShouldStop() const -> bool { return false; }
+
+ protected:
+  // 释放 arena 中的所有参数。只能在不再持有任何诊断时调用。
+  auto ResetArena() -> void { arena_.Reset(); }
+
+ private:
+  DiagnosticArena arena_;
 };
 
 /// 可以将某个位置的某种表示形式转换为诊断位置的接口。
@@ -99,19 +151,111 @@ class DiagnosticLocationTranslator {
 
   [[nodiscard]] virtual auto GetLocation(LocationT loc)
       -> DiagnosticLocation = 0;
+
+  // 返回一个延迟解析的位置。默认实现立即调用 GetLocation 并将结果保存在 arena
+  // 中，偏移量按行号和列号编码。能够在诊断生命周期内定位源代码的转换器应重写
+  // 此函数，以免在诊断不被输出时计算行列信息。
+  [[nodiscard]] virtual auto GetDeferredLocation(DiagnosticArena& arena,
+                                                 LocationT loc)
+      -> DeferredDiagnosticLocation {
+    auto* location = new (arena.Allocate<DiagnosticLocation>())
+        DiagnosticLocation(GetLocation(loc));
+    return {.context = location,
+            .offset = (static_cast<int64_t>(location->line_number) << 32) +
+                      location->column_number,
+            .resolve_fn = [](const void* context, int64_t /*offset*/) {
+              return *static_cast<const DiagnosticLocation*>(context);
+            }};
+  }
 };
 
 namespace Internal {
 
+// 禁用基于' args '的类型推导。
+template <typename Arg>
+using NoTypeDeduction = std::common_type_t<Arg>;
+
+// 描述诊断参数在 arena 中的存储方式。arena 不会运行析构函数，因此存储类型
+// 必须是平凡可析构的。
+template <typename Arg>
+struct DiagnosticArgStorage {
+  using Type = Arg;
+  static_assert(std::is_trivially_destructible_v<Type>,
+                "Diagnostic arguments must be trivially destructible");
+
+  static auto Store(DiagnosticArena& /*arena*/, const Arg& arg) -> Type {
+    return arg;
+  }
+};
+
+// 将`text`复制到 arena 中，返回指向副本的 StringRef。
+inline auto CopyToArena(DiagnosticArena& arena, llvm::StringRef text)
+    -> llvm::StringRef {
+  char* storage = arena.Allocate<char>(text.size());
+  std::uninitialized_copy(text.begin(), text.end(), storage);
+  return llvm::StringRef(storage, text.size());
+}
+
+// 字符串参数被复制到 arena 中，并以 StringRef 的形式保存。
+template <>
+struct DiagnosticArgStorage<std::string> {
+  using Type = llvm::StringRef;
+
+  static auto Store(DiagnosticArena& arena, const std::string& arg) -> Type {
+    return CopyToArena(arena, arg);
+  }
+};
+
+// 位宽较大的整数会在堆上保存数据，因此整数参数以十进制文本的形式存入 arena，
+// 与 raw_ostream 输出的格式相同：APInt 按有符号数输出。
+template <>
+struct DiagnosticArgStorage<llvm::APInt> {
+  using Type = llvm::StringRef;
+
+  static auto Store(DiagnosticArena& arena, const llvm::APInt& arg) -> Type {
+    llvm::SmallString<32> text;
+    arg.toString(text, /*Radix=*/10, /*Signed=*/true);
+    return CopyToArena(arena, text);
+  }
+};
+
+// APSInt 按其自身的符号性输出。
+template <>
+struct DiagnosticArgStorage<llvm::APSInt> {
+  using Type = llvm::StringRef;
+
+  static auto Store(DiagnosticArena& arena, const llvm::APSInt& arg) -> Type {
+    llvm::SmallString<32> text;
+    arg.toString(text, /*Radix=*/10);
+    return CopyToArena(arena, text);
+  }
+};
+
 template <typename... Args>
 struct DiagnosticBase {
+  // 参数在 arena 中的存储布局。
+  using ArgsStorage = std::tuple<typename DiagnosticArgStorage<Args>::Type...>;
+
   explicit constexpr DiagnosticBase(DiagnosticKind kind, DiagnosticLevel level,
                                     llvm::StringLiteral format)
       : Kind(kind), Level(level), Format(format) {}
 
+  // 将参数存储到 arena 中，返回的指针用作 DiagnosticMessage::format_args。
+  static auto StoreArgs(DiagnosticArena& arena,
+                        NoTypeDeduction<Args>... args) -> const void* {
+    if constexpr (sizeof...(Args) == 0) {
+      return nullptr;
+    } else {
+      auto* storage = arena.Allocate<ArgsStorage>();
+      return new (storage)
+          ArgsStorage(DiagnosticArgStorage<Args>::Store(arena, args)...);
+    }
+  }
+
   // 使用诊断参数调用formatv。
-  auto FormatFn(const DiagnosticMessage& message) const -> std::string {
-    return FormatFnImpl(message, std::make_index_sequence<sizeof...(Args)>());
+  static auto FormatFn(const DiagnosticMessage& message,
+                       llvm::raw_ostream& out) -> void {
+    FormatFnImpl(message, out, std::make_index_sequence<sizeof...(Args)>());
   };
 
   // 诊断类型。
@@ -122,21 +266,21 @@ struct DiagnosticBase {
   llvm::StringLiteral Format;
 
  private:
-  // 处理llvm::Any转换为formatv的Args类型。
+  // 从 arena 中取出参数并传给formatv。
   template <std::size_t... N>
-  inline auto FormatFnImpl(const DiagnosticMessage& message,
-                           std::index_sequence<N...> /*indices*/) const
-      -> std::string {
-    assert(message.format_args.size() == sizeof...(Args));
-    return llvm::formatv(message.format.data(),
-                         llvm::any_cast<Args>(message.format_args[N])...);
+  static auto FormatFnImpl(const DiagnosticMessage& message,
+                           llvm::raw_ostream& out,
+                           std::index_sequence<N...> /*indices*/) -> void {
+    if constexpr (sizeof...(Args) == 0) {
+      out << llvm::formatv(message.format.data());
+    } else {
+      const auto& args =
+          *static_cast<const ArgsStorage*>(message.format_args);
+      out << llvm::formatv(message.format.data(), std::get<N>(args)...);
+    }
   }
 };
 
-// 禁用基于' args '的类型推导。
-template <typename Arg>
-using NoTypeDeduction = std::common_type_t<Arg>;
-
 }  // namespace Internal
 
 template <typename LocationT, typename AnnotateFn>
@@ -163,8 +307,8 @@ class DiagnosticEmitter {
               Internal::NoTypeDeduction<Args>... args) -> DiagnosticBuilder& {
       COCKTAIL_CHECK(diagnostic_base.Level == DiagnosticLevel::Note)
           << static_cast<int>(diagnostic_base.Level);
-      diagnostic_.notes.push_back(MakeMessage(
-          emitter_, location, diagnostic_base, {llvm::Any(args)...}));
+      diagnostic_.notes.push_back(
+          MakeMessage(emitter_, location, diagnostic_base, args...));
       return *this;
     }
 
@@ -184,26 +328,27 @@ class DiagnosticEmitter {
     explicit DiagnosticBuilder(
         DiagnosticEmitter<LocationT>* emitter, LocationT location,
         const Internal::DiagnosticBase<Args...>& diagnostic_base,
-        llvm::SmallVector<llvm::Any> args)
+        Internal::NoTypeDeduction<Args>... args)
         : emitter_(emitter),
-          diagnostic_(
-              {.level = diagnostic_base.Level,
-               .message = MakeMessage(emitter, location, diagnostic_base,
-                                      std::move(args))}) {
+          diagnostic_({.level = diagnostic_base.Level,
+                       .message = MakeMessage(emitter, location,
+                                              diagnostic_base, args...)}) {
       COCKTAIL_CHECK(diagnostic_base.Level != DiagnosticLevel::Note);
     }
 
+    // 构建一条消息。参数存储在消费者的 arena 中，格式化推迟到输出时进行。
     template <typename... Args>
     static auto MakeMessage(
         DiagnosticEmitter<LocationT>* emitter, LocationT location,
         const Internal::DiagnosticBase<Args...>& diagnostic_base,
-        llvm::SmallVector<llvm::Any> args) -> DiagnosticMessage {
-      return DiagnosticMessage(
-          diagnostic_base.Kind, emitter->translator_->GetLocation(location),
-          diagnostic_base.Format, std::move(args),
-          [&diagnostic_base](const DiagnosticMessage& message) -> std::string {
-            return diagnostic_base.FormatFn(message);
-          });
+        Internal::NoTypeDeduction<Args>... args) -> DiagnosticMessage {
+      return {.kind = diagnostic_base.Kind,
+              .location = emitter->translator_->GetDeferredLocation(
+                  emitter->consumer_->arena(), location),
+              .format = diagnostic_base.Format,
+              .format_args = Internal::DiagnosticBase<Args...>::StoreArgs(
+                  emitter->consumer_->arena(), args...),
+              .format_fn = &Internal::DiagnosticBase<Args...>::FormatFn};
     }
 
     DiagnosticEmitter<LocationT>* emitter_;
@@ -221,8 +366,7 @@ class DiagnosticEmitter {
   auto Emit(LocationT location,
             const Internal::DiagnosticBase<Args...>& diagnostic_base,
             Internal::NoTypeDeduction<Args>... args) -> void {
-    DiagnosticBuilder(this, location, diagnostic_base, {llvm::Any(args)...})
-        .Emit();
+    DiagnosticBuilder(this, location, diagnostic_base, args...).Emit();
   }
 
   // 返回一个`DiagnosticBuilder`对象，允许你构建一个更复杂的诊断。
@@ -230,8 +374,7 @@ class DiagnosticEmitter {
   auto Build(LocationT location,
              const Internal::DiagnosticBase<Args...>& diagnostic_base,
              Internal::NoTypeDeduction<Args>... args) -> DiagnosticBuilder {
-    return DiagnosticBuilder(this, location, diagnostic_base,
-                             {llvm::Any(args)...});
+    return DiagnosticBuilder(this, location, diagnostic_base, args...);
   }
 
  private:
@@ -280,18 +423,25 @@ class StreamDiagnosticConsumer : public DiagnosticConsumer {
       Print(note);
     }
   }
+
+  // 诊断在处理时已经输出，因此刷新时可以释放它们的参数。
+  auto Flush() -> void override { ResetArena(); }
+
   auto Print(const DiagnosticMessage& message) -> void {
-    *stream_ << message.location.file_name;
-    if (message.location.line_number > 0) {
-      *stream_ << ":" << message.location.line_number;
-      if (message.location.column_number > 0) {
-        *stream_ << ":" << message.location.column_number;
+    auto location = message.location.Resolve();
+    *stream_ << location.file_name;
+    if (location.line_number > 0) {
+      *stream_ << ":" << location.line_number;
+      if (location.column_number > 0) {
+        *stream_ << ":" << location.column_number;
       }
     }
-    *stream_ << ": " << message.format_fn(message) << "\n";
-    if (message.location.column_number > 0) {
-      *stream_ << message.location.line << "\n";
-      stream_->indent(message.location.column_number - 1);
+    *stream_ << ": ";
+    message.FormatTo(*stream_);
+    *stream_ << "\n";
+    if (location.column_number > 0) {
+      *stream_ << location.line << "\n";
+      stream_->indent(location.column_number - 1);
       *stream_ << "^\n";
     }
   }
@@ -311,12 +461,19 @@ class ErrorTrackingDiagnosticConsumer : public DiagnosticConsumer {
   explicit ErrorTrackingDiagnosticConsumer(DiagnosticConsumer& next_consumer)
       : next_consumer_(&next_consumer) {}
 
+  // 只转发诊断，因此参数由下一个消费者持有。
+  auto arena() -> DiagnosticArena& override { return next_consumer_->arena(); }
+
   // 处理一个诊断，并检查是否有错误。
   auto HandleDiagnostic(Diagnostic diagnostic) -> void override {
     seen_error_ |= diagnostic.level == DiagnosticLevel::Error;
     next_consumer_->HandleDiagnostic(std::move(diagnostic));
   }
 
+  auto ShouldStop() const -> bool override {
+    return next_consumer_->ShouldStop();
+  }
+
   // 重置错误跟踪状态。
   auto Reset() -> void { seen_error_ = false; }
 
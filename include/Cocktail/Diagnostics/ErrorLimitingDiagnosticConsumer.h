@@ -0,0 +1,61 @@
+#ifndef COCKTAIL_DIAGNOSTICS_ERROR_LIMITING_DIAGNOSTIC_CONSUMER_H
+#define COCKTAIL_DIAGNOSTICS_ERROR_LIMITING_DIAGNOSTIC_CONSUMER_H
+
+#include <cstdint>
+
+#include "Cocktail/Diagnostics/DiagnosticEmitter.h"
+
+namespace Cocktail {
+
+/// 限制转发的错误数量。
+///
+/// 在转发了 error_limit 个错误之后，丢弃之后的所有诊断，并通过 ShouldStop
+/// 通知正在运行的阶段尽早停止。这样错误极多的输入不会让下游消费者缓冲全部诊断，
+/// 也不会让各个阶段一直运行到文件末尾。
+class ErrorLimitingDiagnosticConsumer : public DiagnosticConsumer {
+ public:
+  // error_limit 为 0 表示不限制错误数量。
+  explicit ErrorLimitingDiagnosticConsumer(DiagnosticConsumer& next_consumer,
+                                           int32_t error_limit)
+      : next_consumer_(&next_consumer), error_limit_(error_limit) {}
+
+  // 只转发诊断，因此参数由下一个消费者持有。
+  auto arena() -> DiagnosticArena& override { return next_consumer_->arena(); }
+
+  auto HandleDiagnostic(Diagnostic diagnostic) -> void override {
+    if (limit_reached()) {
+      ++dropped_count_;
+      return;
+    }
+    error_count_ += diagnostic.level == DiagnosticLevel::Error;
+    next_consumer_->HandleDiagnostic(std::move(diagnostic));
+  }
+
+  auto Flush() -> void override { next_consumer_->Flush(); }
+
+  // 达到错误上限之后，要求产生诊断的阶段停止。
+  auto ShouldStop() const -> bool override {
+    return limit_reached() || next_consumer_->ShouldStop();
+  }
+
+  // 返回是否已经转发了 error_limit 个错误。
+  auto limit_reached() const -> bool {
+    return error_limit_ > 0 && error_count_ >= error_limit_;
+  }
+
+  // 返回已转发的错误数量。
+  auto error_count() const -> int32_t { return error_count_; }
+
+  // 返回达到上限之后被丢弃的诊断数量。
+  auto dropped_count() const -> int64_t { return dropped_count_; }
+
+ private:
+  DiagnosticConsumer* next_consumer_;
+  int32_t error_limit_;
+  int32_t error_count_ = 0;
+  int64_t dropped_count_ = 0;
+};
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_DIAGNOSTICS_ERROR_LIMITING_DIAGNOSTIC_CONSUMER_H
@@ -21,6 +21,7 @@ inline auto NullDiagnosticLocationTranslator()
 inline auto NullDiagnosticConsumer() -> DiagnosticConsumer& {
   struct Consumer : DiagnosticConsumer {
     auto HandleDiagnostic(Diagnostic /*unused*/) -> void override {}
+    auto Flush() -> void override { ResetArena(); }
   };
   static auto* consumer = new Consumer();
   return *consumer;
@@ -27,19 +27,23 @@ class SortingDiagnosticConsumer : public DiagnosticConsumer {
 
   // Flush负责对缓冲的诊断信息进行排序和输出。
   void Flush() override {
-    // 依据诊断信息中的位置信息（行号和列号）排序。
+    // 依据诊断信息中的位置偏移量排序，无需解析行号和列号。
     llvm::stable_sort(diagnostics_,
                       [](const Diagnostic& lhs, const Diagnostic& rhs) {
-                        return std::tie(lhs.message.location.line_number,
-                                        lhs.message.location.column_number) <
-                               std::tie(rhs.message.location.line_number,
-                                        rhs.message.location.column_number);
+                        return lhs.message.location.offset <
+                               rhs.message.location.offset;
                       });
     // 责任链机制，确定了下一个处理者是谁。
     for (auto& diag : diagnostics_) {
       next_consumer_->HandleDiagnostic(std::move(diag));
     }
     diagnostics_.clear();
+    // 下一个消费者已经处理完这些诊断，可以释放它们的参数。
+    ResetArena();
+  }
+
+  auto ShouldStop() const -> bool override {
+    return next_consumer_->ShouldStop();
   }
 
  private:
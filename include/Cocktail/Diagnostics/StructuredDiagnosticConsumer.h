@@ -0,0 +1,49 @@
+#ifndef COCKTAIL_DIAGNOSTICS_STRUCTURED_DIAGNOSTIC_CONSUMER_H
+#define COCKTAIL_DIAGNOSTICS_STRUCTURED_DIAGNOSTIC_CONSUMER_H
+
+#include "Cocktail/Diagnostics/DiagnosticEmitter.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace Cocktail {
+
+/// 以 JSON Lines 格式输出诊断，每个诊断占一行。
+///
+/// 每条记录包含诊断类型名、级别、文件、行号、列号、消息文本以及注释，各字段
+/// 直接写入输出流，不为单个字段构造中间字符串。
+class JsonLinesDiagnosticConsumer : public DiagnosticConsumer {
+ public:
+  explicit JsonLinesDiagnosticConsumer(llvm::raw_ostream& stream)
+      : stream_(&stream) {}
+
+  auto HandleDiagnostic(Diagnostic diagnostic) -> void override;
+
+  // 诊断在处理时已经输出，因此刷新时写出缓冲并释放它们的参数。
+  auto Flush() -> void override;
+
+ private:
+  llvm::raw_ostream* stream_;
+};
+
+/// 以 SARIF 2.1.0 格式输出诊断。
+///
+/// 文档头在构造时写出，每个诊断作为一个 result 追加，文档在析构时闭合，因此
+/// 整个编译过程应共用一个该消费者。
+class SarifDiagnosticConsumer : public DiagnosticConsumer {
+ public:
+  explicit SarifDiagnosticConsumer(llvm::raw_ostream& stream);
+  ~SarifDiagnosticConsumer() override;
+
+  auto HandleDiagnostic(Diagnostic diagnostic) -> void override;
+
+  // 诊断在处理时已经输出，因此刷新时写出缓冲并释放它们的参数。
+  auto Flush() -> void override;
+
+ private:
+  llvm::raw_ostream* stream_;
+  // 是否已经输出过 result，用于决定是否需要逗号分隔。
+  bool has_results_ = false;
+};
+
+}  // namespace Cocktail
+
+#endif  // COCKTAIL_DIAGNOSTICS_STRUCTURED_DIAGNOSTIC_CONSUMER_H
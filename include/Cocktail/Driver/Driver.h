@@ -2,15 +2,31 @@
 #define COCKTAIL_DRIVER_DRIVER_H
 
 #include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
 
 #include "Cocktail/Common/CommandLine.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/StringSaver.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/Support/raw_ostream.h"
 
+namespace llvm {
+class TargetMachine;
+}  // namespace llvm
+
 namespace Cocktail {
 
+class DiagnosticConsumer;
+
+namespace SemIR {
+class File;
+}  // namespace SemIR
+
 // Command line interface driver.
 //
 // Provides simple API to parse and run command lines for Carbon.  It is
@@ -21,10 +37,8 @@ class Driver {
   // Constructs a driver with any error or informational output directed to a
   // specified stream.
   Driver(llvm::vfs::FileSystem& fs, llvm::raw_pwrite_stream& output_stream,
-         llvm::raw_pwrite_stream& error_stream)
-      : fs_(fs), output_stream_(output_stream), error_stream_(error_stream) {
-    (void)fs_;
-  }
+         llvm::raw_pwrite_stream& error_stream);
+  ~Driver();
 
   // Parses the given arguments into both a subcommand to select the operation
   // to perform and any arguments to that subcommand.
@@ -34,27 +48,85 @@ class Driver {
   // error stream (stderr by default).
   auto RunCommand(llvm::ArrayRef<llvm::StringRef> args) -> bool;
 
+  // Runs one command per line read from `requests`, until the end of the
+  // stream. Each line holds the arguments to `RunCommand`, tokenized as by a
+  // GNU shell so that quoted arguments may contain spaces. After each command,
+  // a status line of `serve: ok` or `serve: failed` is written to the output
+  // stream and both streams are flushed. State that doesn't depend on the
+  // inputs, such as the builtins and target machines, is kept between commands.
+  //
+  // Returns false if any command failed.
+  auto Serve(std::istream& requests) -> bool;
+
  private:
   struct Options;
   struct CompileOptions;
+  struct ServeOptions;
   class CompilationUnit;
 
   // Delegates to the command line library to parse the arguments and store the
   // results in a custom `Options` structure that the rest of the driver uses.
-  auto ParseArgs(llvm::ArrayRef<llvm::StringRef> args, Options& options)
+  // Response files are expanded first, with their arguments stored in
+  // `arg_saver`.
+  auto ParseArgs(llvm::ArrayRef<llvm::StringRef> args,
+                 llvm::StringSaver& arg_saver, Options& options)
       -> CommandLine::ParseResult;
 
   // Does custom validation of the compile-subcommand options structure beyond
   // what the command line parsing library supports.
   auto ValidateCompileOptions(const CompileOptions& options) const -> bool;
 
+  // Calls `fn` with the path of each `*.cocktail` file under `dir`, as the
+  // directory is searched. The entries of each directory are visited in sorted
+  // order, so the order doesn't depend on the file system. Returns false and
+  // reports an error to `consumer` if the search fails or finds no inputs.
+  auto ForEachInputInDirectory(llvm::StringRef dir,
+                               DiagnosticConsumer& consumer,
+                               llvm::function_ref<void(llvm::StringRef)> fn)
+      -> bool;
+
+  // Returns whether the lex, parse and check phases can run as a pipeline for
+  // these options.
+  auto CanPipelineFrontEnd(const CompileOptions& options) const -> bool;
+
+  // Runs lex, parse and, unless stopping after parse, check as pipelined
+  // stages on their own threads, connected by bounded queues. Units are
+  // created by `add_unit` as `for_each_input` finds them, move to the next
+  // stage as soon as the previous one is done, and free their front-end data
+  // once checked. Returns true if every phase succeeded for every unit.
+  auto RunFrontEndPipeline(
+      const CompileOptions& options,
+      llvm::function_ref<bool(llvm::function_ref<void(llvm::StringRef)>)>
+          for_each_input,
+      llvm::function_ref<CompilationUnit&(llvm::StringRef)> add_unit) -> bool;
+
   // Implements the compile subcommand of the driver.
   auto Compile(const CompileOptions& options) -> bool;
 
+  // Returns the builtins, which are created on first use and then reused for
+  // the lifetime of the driver.
+  auto GetBuiltins() -> const SemIR::File&;
+
+  // Returns the target machine for `target_triple`, which is created on first
+  // use and then reused for the lifetime of the driver. Returns null and
+  // prints an error to `errors` if the target is invalid.
+  auto GetTargetMachine(llvm::StringRef target_triple,
+                        llvm::raw_pwrite_stream& errors)
+      -> llvm::TargetMachine*;
+
   llvm::vfs::FileSystem& fs_;
   llvm::raw_pwrite_stream& output_stream_;
   llvm::raw_pwrite_stream& error_stream_;
   llvm::raw_pwrite_stream* vlog_stream_ = nullptr;
+
+  // Whether `Serve` is running, in which case a `serve` command is rejected.
+  bool serving_ = false;
+
+  std::unique_ptr<SemIR::File> builtins_;
+  llvm::StringMap<std::unique_ptr<llvm::TargetMachine>> target_machines_;
+
+  // Serializes diagnostic output while units run on different threads.
+  std::mutex diagnostics_mutex_;
 };
 
 }  // namespace Cocktail
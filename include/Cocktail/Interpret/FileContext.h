@@ -0,0 +1,165 @@
+#ifndef COCKTAIL_INTERPRET_FILE_CONTEXT_H
+#define COCKTAIL_INTERPRET_FILE_CONTEXT_H
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "Cocktail/Interpret/Interpret.h"
+#include "Cocktail/SemIR/File.h"
+#include "Cocktail/SemIR/IdRangeMap.h"
+#include "Cocktail/SemIR/Node.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Twine.h"
+
+namespace Cocktail::Interpret {
+
+// How the objects of a type are laid out in the interpreter's memory.
+struct TypeLayout {
+  enum class Kind : int8_t {
+    // A type with no storage, such as `type` or an empty tuple.
+    Empty,
+    // A single cell, holding an integer, bool, real or pointer.
+    Scalar,
+    // A struct or tuple, with elements at `element_offsets`.
+    Aggregate,
+    // An array of `bound` elements of type `element_type_id`.
+    Array,
+  };
+
+  Kind kind = Kind::Empty;
+  // The number of cells an object takes.
+  int32_t size = 0;
+  // For aggregates, the offset and type of each element.
+  llvm::SmallVector<int32_t, 0> element_offsets;
+  llvm::SmallVector<SemIR::TypeId, 0> element_type_ids;
+  // For arrays, the element type and count.
+  SemIR::TypeId element_type_id = SemIR::TypeId::Invalid;
+  int32_t bound = 0;
+};
+
+// Context and shared functionality for interpreting handlers: memory, type
+// layouts and constants, and the bookkeeping for limits and failure.
+class FileContext {
+ public:
+  explicit FileContext(const SemIR::File& semantics_ir, const Limits& limits,
+                       llvm::raw_ostream* vlog_stream);
+
+  // Calls `function_id` with `args`, one per parameter, and `return_slot`,
+  // which is the address of the storage for the result if the function has
+  // a return slot. Returns the function's return value, or an invalid value
+  // on failure.
+  auto CallFunction(SemIR::FunctionId function_id, llvm::ArrayRef<Value> args,
+                    Value return_slot) -> Value;
+
+  // Returns the value of the canonical constant node `constant_id`, as
+  // recorded in the SemIR constant table.
+  auto GetConstant(SemIR::NodeId constant_id) -> Value;
+
+  // Returns the ranges of node and block IDs in the definition of
+  // `function_id`, which size each call's locals.
+  auto GetFunctionIdRanges(SemIR::FunctionId function_id)
+      -> const SemIR::FunctionIdRanges&;
+
+  // Returns the layout of objects of type `type_id`.
+  auto GetLayout(SemIR::TypeId type_id) -> const TypeLayout&;
+
+  // Allocates uninitialized storage for an object of type `type_id` on the
+  // stack, and returns its address.
+  auto Allocate(SemIR::TypeId type_id) -> int32_t;
+
+  // Returns the current top of the stack, and frees everything allocated
+  // after `top`.
+  auto stack_top() const -> int32_t { return memory_.size(); }
+  auto FreeStack(int32_t top) -> void { memory_.truncate(top); }
+
+  // Reads the value of type `type_id` from the object at `pointer`, in its
+  // value representation. For a pointer value representation, this is the
+  // address itself.
+  auto LoadValue(SemIR::TypeId type_id, Value pointer) -> Value;
+
+  // Stores `value`, which is in the value representation of `type_id`, to the
+  // object at `pointer`.
+  auto StoreValue(SemIR::TypeId type_id, Value value, Value pointer) -> void;
+
+  // Counts a step, and fails if that exceeds the limit. Returns false once
+  // interpretation has failed.
+  auto Step() -> bool {
+    if (failed()) {
+      return false;
+    }
+    if (++steps_ == limits_.max_steps) {
+      Fail(llvm::Twine("Exceeded the limit of ") +
+           llvm::Twine(limits_.max_steps) + " steps");
+      return false;
+    }
+    return true;
+  }
+
+  // Records that interpretation failed, with `message` explaining why. Only
+  // the first failure is kept; everything after it is a consequence.
+  auto Fail(const llvm::Twine& message) -> void {
+    if (!failed_) {
+      failed_ = true;
+      error_message_ = message.str();
+    }
+  }
+
+  auto failed() const -> bool { return failed_; }
+  auto error_message() const -> const std::string& { return error_message_; }
+  auto semantics_ir() -> const SemIR::File& { return *semantics_ir_; }
+
+ private:
+  // Addresses at or after this refer to `constant_memory_`. Constants stay
+  // alive for the whole run, while the stack is popped on each return.
+  static constexpr int32_t ConstantBase = 1 << 30;
+
+  // Returns the `size` cells starting at `address`, or fails and returns an
+  // empty range if they aren't all allocated.
+  auto GetCells(int32_t address, int32_t size) -> llvm::MutableArrayRef<Value>;
+
+  // Builds the layout for the given type, which should then be cached by the
+  // caller.
+  auto BuildLayout(SemIR::TypeId type_id) -> TypeLayout;
+
+  // Builds the value for the given canonical constant node, which should then
+  // be cached by the caller.
+  auto BuildConstant(SemIR::NodeId constant_id) -> Value;
+
+  // The input SemIR.
+  const SemIR::File* const semantics_ir_;
+
+  const Limits limits_;
+
+  // The optional vlog stream.
+  llvm::raw_ostream* vlog_stream_;
+
+  // The stack, holding all objects of the functions that are running.
+  llvm::SmallVector<Value> memory_;
+
+  // Objects for aggregate constants that are held by pointer.
+  llvm::SmallVector<Value> constant_memory_;
+
+  // Provides layouts of types, indexed by type ID. A null entry hasn't been
+  // built yet.
+  llvm::SmallVector<std::unique_ptr<TypeLayout>> layouts_;
+
+  // Provides the ID ranges of functions that have been called, indexed by
+  // function ID.
+  llvm::SmallVector<std::optional<SemIR::FunctionIdRanges>>
+      function_id_ranges_;
+
+  // Provides values of constants, keyed by canonical constant node.
+  llvm::DenseMap<SemIR::NodeId, Value> constants_;
+
+  int64_t steps_ = 0;
+  int call_depth_ = 0;
+
+  bool failed_ = false;
+  std::string error_message_;
+};
+
+}  // namespace Cocktail::Interpret
+
+#endif  // COCKTAIL_INTERPRET_FILE_CONTEXT_H
@@ -0,0 +1,135 @@
+#ifndef COCKTAIL_INTERPRET_FUNCTION_CONTEXT_H
+#define COCKTAIL_INTERPRET_FUNCTION_CONTEXT_H
+
+#include "Cocktail/Interpret/FileContext.h"
+#include "Cocktail/SemIR/File.h"
+#include "Cocktail/SemIR/IdRangeMap.h"
+#include "Cocktail/SemIR/Node.h"
+
+namespace Cocktail::Interpret {
+
+// Context and shared functionality for interpreting handlers, for a single
+// call of a function. This holds the call's frame: the value of each node
+// that has run, and the argument passed to the block being branched to.
+class FunctionContext {
+ public:
+  explicit FunctionContext(FileContext& file_context,
+                           SemIR::FunctionId function_id,
+                           llvm::raw_ostream* vlog_stream);
+
+  // Frees everything the call allocated on the stack.
+  ~FunctionContext();
+
+  FunctionContext(const FunctionContext&) = delete;
+  auto operator=(const FunctionContext&) -> FunctionContext& = delete;
+
+  // Runs the function from its entry block until it returns, and returns the
+  // returned value. Parameters and the return slot should already be set as
+  // locals.
+  auto Run() -> Value;
+
+  // Runs the sequence of instructions in `block_id`, stopping early at a
+  // branch that's taken or a return.
+  auto RunBlock(SemIR::NodeBlockId block_id) -> void;
+
+  // Returns the value for the given node.
+  auto GetLocal(SemIR::NodeId node_id) -> Value {
+    // All builtins are types, with an empty value.
+    if (node_id.index < SemIR::BuiltinKind::ValidCount) {
+      return Value::MakeNone();
+    }
+
+    auto value = locals_.Lookup(node_id);
+    if (value.kind == Value::Kind::Invalid) {
+      // This is a name from outside the function, such as a global variable.
+      Fail(llvm::Twine("Missing local: ") + llvm::Twine(node_id.index));
+    }
+    return value;
+  }
+
+  // Sets the value for the given node. Unlike lowering, a node runs each time
+  // control reaches it, so this replaces the value from an earlier run.
+  auto SetLocal(SemIR::NodeId node_id, Value value) -> void {
+    locals_.Slot(node_id) = value;
+  }
+
+  // Returns the address of storage for an object of type `type_id` that
+  // belongs to `node_id`. Storage is allocated the first time a node asks for
+  // it in a call, and reused when the node runs again, in the way lowering
+  // would hoist an `alloca`.
+  auto GetStorage(SemIR::NodeId node_id, SemIR::TypeId type_id) -> Value;
+
+  // Returns the argument most recently passed to the block `block_id`.
+  auto GetBlockArg(SemIR::NodeBlockId block_id) -> Value {
+    return block_args_.Lookup(block_id);
+  }
+
+  // Continues at the start of `block_id` once the current node is done,
+  // passing `arg`, if valid, as the block's argument.
+  auto BranchTo(SemIR::NodeBlockId block_id, Value arg = Value()) -> void {
+    next_block_id_ = block_id;
+    if (arg.kind != Value::Kind::Invalid) {
+      block_args_.Slot(block_id) = arg;
+    }
+  }
+
+  // Returns from the call with `value` once the current node is done.
+  auto ReturnWith(Value value) -> void {
+    returned_ = true;
+    return_value_ = value;
+  }
+
+  // Returns the address of the `index`th element of the struct, tuple or
+  // array of type `type_id` at `pointer`.
+  auto GetElementAddress(SemIR::TypeId type_id, Value pointer, int32_t index)
+      -> Value;
+
+  // After running an initializer `init_id`, finishes performing the
+  // initialization of `dest_id` from that initializer. This is a no-op if the
+  // initialization was performed in-place, and otherwise stores the value.
+  auto FinishInitialization(SemIR::TypeId type_id, SemIR::NodeId dest_id,
+                            SemIR::NodeId init_id) -> void;
+
+  auto Fail(const llvm::Twine& message) -> void {
+    file_context_->Fail(message);
+  }
+
+  auto file_context() -> FileContext& { return *file_context_; }
+  auto semantics_ir() -> const SemIR::File& {
+    return file_context_->semantics_ir();
+  }
+
+ private:
+  // Context for the overall interpretation.
+  FileContext* file_context_;
+
+  // The function being run.
+  SemIR::FunctionId function_id_;
+
+  // The optional vlog stream.
+  llvm::raw_ostream* vlog_stream_;
+
+  // The top of the stack when the call started.
+  int32_t stack_top_;
+
+  // Maps the function's nodes to their most recent values.
+  SemIR::IdRangeMap<SemIR::NodeId, Value> locals_;
+
+  // Maps the function's blocks to the argument most recently passed to them.
+  SemIR::IdRangeMap<SemIR::NodeBlockId, Value> block_args_;
+
+  // The block to continue at, set by a branch that's taken.
+  SemIR::NodeBlockId next_block_id_ = SemIR::NodeBlockId::Invalid;
+
+  bool returned_ = false;
+  Value return_value_;
+};
+
+// Declare handlers for each SemIR::File node.
+#define COCKTAIL_SEMANTICS_NODE_KIND(Name)                           \
+  auto Handle##Name(FunctionContext& context, SemIR::NodeId node_id, \
+                    SemIR::Node node) -> void;
+#include "Cocktail/SemIR/NodeKind.def"
+}  // namespace Cocktail::Interpret
+
+#endif  // COCKTAIL_INTERPRET_FUNCTION_CONTEXT_H
@@ -0,0 +1,94 @@
+#ifndef COCKTAIL_INTERPRET_INTERPRET_H
+#define COCKTAIL_INTERPRET_INTERPRET_H
+
+#include <cstdint>
+
+#include "Cocktail/Common/Error.h"
+#include "Cocktail/Common/Ostream.h"
+#include "Cocktail/SemIR/File.h"
+#include "llvm/ADT/ArrayRef.h"
+
+namespace Cocktail::Interpret {
+
+// A value computed by the interpreter. Values follow the lowered
+// representation of SemIR: a node's value is what lowering would produce for
+// it. Integers are `i32`, reference expressions and aggregates with a pointer
+// value representation are the address of their object, and nodes without a
+// value representation, such as types, are `None`.
+struct Value : public Printable<Value> {
+  enum class Kind : int8_t {
+    // No value has been computed. Memory starts out holding this.
+    Invalid,
+    None,
+    Integer,
+    Bool,
+    Real,
+    Address,
+  };
+
+  static auto MakeNone() -> Value { return Value(Kind::None); }
+  static auto MakeInteger(int32_t integer) -> Value {
+    Value value(Kind::Integer);
+    value.integer = integer;
+    return value;
+  }
+  static auto MakeBool(bool boolean) -> Value {
+    Value value(Kind::Bool);
+    value.boolean = boolean;
+    return value;
+  }
+  static auto MakeReal(double real) -> Value {
+    Value value(Kind::Real);
+    value.real = real;
+    return value;
+  }
+  static auto MakeAddress(int32_t address) -> Value {
+    Value value(Kind::Address);
+    value.address = address;
+    return value;
+  }
+
+  explicit Value(Kind kind = Kind::Invalid) : kind(kind), integer(0) {}
+
+  auto Print(llvm::raw_ostream& out) const -> void;
+
+  Kind kind;
+  union {
+    int32_t integer;
+    bool boolean;
+    double real;
+    // The index of a memory cell. Each scalar in an object takes one cell.
+    int32_t address;
+  };
+};
+
+// Bounds on the work done by a single interpretation.
+struct Limits {
+  // The most nodes to execute before giving up, or 0 for no limit.
+  int64_t max_steps = 0;
+  // The deepest call stack allowed. Each interpreted call uses some of the
+  // native stack, so this can't be unbounded.
+  int max_call_depth = 1000;
+};
+
+// Runs the function `function_id` in `semantics_ir` with the given arguments,
+// one per parameter, and returns the value it returns. Arguments must not be
+// addresses. A function that returns through a return slot can't be run this
+// way, because the interpreter's memory doesn't outlive the call.
+//
+// Fails rather than crashing if the function uses something the interpreter
+// doesn't support, such as strings or a function without a definition, if
+// the arguments don't match the parameters, or if it exceeds `limits`.
+auto InterpretFunction(const SemIR::File& semantics_ir,
+                       SemIR::FunctionId function_id,
+                       llvm::ArrayRef<Value> args, const Limits& limits,
+                       llvm::raw_ostream* vlog_stream) -> ErrorOr<Value>;
+
+// Runs the program's entry point, `Run`, and returns its result, or 0 if it
+// doesn't return an integer or bool. Fails if `Run` has parameters.
+auto InterpretEntryPoint(const SemIR::File& semantics_ir, const Limits& limits,
+                         llvm::raw_ostream* vlog_stream) -> ErrorOr<int32_t>;
+
+}  // namespace Cocktail::Interpret
+
+#endif  // COCKTAIL_INTERPRET_INTERPRET_H
@@ -114,6 +114,10 @@ class TokenLocationTranslator : public DiagnosticLocationTranslator<Token> {
   // 将给定的标记映射到诊断位置。
   auto GetLocation(Token token) -> DiagnosticLocation override;
 
+  // 将给定的标记映射到源缓冲区中的偏移，在输出诊断时再解析行列信息。
+  auto GetDeferredLocation(DiagnosticArena& arena, Token token)
+      -> DeferredDiagnosticLocation override;
+
  private:
   const TokenizedBuffer* buffer_;
 };
@@ -196,6 +200,9 @@ class TokenizedBuffer : public Printable<TokenizedBuffer> {
 
     auto GetLocation(const char* loc) -> DiagnosticLocation override;
 
+    auto GetDeferredLocation(DiagnosticArena& arena, const char* loc)
+        -> DeferredDiagnosticLocation override;
+
    private:
     const TokenizedBuffer* buffer_;
   };
@@ -3,6 +3,7 @@
 
 #include "Cocktail/SemIR/File.h"
 #include "Cocktail/SemIR/Node.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
@@ -19,7 +20,17 @@ class FileContext {
 
   // Lowers the SemIR::File to LLVM IR. Should only be called once, and handles
   // the main execution loop.
-  auto Run() -> std::unique_ptr<llvm::Module>;
+  auto Run() -> std::unique_ptr<llvm::Module> {
+    return RunShard(/*shard_index=*/0, /*num_shards=*/1);
+  }
+
+  // Lowers one shard of the SemIR::File. Types and function declarations are
+  // always lowered in full so that the shard is self-contained, but only
+  // functions whose index is `shard_index` modulo `num_shards` are given
+  // definitions. The shards of a file can be lowered concurrently in separate
+  // `LLVMContext`s and linked back together. Should only be called once.
+  auto RunShard(int shard_index, int num_shards)
+      -> std::unique_ptr<llvm::Module>;
 
   // Gets a callable's function.
   auto GetFunction(SemIR::FunctionId function_id) -> llvm::Function* {
@@ -37,6 +48,11 @@ class FileContext {
     return types_[type_id.index];
   }
 
+  // Returns the lowered value of the canonical constant node `constant_id`, as
+  // recorded in the SemIR constant table. Constants are shared across all
+  // functions in the module.
+  auto GetConstant(SemIR::NodeId constant_id) -> llvm::Constant*;
+
   // Returns a lowered value to use for a value of type `type`.
   auto GetTypeAsValue() -> llvm::Value* {
     return llvm::ConstantStruct::get(GetTypeType());
@@ -60,6 +76,10 @@ class FileContext {
   // caller.
   auto BuildType(SemIR::NodeId node_id) -> llvm::Type*;
 
+  // Builds the constant for the given canonical constant node, which should
+  // then be cached by the caller.
+  auto BuildConstant(SemIR::NodeId constant_id) -> llvm::Constant*;
+
   // Returns the empty LLVM struct type used to represent the type `type`.
   auto GetTypeType() -> llvm::StructType* {
     if (!type_type_) {
@@ -86,6 +106,9 @@ class FileContext {
   // Provides lowered versions of types.
   llvm::SmallVector<llvm::Type*> types_;
 
+  // Provides lowered versions of constants, keyed by canonical constant node.
+  llvm::DenseMap<SemIR::NodeId, llvm::Constant*> constants_;
+
   // Lowered version of the builtin type `type`.
   llvm::StructType* type_type_ = nullptr;
 };
@@ -3,6 +3,7 @@
 
 #include "Cocktail/Lower/FileContext.h"
 #include "Cocktail/SemIR/File.h"
+#include "Cocktail/SemIR/IdRangeMap.h"
 #include "Cocktail/SemIR/Node.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
@@ -14,7 +15,9 @@ namespace Cocktail::Lower {
 // `llvm::Function` definition.
 class FunctionContext {
  public:
+  // `id_ranges` covers the nodes and blocks of the function being lowered.
   explicit FunctionContext(FileContext& file_context, llvm::Function* function,
+                           SemIR::FunctionIdRanges id_ranges,
                            llvm::raw_ostream* vlog_stream);
 
   // Returns a basic block corresponding to the start of the given semantics
@@ -42,15 +45,16 @@ class FunctionContext {
       return GetTypeAsValue();
     }
 
-    auto it = locals_.find(node_id);
-    COCKTAIL_CHECK(it != locals_.end()) << "Missing local: " << node_id;
-    return it->second;
+    llvm::Value* value = locals_.Lookup(node_id);
+    COCKTAIL_CHECK(value) << "Missing local: " << node_id;
+    return value;
   }
 
   // Sets the value for the given node.
   auto SetLocal(SemIR::NodeId node_id, llvm::Value* value) {
-    bool added = locals_.insert({node_id, value}).second;
-    COCKTAIL_CHECK(added) << "Duplicate local insert: " << node_id;
+    llvm::Value*& slot = locals_.Slot(node_id);
+    COCKTAIL_CHECK(!slot) << "Duplicate local insert: " << node_id;
+    slot = value;
   }
 
   // Gets a callable's function.
@@ -114,7 +118,7 @@ class FunctionContext {
   llvm::raw_ostream* vlog_stream_;
 
   // Maps a function's SemIR::File blocks to lowered blocks.
-  llvm::DenseMap<SemIR::NodeBlockId, llvm::BasicBlock*> blocks_;
+  SemIR::IdRangeMap<SemIR::NodeBlockId, llvm::BasicBlock*> blocks_;
 
   // The synthetic block we most recently created. May be null if there is no
   // such block.
@@ -123,7 +127,7 @@ class FunctionContext {
   // Maps a function's SemIR::File nodes to lowered values.
   // TODO: Handle nested scopes. Right now this is just cleared at the end of
   // every block.
-  llvm::DenseMap<SemIR::NodeId, llvm::Value*> locals_;
+  SemIR::IdRangeMap<SemIR::NodeId, llvm::Value*> locals_;
 };
 
 // Declare handlers for each SemIR::File node.
@@ -1,7 +1,10 @@
 #ifndef COCKTAIL_LOWER_LOWER_H
 #define COCKTAIL_LOWER_LOWER_H
 
+#include <memory>
+
 #include "Cocktail/SemIR/File.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 
@@ -13,6 +16,32 @@ auto LowerToLLVM(llvm::LLVMContext& llvm_context, llvm::StringRef module_name,
                  llvm::raw_ostream* vlog_stream)
     -> std::unique_ptr<llvm::Module>;
 
+// A module holding a subset of a file's function definitions, along with the
+// context that owns it.
+struct LoweredShard {
+  std::unique_ptr<llvm::LLVMContext> llvm_context;
+  std::unique_ptr<llvm::Module> module;
+};
+
+// Lowers SemIR to `num_shards` modules concurrently, one worker thread per
+// shard. Every shard declares all functions, and each function is defined in
+// exactly one shard. The shards can be linked together or code generated
+// independently.
+auto LowerToLLVMShards(llvm::StringRef module_name,
+                       const SemIR::File& semantics_ir, int num_shards)
+    -> llvm::SmallVector<LoweredShard>;
+
+// Lowers SemIR to LLVM IR like `LowerToLLVM`, but splits function definitions
+// across up to `num_threads` worker threads and links the results into a
+// single module in `llvm_context`. Falls back to lowering on the calling
+// thread when `num_threads` is at most one or verbose logging is enabled,
+// because the vlog stream is not thread-safe.
+auto LowerToLLVMParallel(llvm::LLVMContext& llvm_context,
+                         llvm::StringRef module_name,
+                         const SemIR::File& semantics_ir, int num_threads,
+                         llvm::raw_ostream* vlog_stream)
+    -> std::unique_ptr<llvm::Module>;
+
 }  // namespace Cocktail::Lower
 
-#endif  // COCKTAIL_LOWER_LOWER_H
\ No newline at end of file
+#endif  // COCKTAIL_LOWER_LOWER_H
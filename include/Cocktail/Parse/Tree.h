@@ -64,6 +64,9 @@ class Tree : public Printable<Tree> {
   class SiblingIterator;
 
   // 工厂函数，用于将token buffer解析为Tree。
+  //
+  // 如果在出现错误后 consumer.ShouldStop() 返回 true，解析会提前停止，返回的树
+  // 不完整，只能用于报告错误。
   static auto Parse(Lex::TokenizedBuffer& tokens, DiagnosticConsumer& consumer,
                     llvm::raw_ostream* vlog_stream) -> Tree;
 
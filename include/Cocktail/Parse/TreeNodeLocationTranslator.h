@@ -15,6 +15,12 @@ class NodeLocationTranslator : public DiagnosticLocationTranslator<Node> {
     return token_translator_.GetLocation(parse_tree_->node_token(node));
   }
 
+  auto GetDeferredLocation(DiagnosticArena& arena, Node node)
+      -> DeferredDiagnosticLocation override {
+    return token_translator_.GetDeferredLocation(arena,
+                                                 parse_tree_->node_token(node));
+  }
+
  private:
   Lex::TokenLocationTranslator token_translator_;
   const Tree* parse_tree_;
@@ -3,6 +3,9 @@
 
 #include "Cocktail/Common/Ostream.h"
 #include "Cocktail/SemIR/Node.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/iterator_range.h"
@@ -86,8 +89,13 @@ class File : public Printable<File> {
     Print(out, /*include_builtins=*/false);
   }
 
-  // Returns array bound value from the bound node.
+  // Returns array bound value from the bound node. The bound may be any
+  // expression with a constant integer value.
   auto GetArrayBoundValue(NodeId bound_id) const -> uint64_t {
+    if (auto constant_id = GetConstantValue(bound_id);
+        constant_id.is_valid()) {
+      bound_id = constant_id;
+    }
     return GetIntegerLiteral(GetNode(bound_id).GetAsIntegerLiteral())
         .getZExtValue();
   }
@@ -130,6 +138,36 @@ class File : public Printable<File> {
     return integer_literals_[int_id.index];
   }
 
+  // Returns the canonical constant node for an integer of the given type and
+  // value. Constant nodes aren't added to any node block, and equal constants
+  // share a single node.
+  auto AddIntegerConstant(TypeId type_id, llvm::APInt value) -> NodeId;
+
+  // Returns the canonical constant node for a bool of the given type and value.
+  auto AddBoolConstant(TypeId type_id, BoolValue value) -> NodeId;
+
+  // Returns the canonical constant node for a tuple or struct value, which must
+  // be a TupleValue or StructValue, whose elements are the given canonical
+  // constant nodes.
+  auto AddAggregateConstant(NodeKind kind, TypeId type_id,
+                            llvm::ArrayRef<NodeId> element_ids) -> NodeId;
+
+  // Records that `node_id` always evaluates to the canonical constant node
+  // `constant_id`.
+  auto SetConstantValue(NodeId node_id, NodeId constant_id) -> void {
+    auto [it, inserted] = constant_values_.insert({node_id, constant_id});
+    if (!inserted) {
+      it->second = constant_id;
+    }
+  }
+
+  // Returns the canonical constant node that `node_id` evaluates to, or
+  // `NodeId::Invalid` if its value isn't known to be constant.
+  auto GetConstantValue(NodeId node_id) const -> NodeId {
+    auto it = constant_values_.find(node_id);
+    return it == constant_values_.end() ? NodeId::Invalid : it->second;
+  }
+
   // Adds a name scope, returning an ID to reference it.
   auto AddNameScope() -> NameScopeId {
     NameScopeId name_scopes_id(name_scopes_.size());
@@ -352,6 +390,10 @@ class File : public Printable<File> {
     return result;
   }
 
+  // Returns the constant node identified by `key`, adding `node` for it if
+  // there isn't one yet.
+  auto AddConstantNode(llvm::ArrayRef<int32_t> key, Node node) -> NodeId;
+
   bool has_errors_ = false;
 
   // Slab allocator, used to allocate node and type blocks.
@@ -372,6 +414,17 @@ class File : public Printable<File> {
   // Storage for integer literals.
   llvm::SmallVector<llvm::APInt> integer_literals_;
 
+  // Maps the value of each integer constant to its entry in integer_literals_,
+  // so that equal constants share an IntegerLiteralId.
+  llvm::DenseMap<llvm::APInt, IntegerLiteralId> integer_constant_ids_;
+
+  // The constant table. constant_nodes_ maps a flattened (kind, type,
+  // operands) key to the canonical node for that constant, with key storage
+  // provided by allocator_. constant_values_ maps nodes whose value is known
+  // at compile time to their canonical constant.
+  llvm::DenseMap<llvm::ArrayRef<int32_t>, NodeId> constant_nodes_;
+  llvm::DenseMap<NodeId, NodeId> constant_values_;
+
   // Storage for name scopes.
   llvm::SmallVector<llvm::DenseMap<StringId, NodeId>> name_scopes_;
 
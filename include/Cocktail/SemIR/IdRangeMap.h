@@ -0,0 +1,66 @@
+#ifndef COCKTAIL_SEMIR_ID_RANGE_MAP_H
+#define COCKTAIL_SEMIR_ID_RANGE_MAP_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Cocktail/Common/Check.h"
+#include "Cocktail/SemIR/File.h"
+
+namespace Cocktail::SemIR {
+
+// A half-open range `[begin, end)` of ID indexes.
+struct IdRange {
+  auto size() const -> int32_t { return end - begin; }
+
+  int32_t begin = 0;
+  int32_t end = 0;
+};
+
+// The ranges of node and block IDs that belong to a function's definition.
+struct FunctionIdRanges {
+  IdRange nodes;
+  IdRange node_blocks;
+};
+
+// Returns ranges covering the function's parameters, return slot, and every
+// node and block in its body, including spliced blocks. The nodes and blocks
+// of a function are allocated together while checking it, so these ranges
+// are compact. The function must have a definition.
+auto GetFunctionIdRanges(const File& file, FunctionId function_id)
+    -> FunctionIdRanges;
+
+// Maps the IDs in a fixed range to values using a flat array that's sized up
+// front, so lookups are a bounds check plus an index rather than a hash probe.
+// A default-constructed `ValueT` marks an ID with no value.
+template <typename IdT, typename ValueT>
+class IdRangeMap {
+ public:
+  explicit IdRangeMap(IdRange range)
+      : first_index_(range.begin), values_(range.size()) {}
+
+  // Returns the value for `id`, or an empty value if none has been set or
+  // `id` is outside the range.
+  auto Lookup(IdT id) const -> ValueT {
+    auto offset = static_cast<size_t>(id.index - first_index_);
+    return offset < values_.size() ? values_[offset] : ValueT();
+  }
+
+  // Returns the slot for `id`, which must be inside the range.
+  auto Slot(IdT id) -> ValueT& {
+    auto offset = static_cast<size_t>(id.index - first_index_);
+    COCKTAIL_CHECK(offset < values_.size())
+        << id << " is outside the range [" << first_index_ << ", "
+        << first_index_ + values_.size() << ")";
+    return values_[offset];
+  }
+
+ private:
+  // The ID index corresponding to `values_[0]`.
+  int32_t first_index_;
+  std::vector<ValueT> values_;
+};
+
+}  // namespace Cocktail::SemIR
+
+#endif  // COCKTAIL_SEMIR_ID_RANGE_MAP_H
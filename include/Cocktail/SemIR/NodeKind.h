@@ -45,6 +45,7 @@ class NodeKind : public COCKTAIL_ENUM_BASE(NodeKind) {
   COCKTAIL_ENUM_CONSTANT_DECLARATION(Name)
 #include "Cocktail/SemIR/NodeKind.def"
 
+  using EnumBase::AsInt;
   using EnumBase::Create;
 
   // Returns the name to use for this node kind in Semantics IR.
@@ -1,9 +1,11 @@
 #ifndef COCKTAIL_SOURCE_SOURCE_BUFFER_H
 #define COCKTAIL_SOURCE_SOURCE_BUFFER_H
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "Cocktail/Diagnostics/DiagnosticEmitter.h"
 #include "llvm/ADT/StringRef.h"
@@ -31,6 +33,15 @@ class SourceBuffer {
     return text_->getBuffer();
   }
 
+  // 返回源代码文本中给定字节偏移处的诊断位置。行起始位置的索引在第一次调用时
+  // 构建，因此只有真正输出诊断时才需要扫描文本。
+  [[nodiscard]] auto GetLocation(int64_t offset) const -> DiagnosticLocation;
+
+  // 返回给定字节偏移处的延迟诊断位置。源缓冲区必须在诊断被消费之前保持有效且
+  // 不被移动。
+  [[nodiscard]] auto GetDeferredLocation(int64_t offset) const
+      -> DeferredDiagnosticLocation;
+
  private:
   explicit SourceBuffer(std::string filename,
                         std::unique_ptr<llvm::MemoryBuffer> text)
@@ -38,6 +49,7 @@ class SourceBuffer {
 
   std::string filename_;                      // 存储源文件的名称。
   std::unique_ptr<llvm::MemoryBuffer> text_;  // 存储源代码文本。
+  mutable std::vector<int32_t> line_starts_;  // 每行起始的偏移，按需构建。
 };
 
 }  // namespace Cocktail
@@ -0,0 +1,70 @@
+#ifndef COCKTAIL_TESTING_CHECK_T_H
+#define COCKTAIL_TESTING_CHECK_T_H
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "Cocktail/Check/Check.h"
+#include "Cocktail/Common/Check.h"
+#include "Cocktail/Diagnostics/DiagnosticEmitter.h"
+#include "Cocktail/Diagnostics/NullDiagnostics.h"
+#include "Cocktail/Lex/TokenizedBuffer.h"
+#include "Cocktail/Parse/Tree.h"
+#include "Cocktail/SemIR/File.h"
+#include "Cocktail/Source/SourceBuffer.h"
+#include "llvm/ADT/Sequence.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/VirtualFileSystem.h"
+
+namespace Cocktail::Testing {
+
+// A fixture for tests that check source text and inspect the resulting SemIR.
+class CheckTest : public ::testing::Test {
+ protected:
+  // Checks `source` against the builtins, expecting errors only if
+  // `has_errors`. Diagnostics are printed unless errors are expected.
+  auto CheckSource(llvm::StringRef source, bool has_errors = false)
+      -> SemIR::File {
+    // Each source gets its own file, because files can't be replaced.
+    std::string path = "/test" + std::to_string(++num_files_) + ".cocktail";
+    fs_.addFile(path, /*ModificationTime=*/0,
+                llvm::MemoryBuffer::getMemBufferCopy(source));
+    DiagnosticConsumer& consumer = has_errors ? NullDiagnosticConsumer()
+                                              : ConsoleDiagnosticConsumer();
+    auto source_buffer = SourceBuffer::CreateFromFile(fs_, path, consumer);
+    EXPECT_TRUE(source_buffer.has_value());
+    auto tokens = Lex::TokenizedBuffer::Lex(*source_buffer, consumer);
+    auto parse_tree =
+        Parse::Tree::Parse(tokens, consumer, /*vlog_stream=*/nullptr);
+    auto sem_ir = Check::CheckParseTree(builtins_, tokens, parse_tree,
+                                        consumer, /*vlog_stream=*/nullptr);
+    EXPECT_EQ(sem_ir.has_errors(), has_errors);
+    return sem_ir;
+  }
+
+  // Returns the function named `name`, which must exist.
+  static auto GetFunctionId(const SemIR::File& sem_ir, llvm::StringRef name)
+      -> SemIR::FunctionId {
+    for (auto i : llvm::seq(0, sem_ir.functions_size())) {
+      SemIR::FunctionId function_id(i);
+      const auto& function = sem_ir.GetFunction(function_id);
+      if (function.name_id.is_valid() &&
+          sem_ir.GetString(function.name_id) == name) {
+        return function_id;
+      }
+    }
+    COCKTAIL_FATAL() << "No function named " << name;
+  }
+
+  SemIR::File builtins_ = Check::MakeBuiltins();
+
+ private:
+  llvm::vfs::InMemoryFileSystem fs_;
+  int num_files_ = 0;
+};
+
+}  // namespace Cocktail::Testing
+
+#endif  // COCKTAIL_TESTING_CHECK_T_H
@@ -9,13 +9,12 @@ namespace Cocktail::Testing {
 
 class MockDiagnosticConsumer : public DiagnosticConsumer {
  public:
-  MOCK_METHOD(void, HandleDiagnostic, (const Diagnostic& diagnostic),
-              (override));
+  MOCK_METHOD(void, HandleDiagnostic, (Diagnostic diagnostic), (override));
 };
 
 MATCHER_P(IsDiagnosticMessage, matcher, "") {
   const Diagnostic& diag = arg;
-  return testing::ExplainMatchResult(matcher, diag.format_fn(diag),
+  return testing::ExplainMatchResult(matcher, diag.message.Format(),
                                      result_listener);
 }
 
@@ -25,16 +24,24 @@ inline auto IsDiagnostic(testing::Matcher<DiagnosticKind> kind,
                          testing::Matcher<int> column_number,
                          testing::Matcher<std::string> message) {
   return testing::AllOf(
-      testing::Field("kind", &Diagnostic::kind, kind),
       testing::Field("level", &Diagnostic::level, level),
       testing::Field(
-          &Diagnostic::location,
+          &Diagnostic::message,
           testing::AllOf(
-              testing::Field("line_number", &DiagnosticLocation::line_number,
-                             line_number),
-              testing::Field("column_number",
-                             &DiagnosticLocation::column_number,
-                             column_number))),
+              testing::Field("kind", &DiagnosticMessage::kind, kind),
+              testing::Field(
+                  &DiagnosticMessage::location,
+                  testing::ResultOf(
+                      [](const DeferredDiagnosticLocation& location) {
+                        return location.Resolve();
+                      },
+                      testing::AllOf(
+                          testing::Field("line_number",
+                                         &DiagnosticLocation::line_number,
+                                         line_number),
+                          testing::Field("column_number",
+                                         &DiagnosticLocation::column_number,
+                                         column_number)))))),
       IsDiagnosticMessage(message));
 }
 
@@ -17,8 +17,8 @@ auto CheckParseTree(const SemIR::File& builtin_ir,
   ErrorTrackingDiagnosticConsumer err_tracker(consumer);
   DiagnosticEmitter<Parse::Node> emitter(translator, err_tracker);
 
-  Check::Context context(tokens, emitter, parse_tree, semantics_ir,
-                         vlog_stream);
+  Check::Context context(tokens, emitter, err_tracker, parse_tree,
+                         semantics_ir, vlog_stream);
   PrettyStackTraceFunction context_dumper(
       [&](llvm::raw_ostream& output) { context.PrintForStackDump(output); });
 
@@ -27,8 +27,13 @@ auto CheckParseTree(const SemIR::File& builtin_ir,
   context.PushScope();
 
   // Loops over all nodes in the tree. On some errors, this may return early,
-  // for example if an unrecoverable state is encountered.
+  // for example if an unrecoverable state is encountered or the consumer asks
+  // to stop after an error limit is reached.
   for (auto parse_node : parse_tree.postorder()) {
+    if (err_tracker.seen_error() && err_tracker.ShouldStop()) {
+      semantics_ir.set_has_errors(true);
+      return semantics_ir;
+    }
     // clang warns on unhandled enum values; clang-tidy is incorrect here.
     // NOLINTNEXTLINE(bugprone-switch-missing-default-case)
     switch (auto parse_kind = parse_tree.node_kind(parse_node)) {
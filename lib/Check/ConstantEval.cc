@@ -0,0 +1,287 @@
+#include "Cocktail/Check/ConstantEval.h"
+
+#include <optional>
+
+#include "Cocktail/Check/Context.h"
+#include "Cocktail/Common/Check.h"
+#include "Cocktail/Interpret/Interpret.h"
+#include "Cocktail/SemIR/File.h"
+#include "Cocktail/SemIR/Node.h"
+#include "Cocktail/SemIR/NodeKind.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace Cocktail::Check {
+
+// The width of the integer type.
+// TODO: Handle different sizes, in step with lowering.
+static constexpr unsigned IntegerBitWidth = 32;
+
+// Returns the canonical form of an integer constant value. Values that fit in
+// the integer type are stored at its width so that equal values compare
+// equal; larger literals keep their own width, and are never folded.
+static auto CanonicalizeInteger(const llvm::APInt& value) -> llvm::APInt {
+  if (value.getActiveBits() <= IntegerBitWidth) {
+    return value.zextOrTrunc(IntegerBitWidth);
+  }
+  return value;
+}
+
+auto GetConstantValue(Context& context, SemIR::NodeId node_id)
+    -> SemIR::NodeId {
+  auto& semantics_ir = context.semantics_ir();
+  if (auto constant_id = semantics_ir.GetConstantValue(node_id);
+      constant_id.is_valid()) {
+    return constant_id;
+  }
+
+  auto node = semantics_ir.GetNode(node_id);
+  auto constant_id = SemIR::NodeId::Invalid;
+  switch (node.kind()) {
+    case SemIR::NodeKind::IntegerLiteral:
+      constant_id = semantics_ir.AddIntegerConstant(
+          node.type_id(),
+          CanonicalizeInteger(
+              semantics_ir.GetIntegerLiteral(node.GetAsIntegerLiteral())));
+      break;
+    case SemIR::NodeKind::BoolLiteral:
+      constant_id = semantics_ir.AddBoolConstant(node.type_id(),
+                                                 node.GetAsBoolLiteral());
+      break;
+    default:
+      return SemIR::NodeId::Invalid;
+  }
+  semantics_ir.SetConstantValue(node_id, constant_id);
+  return constant_id;
+}
+
+// Returns the constant integer value of `node_id` if it has one that fits in
+// the integer type.
+static auto GetIntegerConstant(Context& context, SemIR::NodeId node_id)
+    -> std::optional<llvm::APInt> {
+  auto constant_id = GetConstantValue(context, node_id);
+  if (!constant_id.is_valid()) {
+    return std::nullopt;
+  }
+  auto constant = context.semantics_ir().GetNode(constant_id);
+  if (constant.kind() != SemIR::NodeKind::IntegerLiteral) {
+    return std::nullopt;
+  }
+  const auto& value =
+      context.semantics_ir().GetIntegerLiteral(constant.GetAsIntegerLiteral());
+  if (value.getBitWidth() != IntegerBitWidth) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+// Returns the constant bool value of `node_id` if it has one.
+static auto GetBoolConstant(Context& context, SemIR::NodeId node_id)
+    -> std::optional<bool> {
+  auto constant_id = GetConstantValue(context, node_id);
+  if (!constant_id.is_valid()) {
+    return std::nullopt;
+  }
+  auto constant = context.semantics_ir().GetNode(constant_id);
+  if (constant.kind() != SemIR::NodeKind::BoolLiteral) {
+    return std::nullopt;
+  }
+  return constant.GetAsBoolLiteral() == SemIR::BoolValue::True;
+}
+
+static auto MakeBoolValue(bool value) -> SemIR::BoolValue {
+  return value ? SemIR::BoolValue::True : SemIR::BoolValue::False;
+}
+
+// Folds a tuple or struct value whose elements are all scalar constants.
+// Nested aggregates are left to runtime, because their value representation
+// may differ from their object representation.
+static auto TryEvalAggregate(Context& context, SemIR::Node node,
+                             SemIR::NodeBlockId refs_id) -> SemIR::NodeId {
+  auto& semantics_ir = context.semantics_ir();
+  llvm::SmallVector<SemIR::NodeId> element_ids;
+  for (auto ref_id : semantics_ir.GetNodeBlock(refs_id)) {
+    auto element_id = GetConstantValue(context, ref_id);
+    if (!element_id.is_valid()) {
+      return SemIR::NodeId::Invalid;
+    }
+    auto element_kind = semantics_ir.GetNode(element_id).kind();
+    if (element_kind != SemIR::NodeKind::IntegerLiteral &&
+        element_kind != SemIR::NodeKind::BoolLiteral) {
+      return SemIR::NodeId::Invalid;
+    }
+    element_ids.push_back(element_id);
+  }
+  return semantics_ir.AddAggregateConstant(node.kind(), node.type_id(),
+                                           element_ids);
+}
+
+auto TryEvalNode(Context& context, SemIR::NodeId node_id) -> SemIR::NodeId {
+  auto& semantics_ir = context.semantics_ir();
+  auto node = semantics_ir.GetNode(node_id);
+  auto constant_id = SemIR::NodeId::Invalid;
+  switch (node.kind()) {
+    case SemIR::NodeKind::BinaryOperatorAdd: {
+      auto [lhs_id, rhs_id] = node.GetAsBinaryOperatorAdd();
+      auto lhs = GetIntegerConstant(context, lhs_id);
+      auto rhs = GetIntegerConstant(context, rhs_id);
+      if (!lhs || !rhs) {
+        return SemIR::NodeId::Invalid;
+      }
+      // This wraps on overflow, matching the lowered `add`.
+      constant_id =
+          semantics_ir.AddIntegerConstant(node.type_id(), *lhs + *rhs);
+      break;
+    }
+    case SemIR::NodeKind::UnaryOperatorNot: {
+      auto operand = GetBoolConstant(context, node.GetAsUnaryOperatorNot());
+      if (!operand) {
+        return SemIR::NodeId::Invalid;
+      }
+      constant_id = semantics_ir.AddBoolConstant(node.type_id(),
+                                                 MakeBoolValue(!*operand));
+      break;
+    }
+    case SemIR::NodeKind::StructValue: {
+      auto [literal_id, refs_id] = node.GetAsStructValue();
+      constant_id = TryEvalAggregate(context, node, refs_id);
+      break;
+    }
+    case SemIR::NodeKind::TupleValue: {
+      auto [literal_id, refs_id] = node.GetAsTupleValue();
+      constant_id = TryEvalAggregate(context, node, refs_id);
+      break;
+    }
+    default:
+      return GetConstantValue(context, node_id);
+  }
+  if (constant_id.is_valid()) {
+    semantics_ir.SetConstantValue(node_id, constant_id);
+  }
+  return constant_id;
+}
+
+auto TryEvalShortCircuitOperator(Context& context, SemIR::NodeId result_id,
+                                 bool is_and, SemIR::NodeId lhs_id,
+                                 SemIR::NodeId rhs_id) -> SemIR::NodeId {
+  auto lhs = GetBoolConstant(context, lhs_id);
+  if (!lhs) {
+    return SemIR::NodeId::Invalid;
+  }
+
+  // `false and x` and `true or x` don't depend on `x`. Otherwise, the result is
+  // the value of `x`.
+  auto constant_id = SemIR::NodeId::Invalid;
+  if (*lhs != is_and) {
+    constant_id = GetConstantValue(context, lhs_id);
+  } else {
+    constant_id = GetConstantValue(context, rhs_id);
+  }
+  if (constant_id.is_valid()) {
+    context.semantics_ir().SetConstantValue(result_id, constant_id);
+  }
+  return constant_id;
+}
+
+// Limits for interpreting calls during check. Calls that exceed them are left
+// to runtime rather than diagnosed.
+static constexpr Interpret::Limits CheckEvalLimits = {.max_steps = 100'000,
+                                                      .max_call_depth = 64};
+
+// Returns whether `type_id` is a scalar type that the interpreter and the
+// constant table both support.
+static auto IsFoldableScalarType(const SemIR::File& semantics_ir,
+                                 SemIR::TypeId type_id) -> bool {
+  if (!type_id.is_valid()) {
+    return false;
+  }
+  auto type_node_id = semantics_ir.GetType(type_id);
+  return type_node_id == SemIR::NodeId::BuiltinIntegerType ||
+         type_node_id == SemIR::NodeId::BuiltinBoolType;
+}
+
+auto TryEvalCall(Context& context, SemIR::NodeId call_id) -> SemIR::NodeId {
+  // After an error, the callee may hold error nodes, which the interpreter
+  // doesn't support.
+  if (context.seen_error()) {
+    return SemIR::NodeId::Invalid;
+  }
+
+  auto& semantics_ir = context.semantics_ir();
+  auto call = semantics_ir.GetNode(call_id);
+  auto [refs_id, function_id] = call.GetAsCall();
+  const auto& function = semantics_ir.GetFunction(function_id);
+  if (function.return_slot_id.is_valid() ||
+      !IsFoldableScalarType(semantics_ir, function.return_type_id) ||
+      function.body_block_ids.empty()) {
+    return SemIR::NodeId::Invalid;
+  }
+
+  // A function whose definition is still being checked can't be run yet; this
+  // includes recursive calls.
+  if (llvm::any_of(context.return_scope_stack(), [&](SemIR::NodeId decl_id) {
+        return semantics_ir.GetNode(decl_id).GetAsFunctionDeclaration() ==
+               function_id;
+      })) {
+    return SemIR::NodeId::Invalid;
+  }
+
+  // The key for this call in `failed_call_evals`: the callee, then the
+  // canonical constant of each argument, which is invalid for arguments with
+  // no value representation.
+  llvm::SmallVector<int32_t> eval_key = {function_id.index};
+  llvm::SmallVector<Interpret::Value> args;
+  for (auto arg_id : semantics_ir.GetNodeBlock(refs_id)) {
+    auto arg_type_id = semantics_ir.GetNode(arg_id).type_id();
+    if (SemIR::GetValueRepresentation(semantics_ir, arg_type_id).kind ==
+        SemIR::ValueRepresentation::None) {
+      eval_key.push_back(SemIR::NodeId::Invalid.index);
+      args.push_back(Interpret::Value::MakeNone());
+      continue;
+    }
+    eval_key.push_back(GetConstantValue(context, arg_id).index);
+    if (auto value = GetIntegerConstant(context, arg_id)) {
+      args.push_back(Interpret::Value::MakeInteger(
+          static_cast<int32_t>(value->getZExtValue())));
+    } else if (auto value = GetBoolConstant(context, arg_id)) {
+      args.push_back(Interpret::Value::MakeBool(*value));
+    } else {
+      return SemIR::NodeId::Invalid;
+    }
+  }
+
+  // A call that failed once, for example by exceeding the limits, fails the
+  // same way every time.
+  llvm::StringRef eval_key_bytes(reinterpret_cast<const char*>(eval_key.data()),
+                                 eval_key.size() * sizeof(int32_t));
+  if (context.failed_call_evals().contains(eval_key_bytes)) {
+    return SemIR::NodeId::Invalid;
+  }
+  auto result = Interpret::InterpretFunction(semantics_ir, function_id, args,
+                                             CheckEvalLimits,
+                                             /*vlog_stream=*/nullptr);
+  if (!result.ok()) {
+    context.failed_call_evals().insert(eval_key_bytes);
+    return SemIR::NodeId::Invalid;
+  }
+
+  auto constant_id = SemIR::NodeId::Invalid;
+  switch (result->kind) {
+    case Interpret::Value::Kind::Integer:
+      constant_id = semantics_ir.AddIntegerConstant(
+          call.type_id(),
+          llvm::APInt(IntegerBitWidth, static_cast<uint32_t>(result->integer)));
+      break;
+    case Interpret::Value::Kind::Bool:
+      constant_id = semantics_ir.AddBoolConstant(
+          call.type_id(), MakeBoolValue(result->boolean));
+      break;
+    default:
+      return SemIR::NodeId::Invalid;
+  }
+  semantics_ir.SetConstantValue(call_id, constant_id);
+  return constant_id;
+}
+
+}  // namespace Cocktail::Check
@@ -19,10 +19,12 @@ namespace Cocktail::Check {
 
 Context::Context(const Lex::TokenizedBuffer& tokens,
                  DiagnosticEmitter<Parse::Node>& emitter,
+                 const ErrorTrackingDiagnosticConsumer& err_tracker,
                  const Parse::Tree& parse_tree, SemIR::File& semantics_ir,
                  llvm::raw_ostream* vlog_stream)
     : tokens_(&tokens),
       emitter_(&emitter),
+      err_tracker_(&err_tracker),
       parse_tree_(&parse_tree),
       semantics_ir_(&semantics_ir),
       vlog_stream_(vlog_stream),
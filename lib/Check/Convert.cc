@@ -3,6 +3,7 @@
 #include <string>
 #include <utility>
 
+#include "Cocktail/Check/ConstantEval.h"
 #include "Cocktail/Check/Context.h"
 #include "Cocktail/Common/Check.h"
 #include "Cocktail/Diagnostics/DiagnosticKind.h"
@@ -376,12 +377,16 @@ static auto ConvertTupleToTuple(Context& context, SemIR::Node src_type,
     new_block.Set(i, init_id);
   }
 
-  return context.AddNode(
+  auto result_id = context.AddNode(
       is_init
           ? SemIR::Node::TupleInit::Make(value.parse_node(), target.type_id,
                                          value_id, new_block.id())
           : SemIR::Node::TupleValue::Make(value.parse_node(), target.type_id,
                                           value_id, new_block.id()));
+  if (!is_init) {
+    TryEvalNode(context, result_id);
+  }
+  return result_id;
 }
 
 // Performs a conversion from a struct to a struct type. Does not perform a
@@ -473,12 +478,16 @@ static auto ConvertStructToStruct(Context& context, SemIR::Node src_type,
     new_block.Set(i, init_id);
   }
 
-  return context.AddNode(
+  auto result_id = context.AddNode(
       is_init
           ? SemIR::Node::StructInit::Make(value.parse_node(), target.type_id,
                                           value_id, new_block.id())
           : SemIR::Node::StructValue::Make(value.parse_node(), target.type_id,
                                            value_id, new_block.id()));
+  if (!is_init) {
+    TryEvalNode(context, result_id);
+  }
+  return result_id;
 }
 
 // Returns whether `category` is a valid expression category to produce as a
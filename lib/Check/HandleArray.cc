@@ -1,3 +1,4 @@
+#include "Cocktail/Check/ConstantEval.h"
 #include "Cocktail/Check/Context.h"
 #include "Cocktail/Check/Convert.h"
 #include "Cocktail/Parse/NodeKind.h"
@@ -30,8 +31,12 @@ auto HandleArrayExpression(Context& context, Parse::Node parse_node) -> bool {
   context.node_stack()
       .PopAndDiscardSoloParseNode<Parse::NodeKind::ArrayExpressionSemi>();
   auto element_type_node_id = context.node_stack().PopExpression();
-  auto bound_node = context.semantics_ir().GetNode(bound_node_id);
-  if (bound_node.kind() == SemIR::NodeKind::IntegerLiteral) {
+  // The bound can be any expression that folds to an integer constant.
+  auto bound_constant_id = GetConstantValue(context, bound_node_id);
+  if (bound_constant_id.is_valid() &&
+      context.semantics_ir().GetNode(bound_constant_id).kind() ==
+          SemIR::NodeKind::IntegerLiteral) {
+    auto bound_node = context.semantics_ir().GetNode(bound_constant_id);
     auto bound_value = context.semantics_ir().GetIntegerLiteral(
         bound_node.GetAsIntegerLiteral());
     // TODO: Produce an error if the array type is too large.
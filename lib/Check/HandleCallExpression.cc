@@ -1,3 +1,4 @@
+#include "Cocktail/Check/ConstantEval.h"
 #include "Cocktail/Check/Context.h"
 #include "Cocktail/Check/Convert.h"
 #include "Cocktail/SemIR/Node.h"
@@ -53,6 +54,7 @@ auto HandleCallExpression(Context& context, Parse::Node parse_node) -> bool {
 
   auto call_node_id = context.AddNode(SemIR::Node::Call::Make(
       call_expr_parse_node, type_id, refs_id, function_id));
+  TryEvalCall(context, call_node_id);
 
   context.node_stack().Push(parse_node, call_node_id);
   return true;
@@ -1,3 +1,4 @@
+#include "Cocktail/Check/ConstantEval.h"
 #include "Cocktail/Check/Context.h"
 #include "Cocktail/Check/Convert.h"
 
@@ -18,11 +19,13 @@ auto HandleInfixOperator(Context& context, Parse::Node parse_node) -> bool {
           context.semantics_ir().GetNode(rhs_id).type_id());
       rhs_id = ConvertToValueExpression(context, rhs_id);
 
-      context.AddNodeAndPush(
-          parse_node,
-          SemIR::Node::BinaryOperatorAdd::Make(
-              parse_node, context.semantics_ir().GetNode(lhs_id).type_id(),
-              lhs_id, rhs_id));
+      {
+        auto add_id = context.AddNode(SemIR::Node::BinaryOperatorAdd::Make(
+            parse_node, context.semantics_ir().GetNode(lhs_id).type_id(),
+            lhs_id, rhs_id));
+        TryEvalNode(context, add_id);
+        context.node_stack().Push(parse_node, add_id);
+      }
       return true;
 
     case Lex::TokenKind::And:
@@ -41,11 +44,13 @@ auto HandleInfixOperator(Context& context, Parse::Node parse_node) -> bool {
       context.AddCurrentCodeBlockToFunction();
 
       // Collect the result from either the first or second operand.
-      context.AddNodeAndPush(
-          parse_node,
-          SemIR::Node::BlockArg::Make(
-              parse_node, context.semantics_ir().GetNode(rhs_id).type_id(),
-              resume_block_id));
+      auto result_id = context.AddNode(SemIR::Node::BlockArg::Make(
+          parse_node, context.semantics_ir().GetNode(rhs_id).type_id(),
+          resume_block_id));
+      TryEvalShortCircuitOperator(context, result_id,
+                                  token_kind == Lex::TokenKind::And, lhs_id,
+                                  rhs_id);
+      context.node_stack().Push(parse_node, result_id);
       return true;
     }
     case Lex::TokenKind::Equal: {
@@ -144,14 +149,15 @@ auto HandlePrefixOperator(Context& context, Parse::Node parse_node) -> bool {
       return true;
     }
 
-    case Lex::TokenKind::Not:
+    case Lex::TokenKind::Not: {
       value_id = ConvertToBoolValue(context, parse_node, value_id);
-      context.AddNodeAndPush(
-          parse_node,
-          SemIR::Node::UnaryOperatorNot::Make(
-              parse_node, context.semantics_ir().GetNode(value_id).type_id(),
-              value_id));
+      auto not_id = context.AddNode(SemIR::Node::UnaryOperatorNot::Make(
+          parse_node, context.semantics_ir().GetNode(value_id).type_id(),
+          value_id));
+      TryEvalNode(context, not_id);
+      context.node_stack().Push(parse_node, not_id);
       return true;
+    }
 
     case Lex::TokenKind::Star: {
       auto type_id = context.GetUnqualifiedType(
@@ -2,23 +2,43 @@
 
 #include <memory>
 
+#include "Cocktail/CodeGen/Targets.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/PassManager.h"
 #include "llvm/MC/TargetRegistry.h"
-#include "llvm/Support/TargetSelect.h"
+#include "llvm/Passes/PassBuilder.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/TargetParser/Host.h"
+#include "llvm/Transforms/IPO/ThinLTOBitcodeWriter.h"
 
 namespace Cocktail {
 
 auto CodeGen::Create(llvm::Module& module, llvm::StringRef target_triple,
                      llvm::raw_pwrite_stream& errors)
     -> std::optional<CodeGen> {
-  // Initialize the target registry etc.
-  llvm::InitializeAllTargetInfos();
-  llvm::InitializeAllTargets();
-  llvm::InitializeAllTargetMCs();
-  llvm::InitializeAllAsmParsers();
-  llvm::InitializeAllAsmPrinters();
+  auto target_machine = CreateTargetMachine(target_triple, errors);
+  if (!target_machine) {
+    return {};
+  }
+  CodeGen codegen = Create(module, *target_machine, errors);
+  codegen.owned_target_machine_ = std::move(target_machine);
+  return codegen;
+}
+
+auto CodeGen::Create(llvm::Module& module, llvm::TargetMachine& target_machine,
+                     llvm::raw_pwrite_stream& errors) -> CodeGen {
+  module.setTargetTriple(target_machine.getTargetTriple().str());
+  return CodeGen(module, target_machine, errors);
+}
+
+auto CodeGen::CreateTargetMachine(llvm::StringRef target_triple,
+                                  llvm::raw_pwrite_stream& errors)
+    -> std::unique_ptr<llvm::TargetMachine> {
+  // Register only the backend for this target, once per process.
+  if (!InitializeTargetForTriple(target_triple, errors)) {
+    return nullptr;
+  }
 
   std::string error;
   const llvm::Target* target =
@@ -26,19 +46,16 @@ auto CodeGen::Create(llvm::Module& module, llvm::StringRef target_triple,
 
   if (!target) {
     errors << "ERROR: Invalid target: " << error << "\n";
-    return {};
+    return nullptr;
   }
-  module.setTargetTriple(target_triple);
 
   constexpr llvm::StringLiteral CPU = "generic";
   constexpr llvm::StringLiteral Features = "";
 
   llvm::TargetOptions target_opts;
   std::optional<llvm::Reloc::Model> reloc_model;
-  CodeGen codegen(module, errors);
-  codegen.target_machine_.reset(target->createTargetMachine(
+  return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(
       target_triple, CPU, Features, target_opts, reloc_model));
-  return codegen;
 }
 
 auto CodeGen::EmitAssembly(llvm::raw_pwrite_stream& out) -> bool {
@@ -49,6 +66,35 @@ auto CodeGen::EmitObject(llvm::raw_pwrite_stream& out) -> bool {
   return EmitCode(out, llvm::CodeGenFileType::ObjectFile);
 }
 
+auto CodeGen::EmitBitcode(llvm::raw_pwrite_stream& out) -> bool {
+  module_.setDataLayout(target_machine_->createDataLayout());
+  llvm::WriteBitcodeToFile(module_, out);
+  return true;
+}
+
+auto CodeGen::EmitThinLTOBitcode(llvm::raw_pwrite_stream& out) -> bool {
+  module_.setDataLayout(target_machine_->createDataLayout());
+
+  // The summary is computed by module analyses, so this needs the new PM with
+  // the standard analyses registered.
+  llvm::LoopAnalysisManager loop_analyses;
+  llvm::FunctionAnalysisManager function_analyses;
+  llvm::CGSCCAnalysisManager cgscc_analyses;
+  llvm::ModuleAnalysisManager module_analyses;
+  llvm::PassBuilder pass_builder(target_machine_);
+  pass_builder.registerModuleAnalyses(module_analyses);
+  pass_builder.registerCGSCCAnalyses(cgscc_analyses);
+  pass_builder.registerFunctionAnalyses(function_analyses);
+  pass_builder.registerLoopAnalyses(loop_analyses);
+  pass_builder.crossRegisterProxies(loop_analyses, function_analyses,
+                                    cgscc_analyses, module_analyses);
+
+  llvm::ModulePassManager passes;
+  passes.addPass(llvm::ThinLTOBitcodeWriterPass(out, /*ThinLinkOS=*/nullptr));
+  passes.run(module_, module_analyses);
+  return true;
+}
+
 auto CodeGen::EmitCode(llvm::raw_pwrite_stream& out,
                        llvm::CodeGenFileType file_type) -> bool {
   module_.setDataLayout(target_machine_->createDataLayout());
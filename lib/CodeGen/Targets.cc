@@ -0,0 +1,64 @@
+#include "Cocktail/CodeGen/Targets.h"
+
+#include <iterator>
+#include <mutex>
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/TargetParser/Triple.h"
+
+namespace Cocktail {
+
+// Initializes everything codegen needs from one backend.
+#define COCKTAIL_CODEGEN_BACKEND(Name, ArchPrefix) \
+  static auto Initialize##Name() -> void {       \
+    LLVMInitialize##Name##TargetInfo();          \
+    LLVMInitialize##Name##Target();              \
+    LLVMInitialize##Name##TargetMC();            \
+    LLVMInitialize##Name##AsmParser();           \
+    LLVMInitialize##Name##AsmPrinter();          \
+  }
+#include "Cocktail/CodeGen/Backends.def"
+
+namespace {
+struct Backend {
+  llvm::StringLiteral arch_prefix;
+  auto (*initialize)() -> void;
+};
+}  // namespace
+
+static constexpr Backend Backends[] = {
+#define COCKTAIL_CODEGEN_BACKEND(Name, ArchPrefix) \
+  {ArchPrefix, &Initialize##Name},
+#include "Cocktail/CodeGen/Backends.def"
+};
+
+static constexpr llvm::StringLiteral BackendNames[] = {
+#define COCKTAIL_CODEGEN_BACKEND(Name, ArchPrefix) #Name,
+#include "Cocktail/CodeGen/Backends.def"
+};
+
+auto GetCompiledInBackends() -> llvm::ArrayRef<llvm::StringLiteral> {
+  return BackendNames;
+}
+
+auto InitializeTargetForTriple(llvm::StringRef target_triple,
+                               llvm::raw_ostream& errors) -> bool {
+  static std::once_flag initialized[std::size(Backends)];
+
+  llvm::StringRef arch_prefix =
+      llvm::Triple::getArchTypePrefix(llvm::Triple(target_triple).getArch());
+  for (int i = 0; i < static_cast<int>(std::size(Backends)); ++i) {
+    if (Backends[i].arch_prefix == arch_prefix) {
+      std::call_once(initialized[i], Backends[i].initialize);
+      return true;
+    }
+  }
+
+  errors << "ERROR: No backend for target '" << target_triple
+         << "' is compiled in. Available backends: "
+         << llvm::join(GetCompiledInBackends(), ", ") << "\n";
+  return false;
+}
+
+}  // namespace Cocktail
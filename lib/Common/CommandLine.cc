@@ -4,7 +4,9 @@
 #include <memory>
 #include <optional>
 
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 namespace Cocktail::CommandLine {
 
@@ -1494,4 +1496,53 @@ auto Parse(llvm::ArrayRef<llvm::StringRef> unparsed_args,
   return parser.Parse(unparsed_args);
 }
 
-}  // namespace Cocktail::CommandLine
\ No newline at end of file
+// Response files that refer to each other in a cycle would otherwise expand
+// forever.
+static constexpr int MaxResponseFileDepth = 16;
+
+static auto ExpandResponseFilesImpl(
+    llvm::ArrayRef<llvm::StringRef> args, llvm::vfs::FileSystem& fs,
+    llvm::StringSaver& saver,
+    llvm::SmallVectorImpl<llvm::StringRef>& expanded_args,
+    llvm::raw_ostream& errors, int depth) -> bool {
+  for (llvm::StringRef arg : args) {
+    if (!arg.consume_front("@")) {
+      expanded_args.push_back(arg);
+      continue;
+    }
+    if (depth == MaxResponseFileDepth) {
+      errors << "ERROR: Response files nested more than "
+             << MaxResponseFileDepth << " deep at `@" << arg << "`\n";
+      return false;
+    }
+
+    auto buffer = fs.getBufferForFile(arg, /*FileSize=*/-1,
+                                      /*RequiresNullTerminator=*/false);
+    if (!buffer) {
+      errors << "ERROR: Unable to read response file `" << arg
+             << "`: " << buffer.getError().message() << "\n";
+      return false;
+    }
+    llvm::SmallVector<const char*> file_args;
+    llvm::cl::TokenizeGNUCommandLine((*buffer)->getBuffer(), saver, file_args,
+                                     /*MarkEOLs=*/false);
+    llvm::SmallVector<llvm::StringRef> file_arg_refs(file_args.begin(),
+                                                     file_args.end());
+    if (!ExpandResponseFilesImpl(file_arg_refs, fs, saver, expanded_args,
+                                 errors, depth + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto ExpandResponseFiles(llvm::ArrayRef<llvm::StringRef> args,
+                         llvm::vfs::FileSystem& fs, llvm::StringSaver& saver,
+                         llvm::SmallVectorImpl<llvm::StringRef>& expanded_args,
+                         llvm::raw_ostream& errors) -> bool {
+  expanded_args.reserve(expanded_args.size() + args.size());
+  return ExpandResponseFilesImpl(args, fs, saver, expanded_args, errors,
+                                 /*depth=*/0);
+}
+
+}  // namespace Cocktail::CommandLine
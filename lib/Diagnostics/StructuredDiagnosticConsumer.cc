@@ -0,0 +1,191 @@
+#include "Cocktail/Diagnostics/StructuredDiagnosticConsumer.h"
+
+#include <cstdint>
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/ErrorHandling.h"
+
+namespace Cocktail {
+namespace {
+
+// 在写入下层输出流时对 JSON 字符串内容进行转义。
+//
+// 它不带缓冲，格式化消息时的每一段输出都会立即转义并写入下层流。
+class JsonEscapingOstream : public llvm::raw_ostream {
+ public:
+  explicit JsonEscapingOstream(llvm::raw_ostream& out) : out_(&out) {
+    SetUnbuffered();
+  }
+
+ private:
+  auto write_impl(const char* ptr, size_t size) -> void override {
+    pos_ += size;
+    for (char c : llvm::StringRef(ptr, size)) {
+      switch (c) {
+        case '"':
+          *out_ << "\\\"";
+          break;
+        case '\\':
+          *out_ << "\\\\";
+          break;
+        case '\n':
+          *out_ << "\\n";
+          break;
+        case '\r':
+          *out_ << "\\r";
+          break;
+        case '\t':
+          *out_ << "\\t";
+          break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20) {
+            *out_ << "\\u00";
+            out_->write_hex(static_cast<unsigned char>(c) >> 4);
+            out_->write_hex(static_cast<unsigned char>(c) & 0xF);
+          } else {
+            *out_ << c;
+          }
+          break;
+      }
+    }
+  }
+
+  auto current_pos() const -> uint64_t override { return pos_; }
+
+  llvm::raw_ostream* out_;
+  uint64_t pos_ = 0;
+};
+
+// 写入一个带引号并转义的 JSON 字符串。
+auto WriteJsonString(llvm::raw_ostream& out, llvm::StringRef str) -> void {
+  out << '"';
+  JsonEscapingOstream(out) << str;
+  out << '"';
+}
+
+// 将消息文本作为 JSON 字符串直接格式化到输出流。
+auto WriteJsonMessage(llvm::raw_ostream& out, const DiagnosticMessage& message)
+    -> void {
+  out << '"';
+  {
+    JsonEscapingOstream escaped(out);
+    message.FormatTo(escaped);
+  }
+  out << '"';
+}
+
+auto GetLevelName(DiagnosticLevel level) -> llvm::StringLiteral {
+  switch (level) {
+    case DiagnosticLevel::Note:
+      return "note";
+    case DiagnosticLevel::Warning:
+      return "warning";
+    case DiagnosticLevel::Error:
+      return "error";
+  }
+  llvm_unreachable("All levels handled!");
+}
+
+// 写出 JSON Lines 记录中一条消息共有的字段。
+auto WriteJsonLinesMessageFields(llvm::raw_ostream& out,
+                                 const DiagnosticMessage& message) -> void {
+  auto location = message.location.Resolve();
+  out << "\"kind\":";
+  WriteJsonString(out, message.kind.name());
+  out << ",\"file\":";
+  WriteJsonString(out, location.file_name);
+  out << ",\"line\":" << location.line_number
+      << ",\"column\":" << location.column_number << ",\"message\":";
+  WriteJsonMessage(out, message);
+}
+
+// 写出一个 SARIF physicalLocation 对象。没有行号的位置只包含文件。
+auto WriteSarifPhysicalLocation(llvm::raw_ostream& out,
+                                const DiagnosticLocation& location) -> void {
+  out << "{\"artifactLocation\":{\"uri\":";
+  WriteJsonString(out, location.file_name);
+  out << "}";
+  if (location.line_number > 0) {
+    out << ",\"region\":{\"startLine\":" << location.line_number;
+    if (location.column_number > 0) {
+      out << ",\"startColumn\":" << location.column_number;
+    }
+    out << "}";
+  }
+  out << "}";
+}
+
+}  // namespace
+
+auto JsonLinesDiagnosticConsumer::HandleDiagnostic(Diagnostic diagnostic)
+    -> void {
+  *stream_ << "{";
+  WriteJsonLinesMessageFields(*stream_, diagnostic.message);
+  *stream_ << ",\"level\":";
+  WriteJsonString(*stream_, GetLevelName(diagnostic.level));
+  *stream_ << ",\"notes\":[";
+  llvm::ListSeparator sep(",");
+  for (const auto& note : diagnostic.notes) {
+    *stream_ << sep << "{";
+    WriteJsonLinesMessageFields(*stream_, note);
+    *stream_ << "}";
+  }
+  *stream_ << "]}\n";
+}
+
+auto JsonLinesDiagnosticConsumer::Flush() -> void {
+  stream_->flush();
+  ResetArena();
+}
+
+SarifDiagnosticConsumer::SarifDiagnosticConsumer(llvm::raw_ostream& stream)
+    : stream_(&stream) {
+  *stream_ << "{\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\","
+              "\"version\":\"2.1.0\",\"runs\":[{\"tool\":{\"driver\":"
+              "{\"name\":\"cocktail\"}},\"results\":[";
+}
+
+SarifDiagnosticConsumer::~SarifDiagnosticConsumer() {
+  *stream_ << "\n]}]}\n";
+  stream_->flush();
+}
+
+auto SarifDiagnosticConsumer::HandleDiagnostic(Diagnostic diagnostic) -> void {
+  if (has_results_) {
+    *stream_ << ",";
+  }
+  has_results_ = true;
+
+  const auto& message = diagnostic.message;
+  *stream_ << "\n{\"ruleId\":";
+  WriteJsonString(*stream_, message.kind.name());
+  *stream_ << ",\"level\":";
+  WriteJsonString(*stream_, GetLevelName(diagnostic.level));
+  *stream_ << ",\"message\":{\"text\":";
+  WriteJsonMessage(*stream_, message);
+  *stream_ << "},\"locations\":[{\"physicalLocation\":";
+  WriteSarifPhysicalLocation(*stream_, message.location.Resolve());
+  *stream_ << "}]";
+
+  if (!diagnostic.notes.empty()) {
+    *stream_ << ",\"relatedLocations\":[";
+    llvm::ListSeparator sep(",");
+    for (const auto& note : diagnostic.notes) {
+      *stream_ << sep << "{\"message\":{\"text\":";
+      WriteJsonMessage(*stream_, note);
+      *stream_ << "},\"physicalLocation\":";
+      WriteSarifPhysicalLocation(*stream_, note.location.Resolve());
+      *stream_ << "}";
+    }
+    *stream_ << "]";
+  }
+  *stream_ << "}";
+}
+
+auto SarifDiagnosticConsumer::Flush() -> void {
+  stream_->flush();
+  ResetArena();
+}
+
+}  // namespace Cocktail
@@ -1,25 +1,164 @@
 #include "Cocktail/Driver/Driver.h"
 
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
 #include "Cocktail/Check/Check.h"
 #include "Cocktail/CodeGen/CodeGen.h"
 #include "Cocktail/Common/CommandLine.h"
 #include "Cocktail/Common/VLog.h"
 #include "Cocktail/Diagnostics/DiagnosticEmitter.h"
+#include "Cocktail/Diagnostics/ErrorLimitingDiagnosticConsumer.h"
 #include "Cocktail/Diagnostics/SortingDiagnosticConsumer.h"
+#include "Cocktail/Diagnostics/StructuredDiagnosticConsumer.h"
+#include "Cocktail/Interpret/Interpret.h"
 #include "Cocktail/Lex/TokenizedBuffer.h"
 #include "Cocktail/Lower/Lower.h"
 #include "Cocktail/Parse/Tree.h"
 #include "Cocktail/SemIR/Formatter.h"
 #include "Cocktail/Source/SourceBuffer.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/StringSaver.h"
+#include "llvm/Target/TargetMachine.h"
 #include "llvm/TargetParser/Host.h"
 
 namespace Cocktail {
+
+namespace {
+// A queue between two pipeline stages, holding at most `capacity` values so
+// that a fast stage can't run arbitrarily far ahead of a slow one.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(int capacity) : capacity_(capacity) {}
+
+  // Adds a value, blocking while the queue is full.
+  auto Push(T value) -> void {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [&] {
+      return static_cast<int>(values_.size()) < capacity_;
+    });
+    values_.push_back(std::move(value));
+    not_empty_.notify_one();
+  }
+
+  // Marks that no more values will be pushed.
+  auto Close() -> void {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+  // Removes the next value, blocking while the queue is empty. Returns
+  // nullopt once the queue is closed and drained.
+  auto Pop() -> std::optional<T> {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [&] { return !values_.empty() || closed_; });
+    if (values_.empty()) {
+      return std::nullopt;
+    }
+    T value = std::move(values_.front());
+    values_.pop_front();
+    not_full_.notify_one();
+    return value;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::deque<T> values_;
+  int capacity_;
+  bool closed_ = false;
+};
+
+// Returns the peak resident set size of the process so far, in bytes.
+auto GetPeakRssBytes() -> int64_t {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  // Linux reports kilobytes.
+  return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+// Collects `--time-report` data: the wall time of each step summed across
+// units, the peak RSS when each step last finished, and how many units freed
+// their data early. Steps may finish on different threads.
+class TimeReport {
+ public:
+  // Records that one run of the step `label` took `seconds`.
+  auto AddStep(llvm::StringLiteral label, double seconds) -> void {
+    int64_t peak_rss_bytes = GetPeakRssBytes();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto* step = llvm::find_if(
+        steps_, [&](const Step& step) { return step.label == label; });
+    if (step == steps_.end()) {
+      steps_.push_back({.label = label});
+      step = &steps_.back();
+    }
+    step->seconds += seconds;
+    step->peak_rss_bytes = peak_rss_bytes;
+  }
+
+  std::atomic<int> released_front_ends = 0;
+  std::atomic<int> released_sem_irs = 0;
+  std::atomic<int> released_modules = 0;
+
+  auto Print(llvm::raw_ostream& out, bool memory_lean) -> void {
+    constexpr double MiB = 1024.0 * 1024.0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    out << "===== Time report =====\n";
+    for (const auto& step : steps_) {
+      out << llvm::format("%10.4fs  %9.1f MiB peak RSS  ", step.seconds,
+                          step.peak_rss_bytes / MiB)
+          << step.label << "\n";
+    }
+    out << llvm::format("Peak RSS: %.1f MiB", GetPeakRssBytes() / MiB)
+        << " (memory-lean " << (memory_lean ? "on" : "off") << ")\n"
+        << "Freed early: " << released_front_ends << " front ends, "
+        << released_sem_irs << " SemIR files, " << released_modules
+        << " LLVM modules\n";
+  }
+
+ private:
+  struct Step {
+    llvm::StringLiteral label;
+    double seconds = 0;
+    int64_t peak_rss_bytes = 0;
+  };
+
+  std::mutex mutex_;
+  llvm::SmallVector<Step> steps_;
+};
+}  // namespace
+
 struct Driver::CompileOptions {
   static constexpr CommandLine::CommandInfo Info = {
       .name = "compile",
@@ -66,18 +205,46 @@ can be written to standard output as these phases progress.
     return out;
   }
 
+  enum class Emit : int8_t {
+    Object,
+    Assembly,
+    Bitcode,
+    ThinLTOBitcode,
+  };
+
+  enum class DiagnosticsFormat : int8_t {
+    Text,
+    JsonLines,
+    Sarif,
+  };
+
   void Build(CommandLine::CommandBuilder& b) {
     b.AddStringPositionalArg(
         {
             .name = "FILE",
             .help = R"""(
 The input Carbon source file to compile.
+
+At least one input is required, either as a `FILE` or through `--input-dir`.
+Arguments of the form `@FILE` are replaced by the whitespace-separated
+arguments read from that response file.
 )""",
         },
-        [&](auto& arg_b) {
-          arg_b.Required(true);
-          arg_b.Append(&input_file_names);
-        });
+        [&](auto& arg_b) { arg_b.Append(&input_file_names); });
+
+    b.AddStringOption(
+        {
+            .name = "input-dir",
+            .value_name = "DIR",
+            .help = R"""(
+A directory to search recursively for `*.cocktail` input files.
+
+Each file found is compiled as if it were passed as a `FILE`, and is started as
+soon as it's found. The entries of each directory are searched in sorted order.
+It's an error if no `*.cocktail` files are found. May be given more than once.
+)""",
+        },
+        [&](auto& arg_b) { arg_b.Append(&input_dirs); });
 
     b.AddOneOfOption(
         {
@@ -120,6 +287,33 @@ assembly. Binary object output can be forced by enabling `--force-obj-output`.
         },
         [&](auto& arg_b) { arg_b.Set(&output_file_name); });
 
+    b.AddOneOfOption(
+        {
+            .name = "emit",
+            .help = R"""(
+Selects the kind of output written by codegen.
+
+- `obj` writes a native object file, or textual assembly as described for
+  `--output`. This is the default.
+- `asm` writes textual assembly.
+- `bc` writes LLVM bitcode without running the backend.
+- `thinlto-bc` writes LLVM bitcode with a ThinLTO module summary, suitable for
+  linking with other ThinLTO objects.
+
+The flags `--asm-output` and `--force-obj-output` only apply to `--emit=obj`.
+)""",
+        },
+        [&](auto& arg_b) {
+          arg_b.SetOneOf(
+              {
+                  arg_b.OneOfValue("obj", Emit::Object).Default(true),
+                  arg_b.OneOfValue("asm", Emit::Assembly),
+                  arg_b.OneOfValue("bc", Emit::Bitcode),
+                  arg_b.OneOfValue("thinlto-bc", Emit::ThinLTOBitcode),
+              },
+              &emit);
+        });
+
     b.AddStringOption(
         {
             .name = "target",
@@ -162,6 +356,104 @@ of a binary object file instead. Ignored for other `--output` values.
         },
         [&](auto& arg_b) { arg_b.Set(&force_obj_output); });
 
+    b.AddIntegerOption(
+        {
+            .name = "lower-threads",
+            .value_name = "N",
+            .help = R"""(
+The number of threads to use when lowering each file to LLVM IR.
+
+Function definitions are split across this many shards, each lowered in its own
+LLVM context on its own thread and then linked back into a single module. The
+default of 1 lowers on the main thread. Passing 0 uses one thread per hardware
+thread. Lowering always uses a single thread when `--verbose` is enabled.
+)""",
+        },
+        [&](auto& arg_b) {
+          arg_b.Default(1);
+          arg_b.Set(&lower_threads);
+        });
+
+    b.AddOneOfOption(
+        {
+            .name = "diagnostics-format",
+            .help = R"""(
+Selects how diagnostics are written to stderr.
+
+- `text` writes each diagnostic with its source line and a caret, for humans.
+  This is the default.
+- `jsonl` writes one JSON object per line for each diagnostic, holding its kind,
+  level, file, line, column, message and notes.
+- `sarif` writes a single SARIF 2.1.0 document with one result per diagnostic.
+)""",
+        },
+        [&](auto& arg_b) {
+          arg_b.SetOneOf(
+              {
+                  arg_b.OneOfValue("text", DiagnosticsFormat::Text)
+                      .Default(true),
+                  arg_b.OneOfValue("jsonl", DiagnosticsFormat::JsonLines),
+                  arg_b.OneOfValue("sarif", DiagnosticsFormat::Sarif),
+              },
+              &diagnostics_format);
+        });
+
+    b.AddIntegerOption(
+        {
+            .name = "error-limit",
+            .value_name = "N",
+            .help = R"""(
+Stop compiling a file after N errors have been reported for it.
+
+Once the limit is reached, the current phase stops early, later diagnostics for
+the file are dropped, and later phases are skipped for it. The default of 0
+reports every error.
+)""",
+        },
+        [&](auto& arg_b) {
+          arg_b.Default(0);
+          arg_b.Set(&error_limit);
+        });
+
+    b.AddFlag(
+        {
+            .name = "memory-lean",
+            .help = R"""(
+Free each file's SemIR and LLVM module early, to lower peak memory use for large
+batches.
+
+SemIR is freed after lowering, and the LLVM module after code generation.
+Lowering and code generation run one file at a time, instead of lowering every
+file before generating code for any. With `--stream-errors`, `--verbose` or a
+front-end dump, which keep the phases unpipelined, the tokens and parse tree are
+also freed after checking, as the pipelined front end always does.
+)""",
+        },
+        [&](auto& arg_b) { arg_b.Set(&memory_lean); });
+
+    b.AddFlag(
+        {
+            .name = "time-report",
+            .help = R"""(
+Print the time spent in each step, summed across files, and the peak resident
+memory, to stderr once compilation finishes.
+)""",
+        },
+        [&](auto& arg_b) { arg_b.Set(&time_report); });
+
+    b.AddFlag(
+        {
+            .name = "interpret",
+            .help = R"""(
+Run each file's `Run` function with the SemIR interpreter once it's checked,
+instead of lowering it.
+
+Prints `FILE: Run returned N` to stdout for each file. Lowering and code
+generation are skipped, so this requires a phase of `check` or later.
+)""",
+        },
+        [&](auto& arg_b) { arg_b.Set(&interpret); });
+
     b.AddFlag(
         {
             .name = "stream-errors",
@@ -240,12 +532,18 @@ Dump the generated assembly to stdout after codegen.
   }
 
   Phase phase;
+  Emit emit;
+  DiagnosticsFormat diagnostics_format;
 
   std::string host = llvm::sys::getDefaultTargetTriple();
   llvm::StringRef target;
 
   llvm::StringRef output_file_name;
   llvm::SmallVector<llvm::StringRef> input_file_names;
+  llvm::SmallVector<llvm::StringRef> input_dirs;
+
+  int lower_threads = 1;
+  int error_limit = 0;
 
   bool asm_output = false;
   bool force_obj_output = false;
@@ -258,6 +556,29 @@ Dump the generated assembly to stdout after codegen.
   bool stream_errors = false;
   bool preorder_parse_tree = false;
   bool builtin_sem_ir = false;
+  bool memory_lean = false;
+  bool time_report = false;
+  bool interpret = false;
+};
+
+struct Driver::ServeOptions {
+  static constexpr CommandLine::CommandInfo Info = {
+      .name = "serve",
+      .help = R"""(
+Run commands read from standard input, one per line.
+
+Each line holds the arguments of a single driver invocation, such as
+`compile --phase=check file.cocktail`, split into arguments as a shell would. After each
+command, `serve: ok` or `serve: failed` is written on its own line to standard
+output, and both output streams are flushed.
+
+State that doesn't depend on the inputs, such as the checked builtins and
+target machines, is created once and reused, so this avoids paying process
+startup for each of many small compiles.
+)""",
+  };
+
+  void Build(CommandLine::CommandBuilder& /*b*/) {}
 };
 
 struct Driver::Options {
@@ -282,6 +603,7 @@ For questions, issues, or bug reports, please use our GitHub project:
 
   enum class Subcommand : int8_t {
     Compile,
+    Serve,
   };
 
   void Build(CommandLine::CommandBuilder& b) {
@@ -299,6 +621,12 @@ For questions, issues, or bug reports, please use our GitHub project:
                       sub_b.Do([&] { subcommand = Subcommand::Compile; });
                     });
 
+    b.AddSubcommand(ServeOptions::Info,
+                    [&](CommandLine::CommandBuilder& sub_b) {
+                      serve_options.Build(sub_b);
+                      sub_b.Do([&] { subcommand = Subcommand::Serve; });
+                    });
+
     b.RequiresSubcommand();
   }
 
@@ -306,18 +634,28 @@ For questions, issues, or bug reports, please use our GitHub project:
   Subcommand subcommand;
 
   CompileOptions compile_options;
+  ServeOptions serve_options;
 };
 
-auto Driver::ParseArgs(llvm::ArrayRef<llvm::StringRef> args, Options& options)
+auto Driver::ParseArgs(llvm::ArrayRef<llvm::StringRef> args,
+                       llvm::StringSaver& arg_saver, Options& options)
     -> CommandLine::ParseResult {
+  llvm::SmallVector<llvm::StringRef> expanded_args;
+  if (!CommandLine::ExpandResponseFiles(args, fs_, arg_saver, expanded_args,
+                                        error_stream_)) {
+    return CommandLine::ParseResult::Error;
+  }
   return CommandLine::Parse(
-      args, output_stream_, error_stream_, Options::Info,
+      expanded_args, output_stream_, error_stream_, Options::Info,
       [&](CommandLine::CommandBuilder& b) { options.Build(b); });
 }
 
 auto Driver::RunCommand(llvm::ArrayRef<llvm::StringRef> args) -> bool {
+  // Holds arguments read from response files, which `options` refers to.
+  llvm::BumpPtrAllocator arg_allocator;
+  llvm::StringSaver arg_saver(arg_allocator);
   Options options;
-  CommandLine::ParseResult result = ParseArgs(args, options);
+  CommandLine::ParseResult result = ParseArgs(args, arg_saver, options);
   if (result == CommandLine::ParseResult::Error) {
     return false;
   } else if (result == CommandLine::ParseResult::MetaSuccess) {
@@ -332,13 +670,38 @@ auto Driver::RunCommand(llvm::ArrayRef<llvm::StringRef> args) -> bool {
   switch (options.subcommand) {
     case Options::Subcommand::Compile:
       return Compile(options.compile_options);
+    case Options::Subcommand::Serve:
+      if (serving_) {
+        error_stream_ << "ERROR: `serve` can't be nested\n";
+        return false;
+      }
+      return Serve(std::cin);
   }
   llvm_unreachable("All subcommands handled!");
 }
 
 auto Driver::ValidateCompileOptions(const CompileOptions& options) const
     -> bool {
+  if (options.input_file_names.empty() && options.input_dirs.empty()) {
+    error_stream_ << "ERROR: No input files; pass a `FILE` or `--input-dir`\n";
+    return false;
+  }
+
+  if (options.lower_threads < 0) {
+    error_stream_ << "ERROR: `--lower-threads` must not be negative, but is "
+                  << options.lower_threads << "\n";
+    return false;
+  }
+
   using Phase = CompileOptions::Phase;
+  if (options.interpret &&
+      (options.phase == Phase::Lex || options.phase == Phase::Parse)) {
+    error_stream_ << "ERROR: Requested interpreting but compile phase is "
+                     "limited to '"
+                  << options.phase << "'\n";
+    return false;
+  }
+
   switch (options.phase) {
     case Phase::Lex:
       if (options.dump_parse_tree) {
@@ -372,22 +735,41 @@ auto Driver::ValidateCompileOptions(const CompileOptions& options) const
   return true;
 }
 
+namespace {
+// Locates driver diagnostics that are about a whole input file.
+struct FilenameTranslator : DiagnosticLocationTranslator<llvm::StringRef> {
+  auto GetLocation(llvm::StringRef filename) -> DiagnosticLocation override {
+    return {.file_name = filename};
+  }
+};
+}  // namespace
+
 // Ties together information for a file being compiled.
 class Driver::CompilationUnit {
  public:
+  // Diagnostics are eventually written by `output_consumer`, which is shared
+  // by all units. Timings are added to `time_report` when it's not null.
   explicit CompilationUnit(Driver* driver, const CompileOptions& options,
-                           llvm::StringRef input_file_name)
+                           llvm::StringRef input_file_name,
+                           DiagnosticConsumer& output_consumer,
+                           TimeReport* time_report)
       : driver_(driver),
         options_(options),
         input_file_name_(input_file_name),
         vlog_stream_(driver_->vlog_stream_),
-        stream_consumer_(driver_->error_stream_) {
+        time_report_(time_report),
+        file_emitter_(file_translator_, output_consumer),
+        error_text_stream_(error_text_) {
     if (vlog_stream_ != nullptr || options_.stream_errors) {
-      consumer_ = &stream_consumer_;
+      consumer_ = &output_consumer;
     } else {
-      sorting_consumer_ = SortingDiagnosticConsumer(stream_consumer_);
+      sorting_consumer_.emplace(output_consumer);
       consumer_ = &*sorting_consumer_;
     }
+    if (options_.error_limit > 0) {
+      error_limiting_consumer_.emplace(*consumer_, options_.error_limit);
+      consumer_ = &*error_limiting_consumer_;
+    }
   }
 
   // Loads source and lexes it. Returns true on success.
@@ -404,8 +786,11 @@ class Driver::CompilationUnit {
 
     LogCall("Lex::TokenizedBuffer::Lex",
             [&] { tokens_ = Lex::TokenizedBuffer::Lex(*source_, *consumer_); });
+    if (CheckErrorLimit("lex")) {
+      return false;
+    }
     if (options_.dump_tokens) {
-      consumer_->Flush();
+      Flush();
       //llvm::Optional<Lex::TokenizedBuffer> tokens_opt;
       //if (tokens_.has_value()) {
       //  tokens_opt = *tokens_;
@@ -418,8 +803,9 @@ class Driver::CompilationUnit {
 
   // Parses tokens. Returns true on success.
   auto RunParse() -> bool {
-    // Can be called when the file fails to load, so ensure there's source.
-    if (!source_) {
+    // Can be called when the file fails to load or stopped at the error limit,
+    // so ensure there's source and that the limit wasn't reached.
+    if (!source_ || truncated_) {
       return false;
     }
     COCKTAIL_CHECK(tokens_);
@@ -427,8 +813,11 @@ class Driver::CompilationUnit {
     LogCall("Parse::Tree::Parse", [&] {
       parse_tree_ = Parse::Tree::Parse(*tokens_, *consumer_, vlog_stream_);
     });
+    if (CheckErrorLimit("parse")) {
+      return false;
+    }
     if (options_.dump_parse_tree) {
-      consumer_->Flush();
+      Flush();
       parse_tree_->Print(driver_->output_stream_, options_.preorder_parse_tree);
     }
     //COCKTAIL_VLOG() << "*** Parse::Tree ***\n" << parse_tree_;
@@ -437,8 +826,9 @@ class Driver::CompilationUnit {
 
   // Check the parse tree and produce SemIR. Returns true on success.
   auto RunCheck(const SemIR::File& builtins) -> bool {
-    // Can be called when the file fails to load, so ensure there's source.
-    if (!source_) {
+    // Can be called when the file fails to load or stopped at the error limit,
+    // so ensure there's source and that the limit wasn't reached.
+    if (!source_ || truncated_) {
       return false;
     }
     COCKTAIL_CHECK(parse_tree_);
@@ -451,7 +841,8 @@ class Driver::CompilationUnit {
     // We've finished all steps that can produce diagnostics. Emit the
     // diagnostics now, so that the developer sees them sooner and doesn't need
     // to wait for code generation.
-    consumer_->Flush();
+    CheckErrorLimit("check");
+    Flush();
 
     COCKTAIL_VLOG() << "*** Raw SemIR::File ***\n" << *sem_ir_ << "\n";
     if (options_.dump_raw_sem_ir) {
@@ -472,14 +863,41 @@ class Driver::CompilationUnit {
     return !sem_ir_->has_errors();
   }
 
+  // Runs the entry point with the SemIR interpreter and prints its result.
+  // Returns true on success.
+  auto RunInterpret() -> bool {
+    COCKTAIL_CHECK(sem_ir_);
+
+    std::optional<ErrorOr<int32_t>> result;
+    LogCall("Interpret::InterpretEntryPoint", [&] {
+      result = Interpret::InterpretEntryPoint(*sem_ir_, Interpret::Limits(),
+                                              vlog_stream_);
+    });
+    if (!result->ok()) {
+      text_errors() << "ERROR: " << input_file_name_ << ": " << result->error()
+                    << "\n";
+      ReportTextErrors();
+      return false;
+    }
+    driver_->output_stream_ << input_file_name_ << ": Run returned "
+                            << **result << "\n";
+    return true;
+  }
+
   // Lower SemIR to LLVM IR.
   auto RunLower() -> void {
     COCKTAIL_CHECK(sem_ir_);
 
-    LogCall("Lower::LowerToLLVM", [&] {
+    LogCall("Lower::LowerToLLVMParallel", [&] {
+      int num_threads = options_.lower_threads;
+      if (num_threads == 0) {
+        num_threads =
+            static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+      }
       llvm_context_ = std::make_unique<llvm::LLVMContext>();
-      module_ = Lower::LowerToLLVM(*llvm_context_, input_file_name_, *sem_ir_,
-                                   vlog_stream_);
+      module_ = Lower::LowerToLLVMParallel(*llvm_context_, input_file_name_,
+                                           *sem_ir_, num_threads,
+                                           vlog_stream_);
     });
     if (vlog_stream_) {
       COCKTAIL_VLOG() << "*** llvm::Module ***\n";
@@ -496,37 +914,53 @@ class Driver::CompilationUnit {
   // Do codegen. Returns true on success.
   auto RunCodeGen() -> bool {
     COCKTAIL_CHECK(module_);
+    auto report_errors = llvm::make_scope_exit([&] { ReportTextErrors(); });
+    auto start = std::chrono::steady_clock::now();
+    auto add_time = llvm::make_scope_exit([&] {
+      if (time_report_) {
+        time_report_->AddStep(
+            "CodeGen",
+            std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                          start)
+                .count());
+      }
+    });
 
     COCKTAIL_VLOG() << "*** CodeGen ***\n";
-    std::optional<CodeGen> codegen =
-        CodeGen::Create(*module_, options_.target, driver_->error_stream_);
-    if (!codegen) {
+    llvm::TargetMachine* target_machine =
+        driver_->GetTargetMachine(options_.target, text_errors());
+    if (!target_machine) {
       return false;
     }
+    std::optional<CodeGen> codegen =
+        CodeGen::Create(*module_, *target_machine, text_errors());
     if (vlog_stream_) {
       COCKTAIL_VLOG() << "*** Assembly ***\n";
       codegen->EmitAssembly(*vlog_stream_);
     }
 
+    // `--asm-output` and `--force-obj-output` refine the default object
+    // output.
+    // TODO: the output file name, forcing object output, and requesting
+    // textual assembly output are all somewhat linked flags. We should add
+    // some validation that they are used correctly.
+    auto emit = options_.emit;
+    if (emit == CompileOptions::Emit::Object &&
+        (options_.output_file_name == "-" ? !options_.force_obj_output
+                                          : options_.asm_output)) {
+      emit = CompileOptions::Emit::Assembly;
+    }
+
     if (options_.output_file_name == "-") {
-      // TODO: the output file name, forcing object output, and requesting
-      // textual assembly output are all somewhat linked flags. We should add
-      // some validation that they are used correctly.
-      if (options_.force_obj_output) {
-        if (!codegen->EmitObject(driver_->output_stream_)) {
-          return false;
-        }
-      } else {
-        if (!codegen->EmitAssembly(driver_->output_stream_)) {
-          return false;
-        }
+      if (!EmitOutput(*codegen, emit, driver_->output_stream_)) {
+        return false;
       }
     } else {
       llvm::SmallString<256> output_file_name = options_.output_file_name;
       if (output_file_name.empty()) {
         output_file_name = input_file_name_;
         llvm::sys::path::replace_extension(output_file_name,
-                                           options_.asm_output ? ".s" : ".o");
+                                           GetOutputExtension(emit));
       }
       COCKTAIL_VLOG() << "Writing output to: " << output_file_name << "\n";
 
@@ -534,49 +968,176 @@ class Driver::CompilationUnit {
       llvm::raw_fd_ostream output_file(output_file_name, ec,
                                        llvm::sys::fs::OF_None);
       if (ec) {
-        driver_->error_stream_ << "ERROR: Could not open output file '"
-                               << output_file_name << "': " << ec.message()
-                               << "\n";
+        text_errors() << "ERROR: Could not open output file '"
+                      << output_file_name << "': " << ec.message() << "\n";
         return false;
       }
-      if (options_.asm_output) {
-        if (!codegen->EmitAssembly(output_file)) {
-          return false;
-        }
-      } else {
-        if (!codegen->EmitObject(output_file)) {
-          return false;
-        }
+      if (!EmitOutput(*codegen, emit, output_file)) {
+        return false;
       }
     }
     COCKTAIL_VLOG() << "*** CodeGen done ***\n";
     return true;
   }
 
-  // Flushes output.
-  auto Flush() -> void { consumer_->Flush(); }
+  // Flushes output. Units in a pipeline flush from different threads, so this
+  // is serialized with other units' diagnostics.
+  auto Flush() -> void {
+    std::lock_guard<std::mutex> lock(driver_->diagnostics_mutex_);
+    consumer_->Flush();
+  }
+
+  // Frees the source, tokens and parse tree once checking is done with them.
+  // Lowering only needs SemIR, and diagnostics referring to the source have
+  // already been flushed.
+  auto ReleaseFrontEnd() -> void {
+    parse_tree_.reset();
+    tokens_.reset();
+    source_.reset();
+    if (time_report_) {
+      ++time_report_->released_front_ends;
+    }
+  }
+
+  // Frees SemIR once lowering is done with it.
+  auto ReleaseSemIR() -> void {
+    sem_ir_.reset();
+    if (time_report_) {
+      ++time_report_->released_sem_irs;
+    }
+  }
+
+  // Frees the LLVM module and its context once its output is written.
+  auto ReleaseModule() -> void {
+    module_.reset();
+    llvm_context_.reset();
+    if (time_report_) {
+      ++time_report_->released_modules;
+    }
+  }
 
  private:
+  // Returns the default output file extension for `emit`.
+  static auto GetOutputExtension(CompileOptions::Emit emit) -> llvm::StringRef {
+    switch (emit) {
+      case CompileOptions::Emit::Object:
+        return ".o";
+      case CompileOptions::Emit::Assembly:
+        return ".s";
+      case CompileOptions::Emit::Bitcode:
+      case CompileOptions::Emit::ThinLTOBitcode:
+        return ".bc";
+    }
+    llvm_unreachable("All emit kinds handled!");
+  }
+
+  // Writes the `emit` kind of output for the module to `out`. Returns true on
+  // success.
+  static auto EmitOutput(CodeGen& codegen, CompileOptions::Emit emit,
+                         llvm::raw_pwrite_stream& out) -> bool {
+    switch (emit) {
+      case CompileOptions::Emit::Object:
+        return codegen.EmitObject(out);
+      case CompileOptions::Emit::Assembly:
+        return codegen.EmitAssembly(out);
+      case CompileOptions::Emit::Bitcode:
+        return codegen.EmitBitcode(out);
+      case CompileOptions::Emit::ThinLTOBitcode:
+        return codegen.EmitThinLTOBitcode(out);
+    }
+    llvm_unreachable("All emit kinds handled!");
+  }
+
+  // If the error limit was reached during `phase`, flushes the diagnostics
+  // reported so far, notes that the phase stopped early, and marks the unit as
+  // truncated so that later phases are skipped. Returns true if truncated.
+  auto CheckErrorLimit(llvm::StringLiteral phase) -> bool {
+    if (!error_limiting_consumer_ ||
+        !error_limiting_consumer_->limit_reached()) {
+      return false;
+    }
+    truncated_ = true;
+    std::lock_guard<std::mutex> lock(driver_->diagnostics_mutex_);
+    consumer_->Flush();
+    // Reported past the error limit, which would drop it.
+    const auto& limiter = *error_limiting_consumer_;
+    COCKTAIL_DIAGNOSTIC(ErrorLimitReached, Warning,
+                        "Stopped {0} after {1} errors (--error-limit); {2} "
+                        "later diagnostics were not reported.",
+                        llvm::StringRef, int32_t, int64_t);
+    file_emitter_.Emit(input_file_name_, ErrorLimitReached, phase,
+                       limiter.error_count(), limiter.dropped_count());
+    return true;
+  }
+
+  // Returns the stream for errors that are only available as text, such as
+  // those from CodeGen. With the text diagnostics format this is stderr.
+  // Otherwise the text is kept for ReportTextErrors, so that structured output
+  // holds only diagnostic records.
+  auto text_errors() -> llvm::raw_pwrite_stream& {
+    if (options_.diagnostics_format ==
+        CompileOptions::DiagnosticsFormat::Text) {
+      return driver_->error_stream_;
+    }
+    return error_text_stream_;
+  }
+
+  // Reports each line written to text_errors() as a diagnostic for this file.
+  auto ReportTextErrors() -> void {
+    llvm::SmallVector<llvm::StringRef> lines;
+    llvm::StringRef(error_text_)
+        .split(lines, '\n', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+    for (auto line : lines) {
+      line.consume_front("ERROR: ");
+      // The diagnostic's location already names the file.
+      line.consume_front(input_file_name_ + ": ");
+      COCKTAIL_DIAGNOSTIC(DriverError, Error, "{0}", std::string);
+      file_emitter_.Emit(input_file_name_, DriverError, line.str());
+    }
+    error_text_.clear();
+  }
+
   // Wraps a call with log statements to indicate start and end.
   auto LogCall(llvm::StringLiteral label, llvm::function_ref<void()> fn)
       -> void {
     COCKTAIL_VLOG() << "*** " << label << ": " << input_file_name_ << " ***\n";
+    auto start = std::chrono::steady_clock::now();
     fn();
+    if (time_report_) {
+      time_report_->AddStep(label, std::chrono::duration<double>(
+                                       std::chrono::steady_clock::now() - start)
+                                       .count());
+    }
     COCKTAIL_VLOG() << "*** " << label << " done ***\n";
   }
 
   Driver* driver_;
   const CompileOptions& options_;
-  llvm::StringRef input_file_name_;
+  std::string input_file_name_;
 
   // Copied from driver_ for COCKTAIL_VLOG.
   llvm::raw_pwrite_stream* vlog_stream_;
 
-  // Diagnostics are sent to consumer_, with optional sorting.
-  StreamDiagnosticConsumer stream_consumer_;
+  // Null unless `--time-report` is enabled.
+  TimeReport* time_report_;
+
+  // Diagnostics are sent to consumer_, with optional sorting and error
+  // limiting, before reaching the shared output consumer.
   std::optional<SortingDiagnosticConsumer> sorting_consumer_;
+  std::optional<ErrorLimitingDiagnosticConsumer> error_limiting_consumer_;
   DiagnosticConsumer* consumer_;
 
+  // Reports diagnostics about the whole file straight to the output consumer.
+  FilenameTranslator file_translator_;
+  DiagnosticEmitter<llvm::StringRef> file_emitter_;
+
+  // Errors written to text_errors() with a structured diagnostics format.
+  llvm::SmallString<0> error_text_;
+  llvm::raw_svector_ostream error_text_stream_;
+
+  // Set once the error limit stops a phase early.
+  bool truncated_ = false;
+
   // These are initialized as steps are run.
   std::optional<SourceBuffer> source_;
   std::optional<Lex::TokenizedBuffer> tokens_;
@@ -586,11 +1147,225 @@ class Driver::CompilationUnit {
   std::unique_ptr<llvm::Module> module_;
 };
 
+Driver::Driver(llvm::vfs::FileSystem& fs,
+               llvm::raw_pwrite_stream& output_stream,
+               llvm::raw_pwrite_stream& error_stream)
+    : fs_(fs), output_stream_(output_stream), error_stream_(error_stream) {}
+
+Driver::~Driver() = default;
+
+auto Driver::GetBuiltins() -> const SemIR::File& {
+  if (!builtins_) {
+    // Built in place, because the builtins refer to themselves.
+    builtins_ = std::make_unique<SemIR::File>();
+  }
+  return *builtins_;
+}
+
+auto Driver::GetTargetMachine(llvm::StringRef target_triple,
+                              llvm::raw_pwrite_stream& errors)
+    -> llvm::TargetMachine* {
+  auto [it, inserted] = target_machines_.try_emplace(target_triple);
+  if (inserted) {
+    it->second = CodeGen::CreateTargetMachine(target_triple, errors);
+  } else if (!it->second) {
+    // Report the invalid target again for this command.
+    errors << "ERROR: Invalid target: " << target_triple << "\n";
+  }
+  return it->second.get();
+}
+
+auto Driver::Serve(std::istream& requests) -> bool {
+  // `--verbose` given to `serve` applies to every command.
+  llvm::raw_pwrite_stream* serve_vlog_stream = vlog_stream_;
+  serving_ = true;
+  bool success = true;
+  std::string line;
+  while (std::getline(requests, line)) {
+    // Split the line the way a shell would, so that quoted arguments such as
+    // paths containing spaces stay whole.
+    llvm::BumpPtrAllocator allocator;
+    llvm::StringSaver saver(allocator);
+    llvm::SmallVector<const char*> tokens;
+    llvm::cl::TokenizeGNUCommandLine(line, saver, tokens);
+    if (tokens.empty()) {
+      continue;
+    }
+    llvm::SmallVector<llvm::StringRef> args(tokens.begin(), tokens.end());
+
+    vlog_stream_ = serve_vlog_stream;
+    bool command_success = RunCommand(args);
+    success &= command_success;
+
+    output_stream_ << "serve: " << (command_success ? "ok" : "failed") << "\n";
+    error_stream_.flush();
+    output_stream_.flush();
+  }
+  serving_ = false;
+  return success;
+}
+
+// Calls `fn` with each `*.cocktail` file under `dir`, visiting the entries of
+// each directory in sorted order. Returns the error from listing a directory,
+// if any.
+static auto SearchInputDirectory(llvm::vfs::FileSystem& fs, llvm::StringRef dir,
+                                 llvm::function_ref<void(llvm::StringRef)> fn)
+    -> std::error_code {
+  // Pairs of the entry's path and whether it's a directory.
+  llvm::SmallVector<std::pair<std::string, bool>> entries;
+  std::error_code ec;
+  for (llvm::vfs::directory_iterator it = fs.dir_begin(dir, ec), end;
+       !ec && it != end; it.increment(ec)) {
+    entries.push_back(
+        {it->path().str(),
+         it->type() == llvm::sys::fs::file_type::directory_file});
+  }
+  if (ec) {
+    return ec;
+  }
+
+  llvm::sort(entries);
+  for (const auto& [path, is_dir] : entries) {
+    if (is_dir) {
+      if (auto subdir_ec = SearchInputDirectory(fs, path, fn)) {
+        return subdir_ec;
+      }
+    } else if (llvm::sys::path::extension(path) == ".cocktail") {
+      fn(path);
+    }
+  }
+  return {};
+}
+
+auto Driver::ForEachInputInDirectory(
+    llvm::StringRef dir, DiagnosticConsumer& consumer,
+    llvm::function_ref<void(llvm::StringRef)> fn) -> bool {
+  FilenameTranslator translator;
+  DiagnosticEmitter<llvm::StringRef> emitter(translator, consumer);
+
+  bool found_input = false;
+  std::error_code ec =
+      SearchInputDirectory(fs_, dir, [&](llvm::StringRef path) {
+        found_input = true;
+        fn(path);
+      });
+  if (ec) {
+    COCKTAIL_DIAGNOSTIC(ErrorSearchingInputDirectory, Error,
+                        "Error searching input directory: {0}", std::string);
+    std::lock_guard<std::mutex> lock(diagnostics_mutex_);
+    emitter.Emit(dir, ErrorSearchingInputDirectory, ec.message());
+    return false;
+  }
+  if (!found_input) {
+    COCKTAIL_DIAGNOSTIC(NoInputFilesInDirectory, Error,
+                        "No `*.cocktail` files in input directory.");
+    std::lock_guard<std::mutex> lock(diagnostics_mutex_);
+    emitter.Emit(dir, NoInputFilesInDirectory);
+    return false;
+  }
+  return true;
+}
+
+auto Driver::CanPipelineFrontEnd(const CompileOptions& options) const
+    -> bool {
+  // Streamed diagnostics and dumps are written as they're produced, so running
+  // units' phases concurrently would interleave them.
+  return vlog_stream_ == nullptr && !options.stream_errors &&
+         !options.dump_tokens && !options.dump_parse_tree &&
+         !options.dump_raw_sem_ir && !options.dump_sem_ir;
+}
+
+auto Driver::RunFrontEndPipeline(
+    const CompileOptions& options,
+    llvm::function_ref<bool(llvm::function_ref<void(llvm::StringRef)>)>
+        for_each_input,
+    llvm::function_ref<CompilationUnit&(llvm::StringRef)> add_unit) -> bool {
+  // Enough to keep each stage busy while bounding how many units are held
+  // between stages.
+  constexpr int QueueCapacity = 8;
+
+  // The builtins are prepared up front, because the check stage only reads
+  // them.
+  const SemIR::File* builtins = options.phase == CompileOptions::Phase::Parse
+                                    ? nullptr
+                                    : &GetBuiltins();
+
+  BoundedQueue<CompilationUnit*> lexed(QueueCapacity);
+  BoundedQueue<CompilationUnit*> parsed(QueueCapacity);
+  bool parse_success = true;
+  bool check_success = true;
+
+  std::thread parse_stage([&] {
+    while (auto unit = lexed.Pop()) {
+      parse_success &= (*unit)->RunParse();
+      if (builtins) {
+        parsed.Push(*unit);
+      }
+    }
+    parsed.Close();
+  });
+  std::thread check_stage;
+  if (builtins) {
+    check_stage = std::thread([&] {
+      // TODO: Organize units to compile in dependency order.
+      while (auto unit = parsed.Pop()) {
+        check_success &= (*unit)->RunCheck(*builtins);
+        (*unit)->ReleaseFrontEnd();
+      }
+    });
+  }
+
+  // The lex stage runs on this thread, as inputs are found.
+  bool lex_success = true;
+  bool found_inputs = for_each_input([&](llvm::StringRef input_file_name) {
+    auto& unit = add_unit(input_file_name);
+    lex_success &= unit.RunLex();
+    lexed.Push(&unit);
+  });
+  lexed.Close();
+
+  parse_stage.join();
+  if (check_stage.joinable()) {
+    check_stage.join();
+  }
+  return found_inputs && lex_success && parse_success && check_success;
+}
+
 auto Driver::Compile(const CompileOptions& options) -> bool {
   if (!ValidateCompileOptions(options)) {
     return false;
   }
 
+  // Declared before the output consumer, so that the report is printed after
+  // the consumer is destroyed and any structured document it writes is closed.
+  std::optional<TimeReport> time_report;
+  if (options.time_report) {
+    time_report.emplace();
+  }
+  auto print_time_report = llvm::make_scope_exit([&]() {
+    if (time_report) {
+      time_report->Print(error_stream_, options.memory_lean);
+    }
+  });
+
+  // Declared before the units so that it outlives their final flush, which
+  // matters for formats that close a document on destruction.
+  std::unique_ptr<DiagnosticConsumer> output_consumer;
+  switch (options.diagnostics_format) {
+    case CompileOptions::DiagnosticsFormat::Text:
+      output_consumer =
+          std::make_unique<StreamDiagnosticConsumer>(error_stream_);
+      break;
+    case CompileOptions::DiagnosticsFormat::JsonLines:
+      output_consumer =
+          std::make_unique<JsonLinesDiagnosticConsumer>(error_stream_);
+      break;
+    case CompileOptions::DiagnosticsFormat::Sarif:
+      output_consumer =
+          std::make_unique<SarifDiagnosticConsumer>(error_stream_);
+      break;
+  }
+
   llvm::SmallVector<std::unique_ptr<CompilationUnit>> units;
   auto flush = llvm::make_scope_exit([&]() {
     // The diagnostics consumer must be flushed before compilation artifacts are
@@ -600,36 +1375,65 @@ auto Driver::Compile(const CompileOptions& options) -> bool {
       unit->Flush();
     }
   });
-  for (const auto& input_file_name : options.input_file_names) {
-    units.push_back(
-        std::make_unique<CompilationUnit>(this, options, input_file_name));
-  }
+  auto add_unit = [&](llvm::StringRef input_file_name) -> CompilationUnit& {
+    units.push_back(std::make_unique<CompilationUnit>(
+        this, options, input_file_name, *output_consumer,
+        time_report ? &*time_report : nullptr));
+    return *units.back();
+  };
+  // Calls `fn` for each input as soon as it's known, so that searching input
+  // directories overlaps with work on the files already found.
+  auto for_each_input = [&](llvm::function_ref<void(llvm::StringRef)> fn) {
+    for (const auto& input_file_name : options.input_file_names) {
+      fn(input_file_name);
+    }
+    bool success = true;
+    for (const auto& input_dir : options.input_dirs) {
+      success &= ForEachInputInDirectory(input_dir, *output_consumer, fn);
+    }
+    return success;
+  };
 
-  // Lex.
   bool success_before_lower = true;
-  for (auto& unit : units) {
-    success_before_lower &= unit->RunLex();
-  }
-  if (options.phase == CompileOptions::Phase::Lex) {
-    return success_before_lower;
-  }
+  if (options.phase != CompileOptions::Phase::Lex &&
+      CanPipelineFrontEnd(options)) {
+    success_before_lower =
+        RunFrontEndPipeline(options, for_each_input, add_unit);
+    if (options.phase == CompileOptions::Phase::Parse ||
+        (options.phase == CompileOptions::Phase::Check &&
+         !options.interpret)) {
+      return success_before_lower;
+    }
+  } else {
+    // Lex.
+    bool found_inputs = for_each_input([&](llvm::StringRef input_file_name) {
+      success_before_lower &= add_unit(input_file_name).RunLex();
+    });
+    success_before_lower &= found_inputs;
+    if (options.phase == CompileOptions::Phase::Lex) {
+      return success_before_lower;
+    }
 
-  // Parse.
-  for (auto& unit : units) {
-    success_before_lower &= unit->RunParse();
-  }
-  if (options.phase == CompileOptions::Phase::Parse) {
-    return success_before_lower;
-  }
+    // Parse.
+    for (auto& unit : units) {
+      success_before_lower &= unit->RunParse();
+    }
+    if (options.phase == CompileOptions::Phase::Parse) {
+      return success_before_lower;
+    }
 
-  // Check.
-  auto builtins = Check::MakeBuiltins();
-  // TODO: Organize units to compile in dependency order.
-  for (auto& unit : units) {
-    success_before_lower &= unit->RunCheck(builtins);
-  }
-  if (options.phase == CompileOptions::Phase::Check) {
-    return success_before_lower;
+    // Check.
+    const auto& builtins = GetBuiltins();
+    // TODO: Organize units to compile in dependency order.
+    for (auto& unit : units) {
+      success_before_lower &= unit->RunCheck(builtins);
+      if (options.memory_lean) {
+        unit->ReleaseFrontEnd();
+      }
+    }
+    if (options.phase == CompileOptions::Phase::Check && !options.interpret) {
+      return success_before_lower;
+    }
   }
 
   // Unlike previous steps, errors block further progress.
@@ -638,6 +1442,29 @@ auto Driver::Compile(const CompileOptions& options) -> bool {
     return false;
   }
 
+  if (options.interpret) {
+    bool interpret_success = true;
+    for (auto& unit : units) {
+      interpret_success &= unit->RunInterpret();
+    }
+    return interpret_success;
+  }
+
+  if (options.memory_lean) {
+    // Take each unit through lowering and codegen before starting the next, so
+    // that only one SemIR or module is alive at a time.
+    bool codegen_success = true;
+    for (auto& unit : units) {
+      unit->RunLower();
+      unit->ReleaseSemIR();
+      if (options.phase == CompileOptions::Phase::CodeGen) {
+        codegen_success &= unit->RunCodeGen();
+      }
+      unit->ReleaseModule();
+    }
+    return codegen_success;
+  }
+
   // Lower.
   for (auto& unit : units) {
     unit->RunLower();
@@ -0,0 +1,362 @@
+#include "Cocktail/Interpret/FileContext.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Cocktail/Common/VLog.h"
+#include "Cocktail/Interpret/FunctionContext.h"
+#include "Cocktail/SemIR/File.h"
+#include "Cocktail/SemIR/Node.h"
+#include "Cocktail/SemIR/NodeKind.h"
+#include "llvm/ADT/STLExtras.h"
+
+namespace Cocktail::Interpret {
+
+// The most cells a single object may take. Anything larger is almost
+// certainly a mistake, and would exhaust memory before it was noticed.
+static constexpr int64_t MaxObjectSize = 1 << 24;
+
+FileContext::FileContext(const SemIR::File& semantics_ir, const Limits& limits,
+                         llvm::raw_ostream* vlog_stream)
+    : semantics_ir_(&semantics_ir), limits_(limits), vlog_stream_(vlog_stream) {
+  COCKTAIL_CHECK(!semantics_ir.has_errors())
+      << "Interpreting invalid SemIR::File is unsupported.";
+}
+
+// Returns the name of `function`, for messages.
+static auto GetFunctionName(const SemIR::File& semantics_ir,
+                            const SemIR::Function& function)
+    -> llvm::StringRef {
+  return function.name_id.is_valid() ? semantics_ir.GetString(function.name_id)
+                                     : "<unnamed>";
+}
+
+auto FileContext::CallFunction(SemIR::FunctionId function_id,
+                               llvm::ArrayRef<Value> args, Value return_slot)
+    -> Value {
+  const auto& function = semantics_ir().GetFunction(function_id);
+  if (function.body_block_ids.empty()) {
+    Fail(llvm::Twine("Function `") +
+         GetFunctionName(semantics_ir(), function) + "` has no definition");
+    return Value();
+  }
+  if (call_depth_ == limits_.max_call_depth) {
+    Fail(llvm::Twine("Exceeded the call depth limit of ") +
+         llvm::Twine(limits_.max_call_depth));
+    return Value();
+  }
+  COCKTAIL_VLOG() << "Calling " << GetFunctionName(semantics_ir(), function)
+                  << "\n";
+
+  auto param_refs = semantics_ir().GetNodeBlock(function.param_refs_id);
+  if (param_refs.size() != args.size()) {
+    Fail(llvm::Twine("Function `") + GetFunctionName(semantics_ir(), function) +
+         "` expects " + llvm::Twine(param_refs.size()) +
+         " arguments, but got " + llvm::Twine(args.size()));
+    return Value();
+  }
+  if (function.return_slot_id.is_valid() &&
+      return_slot.kind != Value::Kind::Address) {
+    Fail(llvm::Twine("Function `") + GetFunctionName(semantics_ir(), function) +
+         "` returns through a return slot, but none was given");
+    return Value();
+  }
+
+  FunctionContext function_context(*this, function_id, vlog_stream_);
+  if (function.return_slot_id.is_valid()) {
+    function_context.SetLocal(function.return_slot_id, return_slot);
+  }
+  for (auto [param_ref_id, arg] : llvm::zip(param_refs, args)) {
+    function_context.SetLocal(param_ref_id, arg);
+  }
+
+  ++call_depth_;
+  Value result = function_context.Run();
+  --call_depth_;
+  return result;
+}
+
+auto FileContext::GetFunctionIdRanges(SemIR::FunctionId function_id)
+    -> const SemIR::FunctionIdRanges& {
+  if (static_cast<size_t>(function_id.index) >= function_id_ranges_.size()) {
+    function_id_ranges_.resize(semantics_ir().functions_size());
+  }
+  auto& ranges = function_id_ranges_[function_id.index];
+  if (!ranges) {
+    ranges = SemIR::GetFunctionIdRanges(semantics_ir(), function_id);
+  }
+  return *ranges;
+}
+
+auto FileContext::GetConstant(SemIR::NodeId constant_id) -> Value {
+  if (auto it = constants_.find(constant_id); it != constants_.end()) {
+    return it->second;
+  }
+  Value value = BuildConstant(constant_id);
+  constants_.insert({constant_id, value});
+  return value;
+}
+
+auto FileContext::BuildConstant(SemIR::NodeId constant_id) -> Value {
+  auto node = semantics_ir().GetNode(constant_id);
+  SemIR::NodeBlockId refs_id = SemIR::NodeBlockId::Invalid;
+  switch (node.kind()) {
+    case SemIR::NodeKind::BoolLiteral:
+      return Value::MakeBool(node.GetAsBoolLiteral() == SemIR::BoolValue::True);
+
+    case SemIR::NodeKind::IntegerLiteral: {
+      // This matches the lowering of integer constants.
+      const auto& value =
+          semantics_ir().GetIntegerLiteral(node.GetAsIntegerLiteral());
+      return Value::MakeInteger(value.zextOrTrunc(32).getZExtValue());
+    }
+
+    case SemIR::NodeKind::StructValue:
+      refs_id = node.GetAsStructValue().second;
+      break;
+
+    case SemIR::NodeKind::TupleValue:
+      refs_id = node.GetAsTupleValue().second;
+      break;
+
+    default:
+      COCKTAIL_FATAL() << "Unexpected constant node " << node;
+  }
+
+  // Builds the value representation of a constant struct or tuple, like
+  // EmitStructOrTupleValueRepresentation does at runtime.
+  auto refs = semantics_ir().GetNodeBlock(refs_id);
+  switch (SemIR::GetValueRepresentation(semantics_ir(), node.type_id()).kind) {
+    case SemIR::ValueRepresentation::None:
+      return Value::MakeNone();
+    case SemIR::ValueRepresentation::Copy:
+      COCKTAIL_CHECK(refs.size() == 1)
+          << "Unexpected size for aggregate with by-copy value representation";
+      return GetConstant(refs[0]);
+    case SemIR::ValueRepresentation::Pointer:
+      break;
+    case SemIR::ValueRepresentation::Custom:
+      COCKTAIL_FATAL()
+          << "Aggregate should never have custom value representation";
+  }
+
+  const auto& layout = GetLayout(node.type_id());
+  if (failed()) {
+    return Value();
+  }
+  Value pointer =
+      Value::MakeAddress(ConstantBase + static_cast<int32_t>(
+                                            constant_memory_.size()));
+  constant_memory_.resize(constant_memory_.size() + layout.size);
+  for (auto [ref_id, offset, type_id] :
+       llvm::zip(refs, layout.element_offsets, layout.element_type_ids)) {
+    StoreValue(type_id, GetConstant(ref_id),
+               Value::MakeAddress(pointer.address + offset));
+  }
+  return pointer;
+}
+
+auto FileContext::GetLayout(SemIR::TypeId type_id) -> const TypeLayout& {
+  // `type` and the error type have no storage.
+  static const TypeLayout EmptyLayout;
+  if (type_id.index < 0) {
+    return EmptyLayout;
+  }
+  if (static_cast<size_t>(type_id.index) >= layouts_.size()) {
+    layouts_.resize(std::max<size_t>(type_id.index + 1,
+                                     semantics_ir().types().size()));
+  }
+  if (!layouts_[type_id.index]) {
+    auto layout = std::make_unique<TypeLayout>(BuildLayout(type_id));
+    // Building the layout may have built others, and grown `layouts_`.
+    layouts_[type_id.index] = std::move(layout);
+  }
+  return *layouts_[type_id.index];
+}
+
+auto FileContext::BuildLayout(SemIR::TypeId type_id) -> TypeLayout {
+  TypeLayout layout;
+  auto node_id = semantics_ir().GetType(type_id);
+  switch (node_id.index) {
+    case SemIR::BuiltinKind::BoolType.AsInt():
+    case SemIR::BuiltinKind::IntegerType.AsInt():
+    case SemIR::BuiltinKind::FloatingPointType.AsInt():
+    case SemIR::BuiltinKind::StringType.AsInt():
+      layout.kind = TypeLayout::Kind::Scalar;
+      layout.size = 1;
+      return layout;
+    default:
+      if (node_id.index < SemIR::BuiltinKind::ValidCount) {
+        // The remaining builtins, such as `type`, have no storage.
+        return layout;
+      }
+      break;
+  }
+
+  auto add_element = [&](SemIR::TypeId element_type_id) {
+    int32_t element_size = GetLayout(element_type_id).size;
+    layout.element_offsets.push_back(layout.size);
+    layout.element_type_ids.push_back(element_type_id);
+    layout.size += element_size;
+  };
+
+  auto node = semantics_ir().GetNode(node_id);
+  switch (node.kind()) {
+    case SemIR::NodeKind::ArrayType: {
+      auto [bound_node_id, element_type_id] = node.GetAsArrayType();
+      uint64_t bound = semantics_ir().GetArrayBoundValue(bound_node_id);
+      int64_t element_size = GetLayout(element_type_id).size;
+      if (bound > MaxObjectSize || bound * element_size > MaxObjectSize) {
+        Fail(llvm::Twine("Array of ") + llvm::Twine(bound) +
+             " elements is too large to interpret");
+        return layout;
+      }
+      layout.kind = TypeLayout::Kind::Array;
+      layout.element_type_id = element_type_id;
+      layout.bound = bound;
+      layout.size = bound * element_size;
+      return layout;
+    }
+    case SemIR::NodeKind::ConstType:
+      return GetLayout(node.GetAsConstType());
+    case SemIR::NodeKind::PointerType:
+      layout.kind = TypeLayout::Kind::Scalar;
+      layout.size = 1;
+      return layout;
+    case SemIR::NodeKind::StructType: {
+      layout.kind = TypeLayout::Kind::Aggregate;
+      for (auto ref_id : semantics_ir().GetNodeBlock(node.GetAsStructType())) {
+        auto [field_name_id, field_type_id] =
+            semantics_ir().GetNode(ref_id).GetAsStructTypeField();
+        add_element(field_type_id);
+      }
+      break;
+    }
+    case SemIR::NodeKind::TupleType: {
+      layout.kind = TypeLayout::Kind::Aggregate;
+      for (auto element_type_id :
+           semantics_ir().GetTypeBlock(node.GetAsTupleType())) {
+        add_element(element_type_id);
+      }
+      break;
+    }
+    default:
+      COCKTAIL_FATAL() << "Cannot use node as type: " << node_id;
+  }
+  if (layout.size > MaxObjectSize) {
+    Fail("Aggregate is too large to interpret");
+  }
+  return layout;
+}
+
+auto FileContext::Allocate(SemIR::TypeId type_id) -> int32_t {
+  int32_t size = GetLayout(type_id).size;
+  auto address = static_cast<int32_t>(memory_.size());
+  if (address + static_cast<int64_t>(size) >= ConstantBase) {
+    Fail("Exceeded the interpreter's memory");
+    return address;
+  }
+  memory_.resize(address + size);
+  return address;
+}
+
+auto FileContext::GetCells(int32_t address, int32_t size)
+    -> llvm::MutableArrayRef<Value> {
+  llvm::MutableArrayRef<Value> cells = memory_;
+  if (address >= ConstantBase) {
+    cells = constant_memory_;
+    address -= ConstantBase;
+  }
+  if (address < 0 || static_cast<size_t>(address) + size > cells.size()) {
+    // Either a bad pointer, or a pointer into a call that has returned.
+    Fail(llvm::Twine("Access to unallocated memory at ") +
+         llvm::Twine(address));
+    return {};
+  }
+  return cells.slice(address, size);
+}
+
+auto FileContext::LoadValue(SemIR::TypeId type_id, Value pointer) -> Value {
+  auto rep = SemIR::GetValueRepresentation(semantics_ir(), type_id);
+  if (rep.kind == SemIR::ValueRepresentation::None) {
+    return Value::MakeNone();
+  }
+  if (pointer.kind != Value::Kind::Address) {
+    Fail(llvm::Twine("Load through a non-pointer value"));
+    return Value();
+  }
+  switch (rep.kind) {
+    case SemIR::ValueRepresentation::None:
+      llvm_unreachable("Handled above");
+    case SemIR::ValueRepresentation::Copy: {
+      const auto& layout = GetLayout(type_id);
+      if (layout.kind == TypeLayout::Kind::Aggregate) {
+        // An aggregate held by copy has a single element, whose value is the
+        // aggregate's value.
+        return LoadValue(layout.element_type_ids.front(), pointer);
+      }
+      auto cells = GetCells(pointer.address, 1);
+      if (cells.empty()) {
+        return Value();
+      }
+      if (cells[0].kind == Value::Kind::Invalid) {
+        Fail("Read of uninitialized memory");
+      }
+      return cells[0];
+    }
+    case SemIR::ValueRepresentation::Pointer:
+      return pointer;
+    case SemIR::ValueRepresentation::Custom:
+      Fail("TODO: Add support for custom value representation");
+      return Value();
+  }
+  llvm_unreachable("All value representations handled!");
+}
+
+auto FileContext::StoreValue(SemIR::TypeId type_id, Value value,
+                             Value pointer) -> void {
+  auto rep = SemIR::GetValueRepresentation(semantics_ir(), type_id);
+  if (rep.kind == SemIR::ValueRepresentation::None) {
+    return;
+  }
+  if (pointer.kind != Value::Kind::Address) {
+    Fail("Store through a non-pointer value");
+    return;
+  }
+  switch (rep.kind) {
+    case SemIR::ValueRepresentation::None:
+      llvm_unreachable("Handled above");
+    case SemIR::ValueRepresentation::Copy: {
+      const auto& layout = GetLayout(type_id);
+      if (layout.kind == TypeLayout::Kind::Aggregate) {
+        StoreValue(layout.element_type_ids.front(), value, pointer);
+        return;
+      }
+      auto cells = GetCells(pointer.address, 1);
+      if (!cells.empty()) {
+        cells[0] = value;
+      }
+      return;
+    }
+    case SemIR::ValueRepresentation::Pointer: {
+      // The value is the address of an object to copy.
+      if (value.kind != Value::Kind::Address) {
+        Fail("Copy from a non-pointer value");
+        return;
+      }
+      int32_t size = GetLayout(type_id).size;
+      auto source = GetCells(value.address, size);
+      auto dest = GetCells(pointer.address, size);
+      if (source.size() == dest.size() && !dest.empty()) {
+        // The objects may be the same, or overlap.
+        std::memmove(dest.data(), source.data(), size * sizeof(Value));
+      }
+      return;
+    }
+    case SemIR::ValueRepresentation::Custom:
+      Fail("TODO: Add support for custom value representation");
+      return;
+  }
+}
+
+}  // namespace Cocktail::Interpret
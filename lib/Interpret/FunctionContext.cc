@@ -0,0 +1,127 @@
+#include "Cocktail/Interpret/FunctionContext.h"
+
+#include "Cocktail/Common/VLog.h"
+#include "Cocktail/SemIR/File.h"
+
+namespace Cocktail::Interpret {
+
+FunctionContext::FunctionContext(FileContext& file_context,
+                                 SemIR::FunctionId function_id,
+                                 llvm::raw_ostream* vlog_stream)
+    : file_context_(&file_context),
+      function_id_(function_id),
+      vlog_stream_(vlog_stream),
+      stack_top_(file_context.stack_top()),
+      locals_(file_context.GetFunctionIdRanges(function_id).nodes),
+      block_args_(file_context.GetFunctionIdRanges(function_id).node_blocks) {}
+
+FunctionContext::~FunctionContext() { file_context_->FreeStack(stack_top_); }
+
+auto FunctionContext::Run() -> Value {
+  const auto& function = semantics_ir().GetFunction(function_id_);
+  SemIR::NodeBlockId block_id = function.body_block_ids.front();
+  while (true) {
+    COCKTAIL_VLOG() << "Running " << block_id << "\n";
+    RunBlock(block_id);
+    if (file_context_->failed()) {
+      return Value();
+    }
+    if (returned_) {
+      return return_value_;
+    }
+    if (!next_block_id_.is_valid()) {
+      // Checking adds a terminator to every block it finishes, so this is a
+      // block that's still being checked.
+      Fail("Reached the end of a block without a terminator");
+      return Value();
+    }
+    block_id = next_block_id_;
+    next_block_id_ = SemIR::NodeBlockId::Invalid;
+  }
+}
+
+auto FunctionContext::RunBlock(SemIR::NodeBlockId block_id) -> void {
+  for (const auto& node_id : semantics_ir().GetNodeBlock(block_id)) {
+    if (!file_context_->Step()) {
+      return;
+    }
+    auto node = semantics_ir().GetNode(node_id);
+    COCKTAIL_VLOG() << "Running " << node_id << ": " << node << "\n";
+    // Nodes that check folded to a constant are replaced by that constant.
+    // They have no side effects, so nothing else needs to run.
+    if (auto constant_id = semantics_ir().GetConstantValue(node_id);
+        constant_id.is_valid()) {
+      SetLocal(node_id, file_context_->GetConstant(constant_id));
+      continue;
+    }
+    // clang warns on unhandled enum values; clang-tidy is incorrect here.
+    // NOLINTNEXTLINE(bugprone-switch-missing-default-case)
+    switch (node.kind()) {
+#define COCKTAIL_SEMANTICS_NODE_KIND(Name) \
+  case SemIR::NodeKind::Name:              \
+    Handle##Name(*this, node_id, node);    \
+    break;
+#include "Cocktail/SemIR/NodeKind.def"
+    }
+    if (next_block_id_.is_valid() || returned_) {
+      return;
+    }
+  }
+}
+
+auto FunctionContext::GetStorage(SemIR::NodeId node_id, SemIR::TypeId type_id)
+    -> Value {
+  Value& slot = locals_.Slot(node_id);
+  if (slot.kind != Value::Kind::Address) {
+    slot = Value::MakeAddress(file_context_->Allocate(type_id));
+  }
+  return slot;
+}
+
+auto FunctionContext::GetElementAddress(SemIR::TypeId type_id, Value pointer,
+                                        int32_t index) -> Value {
+  if (pointer.kind != Value::Kind::Address) {
+    Fail("Element access through a non-pointer value");
+    return Value();
+  }
+  const auto& layout = file_context_->GetLayout(type_id);
+  switch (layout.kind) {
+    case TypeLayout::Kind::Aggregate:
+      COCKTAIL_CHECK(static_cast<size_t>(index) <
+                     layout.element_offsets.size())
+          << "Element " << index << " out of range";
+      return Value::MakeAddress(pointer.address +
+                                layout.element_offsets[index]);
+    case TypeLayout::Kind::Array: {
+      if (index < 0 || index >= layout.bound) {
+        Fail(llvm::Twine("Array index ") + llvm::Twine(index) +
+             " is out of bounds for an array of " + llvm::Twine(layout.bound) +
+             " elements");
+        return Value();
+      }
+      int32_t element_size =
+          file_context_->GetLayout(layout.element_type_id).size;
+      return Value::MakeAddress(pointer.address + index * element_size);
+    }
+    case TypeLayout::Kind::Empty:
+    case TypeLayout::Kind::Scalar:
+      COCKTAIL_FATAL() << "Element access into a type without elements: "
+                       << type_id;
+  }
+  llvm_unreachable("All layout kinds handled!");
+}
+
+auto FunctionContext::FinishInitialization(SemIR::TypeId type_id,
+                                           SemIR::NodeId dest_id,
+                                           SemIR::NodeId init_id) -> void {
+  switch (SemIR::GetInitializingRepresentation(semantics_ir(), type_id).kind) {
+    case SemIR::InitializingRepresentation::None:
+    case SemIR::InitializingRepresentation::InPlace:
+      break;
+    case SemIR::InitializingRepresentation::ByCopy:
+      file_context_->StoreValue(type_id, GetLocal(init_id), GetLocal(dest_id));
+      break;
+  }
+}
+
+}  // namespace Cocktail::Interpret
@@ -0,0 +1,442 @@
+#include <cmath>
+
+#include "Cocktail/Interpret/FunctionContext.h"
+#include "Cocktail/SemIR/NodeKind.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace Cocktail::Interpret {
+
+auto HandleInvalid(FunctionContext& /*context*/, SemIR::NodeId /*node_id*/,
+                   SemIR::Node /*node*/) -> void {
+  llvm_unreachable("never in actual IR");
+}
+
+auto HandleCrossReference(FunctionContext& context, SemIR::NodeId /*node_id*/,
+                          SemIR::Node /*node*/) -> void {
+  context.Fail("TODO: Add support for CrossReference");
+}
+
+auto HandleAddressOf(FunctionContext& context, SemIR::NodeId node_id,
+                     SemIR::Node node) -> void {
+  context.SetLocal(node_id, context.GetLocal(node.GetAsAddressOf()));
+}
+
+auto HandleArrayIndex(FunctionContext& context, SemIR::NodeId node_id,
+                      SemIR::Node node) -> void {
+  auto [array_node_id, index_node_id] = node.GetAsArrayIndex();
+  auto index = context.GetLocal(index_node_id);
+  if (index.kind != Value::Kind::Integer) {
+    context.Fail("Array index is not an integer");
+    return;
+  }
+  auto element_address = context.GetElementAddress(
+      context.semantics_ir().GetNode(array_node_id).type_id(),
+      context.GetLocal(array_node_id), index.integer);
+  // Indexing an array value produces a value, and otherwise a reference.
+  if (SemIR::GetExpressionCategory(context.semantics_ir(), array_node_id) ==
+      SemIR::ExpressionCategory::Value) {
+    context.SetLocal(node_id, context.file_context().LoadValue(
+                                  node.type_id(), element_address));
+  } else {
+    context.SetLocal(node_id, element_address);
+  }
+}
+
+auto HandleArrayInit(FunctionContext& context, SemIR::NodeId node_id,
+                     SemIR::Node node) -> void {
+  auto [src_id, refs_id] = node.GetAsArrayInit();
+  // The result of initialization is the return slot of the initializer.
+  context.SetLocal(
+      node_id,
+      context.GetLocal(context.semantics_ir().GetNodeBlock(refs_id).back()));
+}
+
+auto HandleAssign(FunctionContext& context, SemIR::NodeId /*node_id*/,
+                  SemIR::Node node) -> void {
+  auto [storage_id, value_id] = node.GetAsAssign();
+  auto storage_type_id = context.semantics_ir().GetNode(storage_id).type_id();
+  context.FinishInitialization(storage_type_id, storage_id, value_id);
+}
+
+auto HandleBinaryOperatorAdd(FunctionContext& context, SemIR::NodeId node_id,
+                             SemIR::Node node) -> void {
+  auto [lhs_id, rhs_id] = node.GetAsBinaryOperatorAdd();
+  auto lhs = context.GetLocal(lhs_id);
+  auto rhs = context.GetLocal(rhs_id);
+  if (lhs.kind == Value::Kind::Integer && rhs.kind == Value::Kind::Integer) {
+    // This wraps on overflow, matching the lowered `add`.
+    context.SetLocal(node_id, Value::MakeInteger(static_cast<int32_t>(
+                                  static_cast<uint32_t>(lhs.integer) +
+                                  static_cast<uint32_t>(rhs.integer))));
+  } else if (lhs.kind == Value::Kind::Real && rhs.kind == Value::Kind::Real) {
+    context.SetLocal(node_id, Value::MakeReal(lhs.real + rhs.real));
+  } else {
+    context.Fail("Unsupported operands for `+`");
+  }
+}
+
+auto HandleBindName(FunctionContext& context, SemIR::NodeId node_id,
+                    SemIR::Node node) -> void {
+  auto [name_id, value_id] = node.GetAsBindName();
+  context.SetLocal(node_id, context.GetLocal(value_id));
+}
+
+auto HandleBlockArg(FunctionContext& context, SemIR::NodeId node_id,
+                    SemIR::Node node) -> void {
+  context.SetLocal(node_id, context.GetBlockArg(node.GetAsBlockArg()));
+}
+
+auto HandleBoolLiteral(FunctionContext& context, SemIR::NodeId node_id,
+                       SemIR::Node node) -> void {
+  context.SetLocal(node_id, Value::MakeBool(node.GetAsBoolLiteral() ==
+                                            SemIR::BoolValue::True));
+}
+
+auto HandleBranch(FunctionContext& context, SemIR::NodeId /*node_id*/,
+                  SemIR::Node node) -> void {
+  context.BranchTo(node.GetAsBranch());
+}
+
+auto HandleBranchIf(FunctionContext& context, SemIR::NodeId /*node_id*/,
+                    SemIR::Node node) -> void {
+  auto [target_block_id, cond_id] = node.GetAsBranchIf();
+  auto cond = context.GetLocal(cond_id);
+  if (cond.kind != Value::Kind::Bool) {
+    context.Fail("Branch condition is not a bool");
+    return;
+  }
+  // If the branch isn't taken, control continues with the next node in the
+  // block, where lowering would start a synthetic block.
+  if (cond.boolean) {
+    context.BranchTo(target_block_id);
+  }
+}
+
+auto HandleBranchWithArg(FunctionContext& context, SemIR::NodeId /*node_id*/,
+                         SemIR::Node node) -> void {
+  auto [target_block_id, arg_id] = node.GetAsBranchWithArg();
+  context.BranchTo(target_block_id, context.GetLocal(arg_id));
+}
+
+auto HandleBuiltin(FunctionContext& context, SemIR::NodeId /*node_id*/,
+                   SemIR::Node /*node*/) -> void {
+  context.Fail("TODO: Add support for Builtin");
+}
+
+auto HandleCall(FunctionContext& context, SemIR::NodeId node_id,
+                SemIR::Node node) -> void {
+  auto [refs_id, function_id] = node.GetAsCall();
+  const auto& function = context.semantics_ir().GetFunction(function_id);
+
+  llvm::ArrayRef<SemIR::NodeId> arg_ids =
+      context.semantics_ir().GetNodeBlock(refs_id);
+
+  Value return_slot;
+  if (function.return_slot_id.is_valid()) {
+    return_slot = context.GetLocal(arg_ids.back());
+    arg_ids = arg_ids.drop_back();
+  }
+
+  llvm::SmallVector<Value> args;
+  args.reserve(arg_ids.size());
+  for (auto ref_id : arg_ids) {
+    args.push_back(context.GetLocal(ref_id));
+  }
+
+  context.SetLocal(node_id, context.file_context().CallFunction(
+                                function_id, args, return_slot));
+}
+
+auto HandleDereference(FunctionContext& context, SemIR::NodeId node_id,
+                       SemIR::Node node) -> void {
+  context.SetLocal(node_id, context.GetLocal(node.GetAsDereference()));
+}
+
+auto HandleFunctionDeclaration(FunctionContext& /*context*/,
+                               SemIR::NodeId /*node_id*/, SemIR::Node node)
+    -> void {
+  COCKTAIL_FATAL()
+      << "Should not be encountered. If that changes, we may want to change "
+         "higher-level logic to skip them rather than calling this. "
+      << node;
+}
+
+auto HandleInitializeFrom(FunctionContext& context, SemIR::NodeId /*node_id*/,
+                          SemIR::Node node) -> void {
+  auto [init_id, storage_id] = node.GetAsInitializeFrom();
+  auto storage_type_id = context.semantics_ir().GetNode(storage_id).type_id();
+  context.FinishInitialization(storage_type_id, storage_id, init_id);
+}
+
+auto HandleIntegerLiteral(FunctionContext& context, SemIR::NodeId node_id,
+                          SemIR::Node node) -> void {
+  const llvm::APInt& i =
+      context.semantics_ir().GetIntegerLiteral(node.GetAsIntegerLiteral());
+  // TODO: This matches lowering, which doesn't offer correct semantics.
+  context.SetLocal(node_id,
+                   Value::MakeInteger(i.zextOrTrunc(32).getZExtValue()));
+}
+
+auto HandleNameReference(FunctionContext& context, SemIR::NodeId node_id,
+                         SemIR::Node node) -> void {
+  auto [name_id, value_id] = node.GetAsNameReference();
+  context.SetLocal(node_id, context.GetLocal(value_id));
+}
+
+auto HandleNameReferenceUntyped(FunctionContext& /*context*/,
+                                SemIR::NodeId /*node_id*/, SemIR::Node /*node*/)
+    -> void {
+  // No action to take: untyped name references don't hold a value.
+}
+
+auto HandleNamespace(FunctionContext& /*context*/, SemIR::NodeId /*node_id*/,
+                     SemIR::Node /*node*/) -> void {
+  // No action to take.
+}
+
+auto HandleNoOp(FunctionContext& /*context*/, SemIR::NodeId /*node_id*/,
+                SemIR::Node /*node*/) -> void {
+  // No action to take.
+}
+
+auto HandleParameter(FunctionContext& /*context*/, SemIR::NodeId /*node_id*/,
+                     SemIR::Node /*node*/) -> void {
+  COCKTAIL_FATAL() << "Parameters should be bound by `CallFunction`";
+}
+
+auto HandleRealLiteral(FunctionContext& context, SemIR::NodeId node_id,
+                       SemIR::Node node) -> void {
+  SemIR::RealLiteral real =
+      context.semantics_ir().GetRealLiteral(node.GetAsRealLiteral());
+  // TODO: This matches lowering, and has the same overflow issues.
+  double val =
+      real.mantissa.getZExtValue() *
+      std::pow((real.is_decimal ? 10 : 2), real.exponent.getSExtValue());
+  context.SetLocal(node_id, Value::MakeReal(val));
+}
+
+auto HandleReturn(FunctionContext& context, SemIR::NodeId /*node_id*/,
+                  SemIR::Node /*node*/) -> void {
+  context.ReturnWith(Value::MakeNone());
+}
+
+auto HandleReturnExpression(FunctionContext& context, SemIR::NodeId /*node_id*/,
+                            SemIR::Node node) -> void {
+  SemIR::NodeId expr_id = node.GetAsReturnExpression();
+  switch (SemIR::GetInitializingRepresentation(
+              context.semantics_ir(),
+              context.semantics_ir().GetNode(expr_id).type_id())
+              .kind) {
+    case SemIR::InitializingRepresentation::None:
+    case SemIR::InitializingRepresentation::InPlace:
+      // Nothing to return.
+      context.ReturnWith(Value::MakeNone());
+      return;
+    case SemIR::InitializingRepresentation::ByCopy:
+      // The expression produces the value representation for the type.
+      context.ReturnWith(context.GetLocal(expr_id));
+      return;
+  }
+}
+
+auto HandleSpliceBlock(FunctionContext& context, SemIR::NodeId node_id,
+                       SemIR::Node node) -> void {
+  auto [block_id, result_id] = node.GetAsSpliceBlock();
+  context.RunBlock(block_id);
+  context.SetLocal(node_id, context.GetLocal(result_id));
+}
+
+auto HandleStringLiteral(FunctionContext& context, SemIR::NodeId /*node_id*/,
+                         SemIR::Node /*node*/) -> void {
+  context.Fail("TODO: Add support for StringLiteral");
+}
+
+// Extracts an element of either a struct or a tuple by index. Depending on the
+// expression category of the aggregate input, this will either produce a value
+// or a reference.
+static auto GetStructOrTupleElement(FunctionContext& context,
+                                    SemIR::NodeId aggr_node_id, unsigned idx,
+                                    SemIR::TypeId result_type_id) -> Value {
+  auto aggr_node = context.semantics_ir().GetNode(aggr_node_id);
+  auto aggr_value = context.GetLocal(aggr_node_id);
+
+  auto aggr_cat =
+      SemIR::GetExpressionCategory(context.semantics_ir(), aggr_node_id);
+  if (aggr_cat == SemIR::ExpressionCategory::Value &&
+      SemIR::GetValueRepresentation(context.semantics_ir(), aggr_node.type_id())
+              .kind == SemIR::ValueRepresentation::Copy) {
+    // An aggregate held by copy has a single element, whose value is the
+    // aggregate's value.
+    return aggr_value;
+  }
+
+  // Either we're accessing an element of a reference and producing a reference,
+  // or we're accessing an element of a value that is held by pointer and we're
+  // producing a value.
+  auto element_address =
+      context.GetElementAddress(aggr_node.type_id(), aggr_value, idx);
+  if (aggr_cat == SemIR::ExpressionCategory::Value) {
+    return context.file_context().LoadValue(result_type_id, element_address);
+  }
+  return element_address;
+}
+
+auto HandleStructAccess(FunctionContext& context, SemIR::NodeId node_id,
+                        SemIR::Node node) -> void {
+  auto [struct_id, member_index] = node.GetAsStructAccess();
+  context.SetLocal(node_id, GetStructOrTupleElement(context, struct_id,
+                                                    member_index.index,
+                                                    node.type_id()));
+}
+
+auto HandleStructLiteral(FunctionContext& context, SemIR::NodeId node_id,
+                         SemIR::Node /*node*/) -> void {
+  // A StructLiteral should always be converted to a StructInit or StructValue
+  // if its value is needed.
+  context.SetLocal(node_id, Value::MakeNone());
+}
+
+// Produces the value representation for a struct or tuple whose elements are
+// the contents of `refs_id`. When that's a pointer, the object is built in
+// storage belonging to `node_id`.
+static auto EmitStructOrTupleValueRepresentation(FunctionContext& context,
+                                                 SemIR::NodeId node_id,
+                                                 SemIR::TypeId type_id,
+                                                 SemIR::NodeBlockId refs_id)
+    -> Value {
+  switch (SemIR::GetValueRepresentation(context.semantics_ir(), type_id).kind) {
+    case SemIR::ValueRepresentation::None:
+      return Value::MakeNone();
+
+    case SemIR::ValueRepresentation::Copy: {
+      auto refs = context.semantics_ir().GetNodeBlock(refs_id);
+      COCKTAIL_CHECK(refs.size() == 1)
+          << "Unexpected size for aggregate with by-copy value representation";
+      return context.GetLocal(refs[0]);
+    }
+
+    case SemIR::ValueRepresentation::Pointer: {
+      // Write the object representation to local storage so we can produce a
+      // pointer to it as the value representation. Unlike lowering, elements
+      // that are themselves held by pointer are copied into place.
+      auto storage = context.GetStorage(node_id, type_id);
+      for (const auto& item :
+           llvm::enumerate(context.semantics_ir().GetNodeBlock(refs_id))) {
+        context.file_context().StoreValue(
+            context.semantics_ir().GetNode(item.value()).type_id(),
+            context.GetLocal(item.value()),
+            context.GetElementAddress(type_id, storage, item.index()));
+      }
+      return storage;
+    }
+
+    case SemIR::ValueRepresentation::Custom:
+      COCKTAIL_FATAL()
+          << "Aggregate should never have custom value representation";
+  }
+  llvm_unreachable("All value representations handled!");
+}
+
+auto HandleStructInit(FunctionContext& context, SemIR::NodeId node_id,
+                      SemIR::Node node) -> void {
+  switch (SemIR::GetInitializingRepresentation(context.semantics_ir(),
+                                               node.type_id())
+              .kind) {
+    case SemIR::InitializingRepresentation::None:
+    case SemIR::InitializingRepresentation::InPlace:
+      // The elements were initialized in place.
+      context.SetLocal(node_id, Value::MakeNone());
+      break;
+
+    case SemIR::InitializingRepresentation::ByCopy: {
+      auto [struct_literal_id, refs_id] = node.GetAsStructInit();
+      context.SetLocal(node_id, EmitStructOrTupleValueRepresentation(
+                                    context, node_id, node.type_id(), refs_id));
+      break;
+    }
+  }
+}
+
+auto HandleStructValue(FunctionContext& context, SemIR::NodeId node_id,
+                       SemIR::Node node) -> void {
+  auto [struct_literal_id, refs_id] = node.GetAsStructValue();
+  context.SetLocal(node_id, EmitStructOrTupleValueRepresentation(
+                                context, node_id, node.type_id(), refs_id));
+}
+
+auto HandleStructTypeField(FunctionContext& /*context*/,
+                           SemIR::NodeId /*node_id*/, SemIR::Node /*node*/)
+    -> void {
+  // No action to take.
+}
+
+auto HandleTupleAccess(FunctionContext& context, SemIR::NodeId node_id,
+                       SemIR::Node node) -> void {
+  auto [tuple_node_id, index] = node.GetAsTupleAccess();
+  context.SetLocal(node_id, GetStructOrTupleElement(context, tuple_node_id,
+                                                    index.index,
+                                                    node.type_id()));
+}
+
+auto HandleTupleIndex(FunctionContext& context, SemIR::NodeId node_id,
+                      SemIR::Node node) -> void {
+  auto [tuple_node_id, index_node_id] = node.GetAsTupleIndex();
+  auto index_node = context.semantics_ir().GetNode(index_node_id);
+  const auto index = context.semantics_ir()
+                         .GetIntegerLiteral(index_node.GetAsIntegerLiteral())
+                         .getZExtValue();
+  context.SetLocal(node_id, GetStructOrTupleElement(context, tuple_node_id,
+                                                    index, node.type_id()));
+}
+
+auto HandleTupleLiteral(FunctionContext& context, SemIR::NodeId node_id,
+                        SemIR::Node /*node*/) -> void {
+  // A TupleLiteral should always be converted to a TupleInit or TupleValue if
+  // its value is needed.
+  context.SetLocal(node_id, Value::MakeNone());
+}
+
+auto HandleTupleInit(FunctionContext& context, SemIR::NodeId node_id,
+                     SemIR::Node node) -> void {
+  switch (SemIR::GetInitializingRepresentation(context.semantics_ir(),
+                                               node.type_id())
+              .kind) {
+    case SemIR::InitializingRepresentation::None:
+    case SemIR::InitializingRepresentation::InPlace:
+      // The elements were initialized in place.
+      context.SetLocal(node_id, Value::MakeNone());
+      break;
+
+    case SemIR::InitializingRepresentation::ByCopy: {
+      auto [tuple_literal_id, refs_id] = node.GetAsTupleInit();
+      context.SetLocal(node_id, EmitStructOrTupleValueRepresentation(
+                                    context, node_id, node.type_id(), refs_id));
+      break;
+    }
+  }
+}
+
+auto HandleTupleValue(FunctionContext& context, SemIR::NodeId node_id,
+                      SemIR::Node node) -> void {
+  auto [tuple_literal_id, refs_id] = node.GetAsTupleValue();
+  context.SetLocal(node_id, EmitStructOrTupleValueRepresentation(
+                                context, node_id, node.type_id(), refs_id));
+}
+
+auto HandleUnaryOperatorNot(FunctionContext& context, SemIR::NodeId node_id,
+                            SemIR::Node node) -> void {
+  auto operand = context.GetLocal(node.GetAsUnaryOperatorNot());
+  if (operand.kind != Value::Kind::Bool) {
+    context.Fail("Operand of `not` is not a bool");
+    return;
+  }
+  context.SetLocal(node_id, Value::MakeBool(!operand.boolean));
+}
+
+auto HandleVarStorage(FunctionContext& context, SemIR::NodeId node_id,
+                      SemIR::Node node) -> void {
+  context.GetStorage(node_id, node.type_id());
+}
+
+}  // namespace Cocktail::Interpret
@@ -0,0 +1,38 @@
+#include "Cocktail/Interpret/FunctionContext.h"
+#include "Cocktail/SemIR/File.h"
+
+namespace Cocktail::Interpret {
+
+auto HandleBindValue(FunctionContext& context, SemIR::NodeId node_id,
+                     SemIR::Node node) -> void {
+  // This loads a copy for a by-copy value representation, and is the address
+  // itself for a pointer value representation.
+  context.SetLocal(node_id, context.file_context().LoadValue(
+                                node.type_id(),
+                                context.GetLocal(node.GetAsBindValue())));
+}
+
+auto HandleTemporary(FunctionContext& context, SemIR::NodeId node_id,
+                     SemIR::Node node) -> void {
+  auto [temporary_id, init_id] = node.GetAsTemporary();
+  context.FinishInitialization(node.type_id(), temporary_id, init_id);
+  context.SetLocal(node_id, context.GetLocal(temporary_id));
+}
+
+auto HandleTemporaryStorage(FunctionContext& context, SemIR::NodeId node_id,
+                            SemIR::Node node) -> void {
+  context.GetStorage(node_id, node.type_id());
+}
+
+auto HandleValueAsReference(FunctionContext& context, SemIR::NodeId node_id,
+                            SemIR::Node node) -> void {
+  COCKTAIL_CHECK(SemIR::GetExpressionCategory(context.semantics_ir(),
+                                              node.GetAsValueAsReference()) ==
+                 SemIR::ExpressionCategory::Value);
+  COCKTAIL_CHECK(
+      SemIR::GetValueRepresentation(context.semantics_ir(), node.type_id())
+          .kind == SemIR::ValueRepresentation::Pointer);
+  context.SetLocal(node_id, context.GetLocal(node.GetAsValueAsReference()));
+}
+
+}  // namespace Cocktail::Interpret
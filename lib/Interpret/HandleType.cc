@@ -0,0 +1,30 @@
+#include "Cocktail/Interpret/FunctionContext.h"
+
+namespace Cocktail::Interpret {
+
+auto HandleArrayType(FunctionContext& context, SemIR::NodeId node_id,
+                     SemIR::Node /*node*/) -> void {
+  context.SetLocal(node_id, Value::MakeNone());
+}
+
+auto HandleConstType(FunctionContext& context, SemIR::NodeId node_id,
+                     SemIR::Node /*node*/) -> void {
+  context.SetLocal(node_id, Value::MakeNone());
+}
+
+auto HandlePointerType(FunctionContext& context, SemIR::NodeId node_id,
+                       SemIR::Node /*node*/) -> void {
+  context.SetLocal(node_id, Value::MakeNone());
+}
+
+auto HandleStructType(FunctionContext& context, SemIR::NodeId node_id,
+                      SemIR::Node /*node*/) -> void {
+  context.SetLocal(node_id, Value::MakeNone());
+}
+
+auto HandleTupleType(FunctionContext& context, SemIR::NodeId node_id,
+                     SemIR::Node /*node*/) -> void {
+  context.SetLocal(node_id, Value::MakeNone());
+}
+
+}  // namespace Cocktail::Interpret
@@ -0,0 +1,85 @@
+#include "Cocktail/Interpret/Interpret.h"
+
+#include "Cocktail/Interpret/FileContext.h"
+#include "Cocktail/SemIR/EntryPoint.h"
+#include "llvm/ADT/Sequence.h"
+
+namespace Cocktail::Interpret {
+
+auto Value::Print(llvm::raw_ostream& out) const -> void {
+  switch (kind) {
+    case Kind::Invalid:
+      out << "<invalid>";
+      break;
+    case Kind::None:
+      out << "()";
+      break;
+    case Kind::Integer:
+      out << integer;
+      break;
+    case Kind::Bool:
+      out << (boolean ? "true" : "false");
+      break;
+    case Kind::Real:
+      out << real;
+      break;
+    case Kind::Address:
+      out << "&" << address;
+      break;
+  }
+}
+
+auto InterpretFunction(const SemIR::File& semantics_ir,
+                       SemIR::FunctionId function_id,
+                       llvm::ArrayRef<Value> args, const Limits& limits,
+                       llvm::raw_ostream* vlog_stream) -> ErrorOr<Value> {
+  if (semantics_ir.GetFunction(function_id).return_slot_id.is_valid()) {
+    return Error("Can't return through a return slot from the outermost call");
+  }
+  FileContext context(semantics_ir, limits, vlog_stream);
+  Value result =
+      context.CallFunction(function_id, args, /*return_slot=*/Value());
+  if (context.failed()) {
+    return Error(context.error_message());
+  }
+  return result;
+}
+
+auto InterpretEntryPoint(const SemIR::File& semantics_ir, const Limits& limits,
+                         llvm::raw_ostream* vlog_stream) -> ErrorOr<int32_t> {
+  for (auto i : llvm::seq(0, semantics_ir.functions_size())) {
+    SemIR::FunctionId function_id(i);
+    if (!SemIR::IsEntryPoint(semantics_ir, function_id)) {
+      continue;
+    }
+    const auto& function = semantics_ir.GetFunction(function_id);
+    if (!semantics_ir.GetNodeBlock(function.param_refs_id).empty()) {
+      return Error("`Run` must not have parameters");
+    }
+
+    FileContext context(semantics_ir, limits, vlog_stream);
+    // An aggregate result is written to storage that lives for the rest of
+    // the run. Only scalar results become the exit code, so it's then unused.
+    Value return_slot;
+    if (function.return_slot_id.is_valid()) {
+      return_slot =
+          Value::MakeAddress(context.Allocate(function.return_type_id));
+    }
+    Value result = context.CallFunction(function_id, {}, return_slot);
+    if (context.failed()) {
+      return Error(context.error_message());
+    }
+    switch (result.kind) {
+      case Value::Kind::Integer:
+        return result.integer;
+      case Value::Kind::Bool:
+        return result.boolean ? 1 : 0;
+      default:
+        // TODO: Add an implicit `return 0` if `Run` doesn't return `i32`.
+        return 0;
+    }
+  }
+  return Error("No `Run` function to interpret");
+}
+
+}  // namespace Cocktail::Interpret
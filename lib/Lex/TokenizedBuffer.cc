@@ -694,6 +694,13 @@ class TokenizedBuffer::Lexer {
     return token;
   }
 
+  // 文件开始标记总是第一个标记，解析器以它作为 FileStart 节点的标记。
+  auto AddStartOfFileToken() -> void {
+    buffer_->AddToken({.kind = TokenKind::StartOfFile,
+                       .token_line = current_line_,
+                       .column = 0});
+  }
+
   auto AddEndOfFileToken() -> void {
     buffer_->AddToken({.kind = TokenKind::EndOfFile,
                        .token_line = current_line_,
@@ -801,8 +808,15 @@ auto TokenizedBuffer::Lex(SourceBuffer& source, DiagnosticConsumer& consumer)
   // 可以使用它来分派到正确的词法分析函数。
   constexpr Lexer::DispatchTableT DispatchTable = Lexer::MakeDispatchTable();
 
+  lexer.AddStartOfFileToken();
+
   llvm::StringRef source_text = source.text();
   while (lexer.SkipWhitespace(source_text)) {
+    // 只有出现错误之后才可能需要停止，这样无错误的输入不必每个标记都询问消费者。
+    if (error_tracking_consumer.seen_error() &&
+        error_tracking_consumer.ShouldStop()) {
+      break;
+    }
     Lexer::LexResult result =
         DispatchTable[static_cast<unsigned char>(source_text.front())](
             lexer, source_text);
@@ -1149,6 +1163,14 @@ auto TokenizedBuffer::SourceBufferLocationTranslator::GetLocation(
           .column_number = column_number + 1};
 }
 
+auto TokenizedBuffer::SourceBufferLocationTranslator::GetDeferredLocation(
+    DiagnosticArena& /*arena*/, const char* loc) -> DeferredDiagnosticLocation {
+  COCKTAIL_CHECK(StringRefContainsPointer(buffer_->source_->text(), loc))
+      << "location not within buffer";
+  return buffer_->source_->GetDeferredLocation(
+      loc - buffer_->source_->text().begin());
+}
+
 auto TokenLocationTranslator::GetLocation(Token token) -> DiagnosticLocation {
   const auto& token_info = buffer_->GetTokenInfo(token);
   const auto& line_info = buffer_->GetLineInfo(token_info.token_line);
@@ -1159,4 +1181,13 @@ auto TokenLocationTranslator::GetLocation(Token token) -> DiagnosticLocation {
       token_start);
 }
 
-}  // namespace Cocktail::Lex
\ No newline at end of file
+auto TokenLocationTranslator::GetDeferredLocation(DiagnosticArena& /*arena*/,
+                                                  Token token)
+    -> DeferredDiagnosticLocation {
+  const auto& token_info = buffer_->GetTokenInfo(token);
+  const auto& line_info = buffer_->GetLineInfo(token_info.token_line);
+  return buffer_->source_->GetDeferredLocation(line_info.start +
+                                               token_info.column);
+}
+
+}  // namespace Cocktail::Lex
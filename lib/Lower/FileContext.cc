@@ -4,6 +4,7 @@
 #include "Cocktail/Lower/FunctionContext.h"
 #include "Cocktail/SemIR/EntryPoint.h"
 #include "Cocktail/SemIR/File.h"
+#include "Cocktail/SemIR/IdRangeMap.h"
 #include "Cocktail/SemIR/Node.h"
 #include "Cocktail/SemIR/NodeKind.h"
 #include "llvm/ADT/STLExtras.h"
@@ -24,8 +25,12 @@ FileContext::FileContext(llvm::LLVMContext& llvm_context,
 }
 
 // TODO: Move this to lower.cpp.
-auto FileContext::Run() -> std::unique_ptr<llvm::Module> {
+auto FileContext::RunShard(int shard_index, int num_shards)
+    -> std::unique_ptr<llvm::Module> {
   COCKTAIL_CHECK(llvm_module_) << "Run can only be called once.";
+  COCKTAIL_CHECK(num_shards > 0 && shard_index >= 0 &&
+                 shard_index < num_shards)
+      << "Invalid shard " << shard_index << " of " << num_shards;
 
   // Lower types.
   auto types = semantics_ir_->types();
@@ -42,8 +47,10 @@ auto FileContext::Run() -> std::unique_ptr<llvm::Module> {
 
   // TODO: Lower global variable declarations.
 
-  // Lower function definitions.
-  for (auto i : llvm::seq(0, semantics_ir_->functions_size())) {
+  // Lower function definitions. Functions are dealt out round-robin so that
+  // shards stay balanced when large functions are clustered in the file.
+  for (int i = shard_index; i < semantics_ir_->functions_size();
+       i += num_shards) {
     BuildFunctionDefinition(SemIR::FunctionId(i));
   }
 
@@ -146,7 +153,9 @@ auto FileContext::BuildFunctionDefinition(SemIR::FunctionId function_id)
   }
 
   llvm::Function* llvm_function = GetFunction(function_id);
-  FunctionContext function_lowering(*this, llvm_function, vlog_stream_);
+  FunctionContext function_lowering(
+      *this, llvm_function,
+      SemIR::GetFunctionIdRanges(semantics_ir(), function_id), vlog_stream_);
 
   const bool has_return_slot = function.return_slot_id.is_valid();
 
@@ -247,4 +256,73 @@ auto FileContext::BuildType(SemIR::NodeId node_id) -> llvm::Type* {
   }
 }
 
-}  // namespace Cocktail::Lower
\ No newline at end of file
+auto FileContext::GetConstant(SemIR::NodeId constant_id) -> llvm::Constant* {
+  auto& constant = constants_[constant_id];
+  if (!constant) {
+    constant = BuildConstant(constant_id);
+  }
+  return constant;
+}
+
+// Builds the value representation of a constant struct or tuple whose elements
+// are the constants in `refs_id`. This mirrors
+// EmitStructOrTupleValueRepresentation, using a constant global in place of the
+// stack temporary.
+static auto BuildAggregateConstant(FileContext& context, SemIR::TypeId type_id,
+                                   SemIR::NodeBlockId refs_id,
+                                   llvm::StringRef name) -> llvm::Constant* {
+  auto* llvm_type = llvm::cast<llvm::StructType>(context.GetType(type_id));
+  auto value_rep = SemIR::GetValueRepresentation(context.semantics_ir(),
+                                                 type_id);
+  if (value_rep.kind == SemIR::ValueRepresentation::None) {
+    return llvm::PoisonValue::get(llvm_type);
+  }
+  COCKTAIL_CHECK(value_rep.kind != SemIR::ValueRepresentation::Custom)
+      << "Aggregate should never have custom value representation";
+
+  llvm::SmallVector<llvm::Constant*> elements;
+  for (auto ref_id : context.semantics_ir().GetNodeBlock(refs_id)) {
+    elements.push_back(context.GetConstant(ref_id));
+  }
+  auto* aggregate = llvm::ConstantStruct::get(llvm_type, elements);
+  if (value_rep.kind == SemIR::ValueRepresentation::Copy) {
+    return aggregate;
+  }
+  return new llvm::GlobalVariable(context.llvm_module(), llvm_type,
+                                  /*isConstant=*/true,
+                                  llvm::GlobalVariable::PrivateLinkage,
+                                  aggregate, name);
+}
+
+auto FileContext::BuildConstant(SemIR::NodeId constant_id) -> llvm::Constant* {
+  auto node = semantics_ir().GetNode(constant_id);
+  switch (node.kind()) {
+    case SemIR::NodeKind::BoolLiteral:
+      return llvm::ConstantInt::get(llvm::Type::getInt1Ty(*llvm_context_),
+                                    node.GetAsBoolLiteral().index);
+
+    case SemIR::NodeKind::IntegerLiteral: {
+      // TODO: This matches the lowering of integer literal nodes, and has the
+      // same lack of correct semantics.
+      const auto& value =
+          semantics_ir().GetIntegerLiteral(node.GetAsIntegerLiteral());
+      return llvm::ConstantInt::get(llvm::Type::getInt32Ty(*llvm_context_),
+                                    value.zextOrTrunc(32));
+    }
+
+    case SemIR::NodeKind::StructValue:
+      return BuildAggregateConstant(*this, node.type_id(),
+                                    node.GetAsStructValue().second,
+                                    "struct.const");
+
+    case SemIR::NodeKind::TupleValue:
+      return BuildAggregateConstant(*this, node.type_id(),
+                                    node.GetAsTupleValue().second,
+                                    "tuple.const");
+
+    default:
+      COCKTAIL_FATAL() << "Unexpected constant node " << node;
+  }
+}
+
+}  // namespace Cocktail::Lower
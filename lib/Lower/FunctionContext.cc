@@ -8,15 +8,18 @@ namespace Cocktail::Lower {
 
 FunctionContext::FunctionContext(FileContext& file_context,
                                  llvm::Function* function,
+                                 SemIR::FunctionIdRanges id_ranges,
                                  llvm::raw_ostream* vlog_stream)
     : file_context_(&file_context),
       function_(function),
       builder_(file_context.llvm_context()),
-      vlog_stream_(vlog_stream) {}
+      vlog_stream_(vlog_stream),
+      blocks_(id_ranges.node_blocks),
+      locals_(id_ranges.nodes) {}
 
 auto FunctionContext::GetBlock(SemIR::NodeBlockId block_id)
     -> llvm::BasicBlock* {
-  llvm::BasicBlock*& entry = blocks_[block_id];
+  llvm::BasicBlock*& entry = blocks_.Slot(block_id);
   if (!entry) {
     entry = llvm::BasicBlock::Create(llvm_context(), "", function_);
   }
@@ -25,9 +28,11 @@ auto FunctionContext::GetBlock(SemIR::NodeBlockId block_id)
 
 auto FunctionContext::TryToReuseBlock(SemIR::NodeBlockId block_id,
                                       llvm::BasicBlock* block) -> bool {
-  if (!blocks_.insert({block_id, block}).second) {
+  llvm::BasicBlock*& entry = blocks_.Slot(block_id);
+  if (entry) {
     return false;
   }
+  entry = block;
   if (block == synthetic_block_) {
     synthetic_block_ = nullptr;
   }
@@ -38,6 +43,13 @@ auto FunctionContext::LowerBlock(SemIR::NodeBlockId block_id) -> void {
   for (const auto& node_id : semantics_ir().GetNodeBlock(block_id)) {
     auto node = semantics_ir().GetNode(node_id);
     COCKTAIL_VLOG() << "Lowering " << node_id << ": " << node << "\n";
+    // Nodes that check folded to a constant are replaced by that constant.
+    // They have no side effects, so nothing else needs to be emitted.
+    if (auto constant_id = semantics_ir().GetConstantValue(node_id);
+        constant_id.is_valid()) {
+      SetLocal(node_id, file_context_->GetConstant(constant_id));
+      continue;
+    }
     // clang warns on unhandled enum values; clang-tidy is incorrect here.
     // NOLINTNEXTLINE(bugprone-switch-missing-default-case)
     switch (node.kind()) {
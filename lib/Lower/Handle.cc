@@ -52,10 +52,13 @@ auto HandleAssign(FunctionContext& context, SemIR::NodeId /*node_id*/,
   context.FinishInitialization(storage_type_id, storage_id, value_id);
 }
 
-auto HandleBinaryOperatorAdd(FunctionContext& /*context*/,
-                             SemIR::NodeId /*node_id*/, SemIR::Node node)
-    -> void {
-  COCKTAIL_FATAL() << "TODO: Add support: " << node;
+auto HandleBinaryOperatorAdd(FunctionContext& context, SemIR::NodeId node_id,
+                             SemIR::Node node) -> void {
+  auto [lhs_id, rhs_id] = node.GetAsBinaryOperatorAdd();
+  // TODO: Handle overflow once integer types carry signedness.
+  context.SetLocal(node_id, context.builder().CreateAdd(
+                                context.GetLocal(lhs_id),
+                                context.GetLocal(rhs_id), "add"));
 }
 
 auto HandleBindName(FunctionContext& context, SemIR::NodeId node_id,
@@ -1,6 +1,17 @@
 #include "Cocktail/Lower/Lower.h"
 
+#include <algorithm>
+#include <string>
+#include <thread>
+
+#include "Cocktail/Common/Check.h"
 #include "Cocktail/Lower/FileContext.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
 
 namespace Cocktail::Lower {
 
@@ -12,4 +23,97 @@ auto LowerToLLVM(llvm::LLVMContext& llvm_context, llvm::StringRef module_name,
   return context.Run();
 }
 
-}  // namespace Cocktail::Lower
\ No newline at end of file
+// Runs `lower_shard` for each shard index, using a worker thread for all but
+// the first shard, which runs on the calling thread.
+template <typename LowerShardFn>
+static auto ForEachShard(int num_shards, LowerShardFn lower_shard) -> void {
+  llvm::SmallVector<std::thread> workers;
+  workers.reserve(num_shards - 1);
+  for (int i = 1; i < num_shards; ++i) {
+    workers.emplace_back(lower_shard, i);
+  }
+  lower_shard(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+auto LowerToLLVMShards(llvm::StringRef module_name,
+                       const SemIR::File& semantics_ir, int num_shards)
+    -> llvm::SmallVector<LoweredShard> {
+  COCKTAIL_CHECK(num_shards > 0) << num_shards;
+  llvm::SmallVector<LoweredShard> shards(num_shards);
+  ForEachShard(num_shards, [&](int shard_index) {
+    auto& shard = shards[shard_index];
+    shard.llvm_context = std::make_unique<llvm::LLVMContext>();
+    FileContext context(*shard.llvm_context, module_name, semantics_ir,
+                        /*vlog_stream=*/nullptr);
+    shard.module = context.RunShard(shard_index, num_shards);
+  });
+  return shards;
+}
+
+auto LowerToLLVMParallel(llvm::LLVMContext& llvm_context,
+                         llvm::StringRef module_name,
+                         const SemIR::File& semantics_ir, int num_threads,
+                         llvm::raw_ostream* vlog_stream)
+    -> std::unique_ptr<llvm::Module> {
+  // There's no point in more shards than functions.
+  int num_shards = std::min(num_threads, semantics_ir.functions_size());
+  if (num_shards <= 1 || vlog_stream) {
+    return LowerToLLVM(llvm_context, module_name, semantics_ir, vlog_stream);
+  }
+
+  // The first shard is lowered directly into the destination context. The
+  // others are lowered into their own contexts and serialized to bitcode on
+  // their worker thread, because modules can only be linked within a single
+  // context.
+  std::unique_ptr<llvm::Module> module;
+  llvm::SmallVector<llvm::SmallString<0>> shard_bitcode(num_shards);
+  ForEachShard(num_shards, [&](int shard_index) {
+    if (shard_index == 0) {
+      FileContext context(llvm_context, module_name, semantics_ir,
+                          /*vlog_stream=*/nullptr);
+      module = context.RunShard(shard_index, num_shards);
+      return;
+    }
+    llvm::LLVMContext shard_context;
+    FileContext context(shard_context, module_name, semantics_ir,
+                        /*vlog_stream=*/nullptr);
+    auto shard_module = context.RunShard(shard_index, num_shards);
+    llvm::raw_svector_ostream out(shard_bitcode[shard_index]);
+    llvm::WriteBitcodeToFile(*shard_module, out);
+  });
+
+  // The first shard declares every function in source order. Linking replaces
+  // each declaration that a later shard defines with a new function at the end
+  // of the module, so note the order to restore it afterwards.
+  llvm::SmallVector<std::string> function_names;
+  for (const auto& function : *module) {
+    function_names.push_back(function.getName().str());
+  }
+
+  // Link in shard order so that the result doesn't depend on scheduling.
+  llvm::Linker linker(*module);
+  for (int i = 1; i < num_shards; ++i) {
+    auto shard_module = llvm::parseBitcodeFile(
+        llvm::MemoryBufferRef(shard_bitcode[i], module_name), llvm_context);
+    COCKTAIL_CHECK(shard_module) << "Failed to reload lowered shard " << i
+                                 << ": "
+                                 << llvm::toString(shard_module.takeError());
+    bool failed = linker.linkInModule(std::move(*shard_module));
+    COCKTAIL_CHECK(!failed) << "Failed to link lowered shard " << i;
+  }
+
+  // Move every function back to its source position, so that the module is
+  // the same as when lowering on a single thread.
+  auto& functions = module->getFunctionList();
+  for (const auto& name : function_names) {
+    llvm::Function* function = module->getFunction(name);
+    COCKTAIL_CHECK(function) << "Lost function " << name << " while linking";
+    functions.splice(functions.end(), functions, function->getIterator());
+  }
+  return module;
+}
+
+}  // namespace Cocktail::Lower
@@ -34,6 +34,11 @@ auto Tree::Parse(Lex::TokenizedBuffer& tokens, DiagnosticConsumer& consumer,
   }
 
   while (!context.state_stack().empty()) {
+    // The tree is incomplete when stopping early, so it's returned without the
+    // FileEnd node or verification, and is only good for reporting errors.
+    if (tree.has_errors_ && consumer.ShouldStop()) {
+      return tree;
+    }
     // clang warns on unhandled enum values; clang-tidy is incorrect here.
     // NOLINTNEXTLINE(bugprone-switch-missing-default-case)
     switch (context.state_stack().back().state) {
@@ -52,6 +52,63 @@ File::File(std::string filename, const File* builtins)
   }
 }
 
+auto File::AddIntegerConstant(TypeId type_id, llvm::APInt value) -> NodeId {
+  auto [it, added] = integer_constant_ids_.insert(
+      {value, IntegerLiteralId(integer_literals_.size())});
+  if (added) {
+    AddIntegerLiteral(value);
+  }
+  return AddConstantNode(
+      {NodeKind::IntegerLiteral.AsInt(), type_id.index, it->second.index},
+      Node::IntegerLiteral::Make(Parse::Node::Invalid, type_id, it->second));
+}
+
+auto File::AddBoolConstant(TypeId type_id, BoolValue value) -> NodeId {
+  return AddConstantNode(
+      {NodeKind::BoolLiteral.AsInt(), type_id.index, value.index},
+      Node::BoolLiteral::Make(Parse::Node::Invalid, type_id, value));
+}
+
+auto File::AddAggregateConstant(NodeKind kind, TypeId type_id,
+                                llvm::ArrayRef<NodeId> element_ids)
+    -> NodeId {
+  llvm::SmallVector<int32_t> key = {kind.AsInt(), type_id.index};
+  for (auto element_id : element_ids) {
+    key.push_back(element_id.index);
+  }
+  auto it = constant_nodes_.find(key);
+  if (it != constant_nodes_.end()) {
+    return it->second;
+  }
+
+  // Constant aggregates have no literal to refer back to.
+  auto refs_id = AddNodeBlock(element_ids);
+  switch (kind) {
+    case NodeKind::TupleValue:
+      return AddConstantNode(key, Node::TupleValue::Make(
+                                      Parse::Node::Invalid, type_id,
+                                      NodeId::Invalid, refs_id));
+    case NodeKind::StructValue:
+      return AddConstantNode(key, Node::StructValue::Make(
+                                      Parse::Node::Invalid, type_id,
+                                      NodeId::Invalid, refs_id));
+    default:
+      COCKTAIL_FATAL() << "Not an aggregate constant kind: " << kind;
+  }
+}
+
+auto File::AddConstantNode(llvm::ArrayRef<int32_t> key, Node node) -> NodeId {
+  auto it = constant_nodes_.find(key);
+  if (it != constant_nodes_.end()) {
+    return it->second;
+  }
+  auto node_id = AddNodeInNoBlock(node);
+  constant_nodes_.insert({AllocateCopy(key), node_id});
+  // A constant evaluates to itself.
+  SetConstantValue(node_id, node_id);
+  return node_id;
+}
+
 auto File::Verify() const -> ErrorOr<Success> {
   // Invariants don't necessarily hold for invalid IR.
   if (has_errors_) {
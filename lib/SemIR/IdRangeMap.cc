@@ -0,0 +1,77 @@
+#include "Cocktail/SemIR/IdRangeMap.h"
+
+#include <algorithm>
+
+#include "Cocktail/Common/Check.h"
+#include "Cocktail/SemIR/Node.h"
+#include "Cocktail/SemIR/NodeKind.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace Cocktail::SemIR {
+
+// Widens `range` to cover `index`. An empty range is replaced.
+static auto Widen(IdRange& range, int32_t index) -> void {
+  if (range.size() == 0) {
+    range = {.begin = index, .end = index + 1};
+    return;
+  }
+  range.begin = std::min(range.begin, index);
+  range.end = std::max(range.end, index + 1);
+}
+
+auto GetFunctionIdRanges(const File& file, FunctionId function_id)
+    -> FunctionIdRanges {
+  const auto& function = file.GetFunction(function_id);
+  COCKTAIL_CHECK(!function.body_block_ids.empty())
+      << "Function has no definition";
+
+  FunctionIdRanges ranges;
+  for (auto param_ref_id : file.GetNodeBlock(function.param_refs_id)) {
+    Widen(ranges.nodes, param_ref_id.index);
+  }
+  if (function.return_slot_id.is_valid()) {
+    Widen(ranges.nodes, function.return_slot_id.index);
+  }
+
+  // Walk the body blocks and the blocks that their nodes refer to.
+  llvm::SmallVector<NodeBlockId> worklist(function.body_block_ids.begin(),
+                                          function.body_block_ids.end());
+  for (auto block_id : worklist) {
+    Widen(ranges.node_blocks, block_id.index);
+  }
+  while (!worklist.empty()) {
+    auto block_id = worklist.pop_back_val();
+    for (auto node_id : file.GetNodeBlock(block_id)) {
+      Widen(ranges.nodes, node_id.index);
+      auto node = file.GetNode(node_id);
+      NodeBlockId ref_block_id = NodeBlockId::Invalid;
+      switch (node.kind()) {
+        case NodeKind::BlockArg:
+          ref_block_id = node.GetAsBlockArg();
+          break;
+        case NodeKind::Branch:
+          ref_block_id = node.GetAsBranch();
+          break;
+        case NodeKind::BranchIf:
+          ref_block_id = node.GetAsBranchIf().first;
+          break;
+        case NodeKind::BranchWithArg:
+          ref_block_id = node.GetAsBranchWithArg().first;
+          break;
+        case NodeKind::SpliceBlock:
+          // Spliced blocks aren't body blocks, so their nodes are walked too.
+          ref_block_id = node.GetAsSpliceBlock().first;
+          worklist.push_back(ref_block_id);
+          break;
+        default:
+          break;
+      }
+      if (ref_block_id.is_valid()) {
+        Widen(ranges.node_blocks, ref_block_id.index);
+      }
+    }
+  }
+  return ranges;
+}
+
+}  // namespace Cocktail::SemIR
@@ -1,7 +1,9 @@
 #include "Cocktail/Source/SourceBuffer.h"
 
+#include <algorithm>
 #include <limits>
 
+#include "Cocktail/Common/Check.h"
 #include "llvm/Support/ErrorOr.h"
 
 namespace Cocktail {
@@ -62,4 +64,43 @@ auto SourceBuffer::CreateFromFile(llvm::vfs::FileSystem& fs,
   return SourceBuffer(filename.str(), std::move(buffer.get()));
 }
 
-}  // namespace Cocktail
\ No newline at end of file
+auto SourceBuffer::GetLocation(int64_t offset) const -> DiagnosticLocation {
+  llvm::StringRef text = this->text();
+  COCKTAIL_CHECK(offset >= 0 && offset <= static_cast<int64_t>(text.size()))
+      << "offset " << offset << " not within buffer";
+
+  if (line_starts_.empty()) {
+    line_starts_.push_back(0);
+    for (size_t pos = text.find('\n'); pos != llvm::StringRef::npos;
+         pos = text.find('\n', pos + 1)) {
+      line_starts_.push_back(static_cast<int32_t>(pos + 1));
+    }
+  }
+
+  // 查找第一个在给定位置之后开始的行，然后退回一行。
+  auto line_it = std::partition_point(
+      line_starts_.begin(), line_starts_.end(),
+      [offset](int32_t line_start) { return line_start <= offset; });
+  --line_it;
+  int32_t line_start = *line_it;
+
+  llvm::StringRef line = text.substr(line_start);
+  line = line.take_front(line.find('\n'));
+  return {.file_name = filename_,
+          .line = line,
+          .line_number = static_cast<int32_t>(line_it - line_starts_.begin()) +
+                         1,
+          .column_number = static_cast<int32_t>(offset - line_start) + 1};
+}
+
+auto SourceBuffer::GetDeferredLocation(int64_t offset) const
+    -> DeferredDiagnosticLocation {
+  return {.context = this,
+          .offset = offset,
+          .resolve_fn = [](const void* context, int64_t offset) {
+            return static_cast<const SourceBuffer*>(context)->GetLocation(
+                offset);
+          }};
+}
+
+}  // namespace Cocktail
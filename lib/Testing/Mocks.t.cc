@@ -3,12 +3,12 @@
 namespace Cocktail {
 
 void PrintTo(const Diagnostic& diagnostic, std::ostream* os) {
-  *os << "Diagnostic{" << diagnostic.kind << ", ";
+  const auto& message = diagnostic.message;
+  auto location = message.location.Resolve();
+  *os << "Diagnostic{" << message.kind << ", ";
   PrintTo(diagnostic.level, os);
-  *os << ", " << diagnostic.location.file_name << ":"
-      << diagnostic.location.line_number << ":"
-      << diagnostic.location.column_number << ", \""
-      << diagnostic.format_fn(diagnostic) << "\"}";
+  *os << ", " << location.file_name << ":" << location.line_number << ":"
+      << location.column_number << ", \"" << message.Format() << "\"}";
 }
 
 void PrintTo(DiagnosticLevel level, std::ostream* os) {
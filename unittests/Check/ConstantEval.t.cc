@@ -0,0 +1,233 @@
+#include "Cocktail/Check/ConstantEval.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "Cocktail/SemIR/File.h"
+#include "Cocktail/SemIR/NodeKind.h"
+#include "Cocktail/Testing/Check.t.h"
+#include "llvm/ADT/Sequence.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace {
+
+using namespace Cocktail;
+
+using ::testing::ElementsAre;
+
+class ConstantEvalTest : public Testing::CheckTest {
+ protected:
+  /// Describes the canonical constant node `constant_id`.
+  static auto DescribeConstant(const SemIR::File& sem_ir,
+                               SemIR::NodeId constant_id) -> std::string {
+    auto constant = sem_ir.GetNode(constant_id);
+    switch (constant.kind()) {
+      case SemIR::NodeKind::IntegerLiteral:
+        return std::to_string(
+            sem_ir.GetIntegerLiteral(constant.GetAsIntegerLiteral())
+                .getSExtValue());
+      case SemIR::NodeKind::BoolLiteral:
+        return constant.GetAsBoolLiteral() == SemIR::BoolValue::True
+                   ? "true"
+                   : "false";
+      case SemIR::NodeKind::StructValue:
+      case SemIR::NodeKind::TupleValue: {
+        bool is_struct = constant.kind() == SemIR::NodeKind::StructValue;
+        auto refs_id = is_struct ? constant.GetAsStructValue().second
+                                 : constant.GetAsTupleValue().second;
+        std::string result = is_struct ? "{" : "(";
+        llvm::StringRef sep = "";
+        for (auto ref_id : sem_ir.GetNodeBlock(refs_id)) {
+          result += sep;
+          result += DescribeConstant(sem_ir, ref_id);
+          sep = ", ";
+        }
+        result += is_struct ? "}" : ")";
+        return result;
+      }
+      default:
+        return "?";
+    }
+  }
+
+  /// Describes the constant value of each node of kind `kind` in `sem_ir`, in
+  /// order, or `-` for nodes that weren't folded.
+  static auto DescribeFolds(const SemIR::File& sem_ir, SemIR::NodeKind kind)
+      -> llvm::SmallVector<std::string> {
+    llvm::SmallVector<std::string> folds;
+    for (auto i : llvm::seq(0, sem_ir.nodes_size())) {
+      SemIR::NodeId node_id(i);
+      if (sem_ir.GetNode(node_id).kind() != kind) {
+        continue;
+      }
+      auto constant_id = sem_ir.GetConstantValue(node_id);
+      folds.push_back(constant_id.is_valid()
+                          ? DescribeConstant(sem_ir, constant_id)
+                          : "-");
+    }
+    return folds;
+  }
+
+  /// Describes each call in `sem_ir`, in order, as `callee = value` if it was
+  /// folded, or just `callee` if not.
+  static auto DescribeCalls(const SemIR::File& sem_ir)
+      -> llvm::SmallVector<std::string> {
+    llvm::SmallVector<std::string> calls;
+    for (auto i : llvm::seq(0, sem_ir.nodes_size())) {
+      SemIR::NodeId node_id(i);
+      auto node = sem_ir.GetNode(node_id);
+      if (node.kind() != SemIR::NodeKind::Call) {
+        continue;
+      }
+      const auto& function = sem_ir.GetFunction(node.GetAsCall().second);
+      std::string call = sem_ir.GetString(function.name_id).str();
+      auto constant_id = sem_ir.GetConstantValue(node_id);
+      if (constant_id.is_valid()) {
+        call += " = " + DescribeConstant(sem_ir, constant_id);
+      }
+      calls.push_back(call);
+    }
+    return calls;
+  }
+};
+
+TEST_F(ConstantEvalTest, FoldsOperators) {
+  auto sem_ir = CheckSource(R"(
+fn Run(n: i32, b: bool) -> i32 {
+  var sum: i32 = 1 + 2 + 3;
+  var partial: i32 = n + 1;
+  var negated: bool = not false;
+  var flipped: bool = not b;
+  var both: bool = true and false;
+  var either: bool = true or b;
+  var unknown: bool = b and true;
+  var skipped: bool = false and b;
+  return sum;
+}
+)");
+  EXPECT_THAT(DescribeFolds(sem_ir, SemIR::NodeKind::BinaryOperatorAdd),
+              ElementsAre("3", "6", "-"));
+  EXPECT_THAT(DescribeFolds(sem_ir, SemIR::NodeKind::UnaryOperatorNot),
+              ElementsAre("true", "-"));
+  // The result of `and` and `or` is the argument of their resume block. It's
+  // constant when the first operand decides it, even if the second isn't.
+  EXPECT_THAT(DescribeFolds(sem_ir, SemIR::NodeKind::BlockArg),
+              ElementsAre("false", "true", "-", "false"));
+}
+
+TEST_F(ConstantEvalTest, FoldsAggregates) {
+  auto sem_ir = CheckSource(R"(
+fn Run(n: i32) -> i32 {
+  let t: (i32, bool) = (1 + 2, not true);
+  let s: {.a: i32, .b: i32} = {.a = 4, .b = 5};
+  let u: (i32, i32) = (n, 1);
+  return n;
+}
+)");
+  EXPECT_THAT(DescribeFolds(sem_ir, SemIR::NodeKind::TupleValue),
+              ElementsAre("(3, false)", "-"));
+  EXPECT_THAT(DescribeFolds(sem_ir, SemIR::NodeKind::StructValue),
+              ElementsAre("{4, 5}"));
+}
+
+TEST_F(ConstantEvalTest, FoldsArrayBound) {
+  auto sem_ir = CheckSource(R"(
+fn Run() -> i32 {
+  var a: [i32; 1 + 2];
+  return 0;
+}
+)");
+  EXPECT_THAT(DescribeFolds(sem_ir, SemIR::NodeKind::BinaryOperatorAdd),
+              ElementsAre("3"));
+}
+
+TEST_F(ConstantEvalTest, FoldsCalls) {
+  auto sem_ir = CheckSource(R"(
+fn Add(a: i32, b: i32) -> i32 {
+  return a + b;
+}
+
+fn Both(a: bool, b: bool) -> bool {
+  return a and b;
+}
+
+fn Count(n: i32) -> i32 {
+  var total: i32 = 0;
+  var go: bool = true;
+  while (go) {
+    total = Add(total, n);
+    go = false;
+  }
+  return total;
+}
+
+fn Run() -> i32 {
+  var a: i32 = Add(Add(1, 2), 3);
+  var b: bool = Both(true, false);
+  var c: i32 = Count(5);
+  return a;
+}
+)");
+  EXPECT_THAT(DescribeCalls(sem_ir),
+              ElementsAre("Add", "Add = 3", "Add = 6", "Both = false",
+                          "Count = 5"));
+}
+
+TEST_F(ConstantEvalTest, DoesNotFold) {
+  auto sem_ir = CheckSource(R"(
+fn Add(a: i32, b: i32) -> i32 {
+  return a + b;
+}
+
+fn Forever(n: i32) -> i32 {
+  while (true) {
+  }
+  return n;
+}
+
+fn Recurse(n: i32) -> i32 {
+  return Recurse(1);
+}
+
+fn Point(x: i32) -> {.x: i32, .y: i32} {
+  return {.x = x, .y = x};
+}
+
+fn Run(n: i32) -> i32 {
+  // The argument isn't constant.
+  var a: i32 = Add(n, 1);
+  // Exceeds the check-time limits. The second call reuses the failure.
+  var b: i32 = Forever(1);
+  var c: i32 = Forever(1);
+  // Returns through a return slot.
+  var p: {.x: i32, .y: i32} = Point(1);
+  return a;
+}
+)");
+  // The call in `Recurse` isn't folded because `Recurse` is still being
+  // checked.
+  EXPECT_THAT(DescribeCalls(sem_ir), ElementsAre("Recurse", "Add", "Forever",
+                                                 "Forever", "Point"));
+}
+
+TEST_F(ConstantEvalTest, DoesNotFoldAfterError) {
+  auto sem_ir = CheckSource(R"(
+fn Add(a: i32, b: i32) -> i32 {
+  return a + b;
+}
+
+fn Bad() -> i32 {
+  return missing;
+}
+
+fn Run() -> i32 {
+  return Add(1, 2);
+}
+)",
+                            /*has_errors=*/true);
+  EXPECT_THAT(DescribeCalls(sem_ir), ElementsAre("Add"));
+}
+
+}  // namespace
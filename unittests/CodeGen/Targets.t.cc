@@ -0,0 +1,57 @@
+#include "Cocktail/CodeGen/Targets.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace Cocktail {
+namespace {
+
+using ::testing::Contains;
+using ::testing::StrEq;
+
+TEST(TargetsTest, CompiledInBackends) {
+  EXPECT_THAT(GetCompiledInBackends(), Contains("X86"));
+}
+
+TEST(TargetsTest, InitializesBackendOnce) {
+  std::string errors;
+  llvm::raw_string_ostream errors_stream(errors);
+  EXPECT_TRUE(
+      InitializeTargetForTriple("x86_64-unknown-linux-gnu", errors_stream));
+  // Initializing again, or for another triple on the same backend, is a no-op.
+  EXPECT_TRUE(
+      InitializeTargetForTriple("x86_64-unknown-linux-gnu", errors_stream));
+  EXPECT_TRUE(InitializeTargetForTriple("i686-pc-windows-msvc", errors_stream));
+  EXPECT_THAT(errors, StrEq(""));
+
+  std::string lookup_error;
+  EXPECT_NE(llvm::TargetRegistry::lookupTarget("x86_64-unknown-linux-gnu",
+                                               lookup_error),
+            nullptr)
+      << lookup_error;
+}
+
+TEST(TargetsTest, NoBackendForTarget) {
+  std::string errors;
+  llvm::raw_string_ostream errors_stream(errors);
+  EXPECT_FALSE(InitializeTargetForTriple("not-a-target", errors_stream));
+  EXPECT_THAT(errors,
+              StrEq("ERROR: No backend for target 'not-a-target' is compiled "
+                    "in. Available backends: X86\n"));
+
+  // A known architecture whose backend isn't compiled in is also an error.
+  errors.clear();
+  EXPECT_FALSE(
+      InitializeTargetForTriple("aarch64-unknown-linux-gnu", errors_stream));
+  EXPECT_THAT(errors, StrEq("ERROR: No backend for target "
+                            "'aarch64-unknown-linux-gnu' is compiled in. "
+                            "Available backends: X86\n"));
+}
+
+}  // namespace
+}  // namespace Cocktail
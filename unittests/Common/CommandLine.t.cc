@@ -0,0 +1,73 @@
+#include "Cocktail/Common/CommandLine.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace Cocktail::CommandLine {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+TEST(ExpandResponseFilesTest, NoResponseFiles) {
+  llvm::vfs::InMemoryFileSystem fs;
+  llvm::BumpPtrAllocator allocator;
+  llvm::StringSaver saver(allocator);
+  llvm::SmallVector<llvm::StringRef> expanded;
+  std::string errors;
+  llvm::raw_string_ostream errors_stream(errors);
+
+  EXPECT_TRUE(ExpandResponseFiles({"compile", "a.cocktail"}, fs, saver,
+                                  expanded, errors_stream));
+  EXPECT_THAT(expanded, ElementsAre("compile", "a.cocktail"));
+  EXPECT_EQ(errors_stream.str(), "");
+}
+
+TEST(ExpandResponseFilesTest, Nested) {
+  llvm::vfs::InMemoryFileSystem fs;
+  fs.addFile("outer.rsp", /*ModificationTime=*/0,
+             llvm::MemoryBuffer::getMemBuffer("--phase=check @inner.rsp\n"
+                                              "\"c d.cocktail\"\n"));
+  fs.addFile("inner.rsp", /*ModificationTime=*/0,
+             llvm::MemoryBuffer::getMemBuffer("a.cocktail b.cocktail"));
+  llvm::BumpPtrAllocator allocator;
+  llvm::StringSaver saver(allocator);
+  llvm::SmallVector<llvm::StringRef> expanded;
+  std::string errors;
+  llvm::raw_string_ostream errors_stream(errors);
+
+  EXPECT_TRUE(ExpandResponseFiles({"compile", "@outer.rsp", "e.cocktail"}, fs,
+                                  saver, expanded, errors_stream));
+  EXPECT_THAT(expanded, ElementsAre("compile", "--phase=check", "a.cocktail",
+                                    "b.cocktail", "c d.cocktail",
+                                    "e.cocktail"));
+  EXPECT_EQ(errors_stream.str(), "");
+}
+
+TEST(ExpandResponseFilesTest, Errors) {
+  llvm::vfs::InMemoryFileSystem fs;
+  fs.addFile("cycle.rsp", /*ModificationTime=*/0,
+             llvm::MemoryBuffer::getMemBuffer("@cycle.rsp"));
+  llvm::BumpPtrAllocator allocator;
+  llvm::StringSaver saver(allocator);
+  llvm::SmallVector<llvm::StringRef> expanded;
+  std::string errors;
+  llvm::raw_string_ostream errors_stream(errors);
+
+  EXPECT_FALSE(ExpandResponseFiles({"@missing.rsp"}, fs, saver, expanded,
+                                   errors_stream));
+  EXPECT_THAT(errors_stream.str(), HasSubstr("missing.rsp"));
+
+  errors.clear();
+  EXPECT_FALSE(
+      ExpandResponseFiles({"@cycle.rsp"}, fs, saver, expanded, errors_stream));
+  EXPECT_THAT(errors_stream.str(), HasSubstr("nested"));
+}
+
+}  // namespace
+}  // namespace Cocktail::CommandLine
@@ -3,7 +3,11 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <optional>
+#include <string>
+
 #include "Cocktail/Testing/Mocks.t.h"
+#include "llvm/ADT/APSInt.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/FormatVariadic.h"
 
@@ -56,4 +60,39 @@ TEST_F(DiagnosticEmitterTest, EmitOneArgDiagnostic) {
   emitter_.Emit(1, TestDiagnostic, "str");
 }
 
+TEST_F(DiagnosticEmitterTest, EmitStringArgOutlivesCaller) {
+  COCKTAIL_DIAGNOSTIC(TestDiagnostic, Error, "arg: `{0}`", std::string);
+  std::optional<Diagnostic> diagnostic;
+  EXPECT_CALL(consumer_, HandleDiagnostic(testing::_))
+      .WillOnce([&](Diagnostic d) { diagnostic = std::move(d); });
+  {
+    std::string arg = "temporary";
+    emitter_.Emit(1, TestDiagnostic, arg);
+    arg = "overwritten";
+  }
+  // The argument is copied into the consumer's arena, and only formatted when
+  // requested.
+  ASSERT_TRUE(diagnostic.has_value());
+  EXPECT_EQ(diagnostic->message.Format(), "arg: `temporary`");
+}
+
+TEST_F(DiagnosticEmitterTest, EmitIntegerArgs) {
+  COCKTAIL_DIAGNOSTIC(TestDiagnostic, Error, "{0} and {1} and {2}",
+                      llvm::APInt, llvm::APSInt, llvm::APSInt);
+  std::optional<Diagnostic> diagnostic;
+  EXPECT_CALL(consumer_, HandleDiagnostic(testing::_))
+      .WillOnce([&](Diagnostic d) { diagnostic = std::move(d); });
+  {
+    // Wider than 64 bits, so the values live on the heap.
+    llvm::APInt negative(128, -5, /*isSigned=*/true);
+    llvm::APSInt big(llvm::APInt::getMaxValue(128), /*isUnsigned=*/true);
+    llvm::APSInt small(llvm::APInt(32, -7, /*isSigned=*/true),
+                       /*isUnsigned=*/false);
+    emitter_.Emit(1, TestDiagnostic, negative, big, small);
+  }
+  ASSERT_TRUE(diagnostic.has_value());
+  EXPECT_EQ(diagnostic->message.Format(),
+            "-5 and 340282366920938463463374607431768211455 and -7");
+}
+
 }  // namespace
\ No newline at end of file
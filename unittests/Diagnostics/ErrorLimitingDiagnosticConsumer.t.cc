@@ -0,0 +1,72 @@
+#include "Cocktail/Diagnostics/ErrorLimitingDiagnosticConsumer.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "Cocktail/Diagnostics/DiagnosticEmitter.h"
+#include "Cocktail/Testing/Mocks.t.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace {
+
+using namespace Cocktail;
+using namespace Cocktail::Testing;
+using ::testing::InSequence;
+
+COCKTAIL_DIAGNOSTIC(TestDiagnostic, Error, "{0}", llvm::StringRef);
+COCKTAIL_DIAGNOSTIC(TestDiagnosticWarning, Warning, "{0}", llvm::StringRef);
+
+struct FakeDiagnosticLocationTranslator
+    : DiagnosticLocationTranslator<DiagnosticLocation> {
+  auto GetLocation(DiagnosticLocation loc) -> DiagnosticLocation override {
+    return loc;
+  }
+};
+
+TEST(ErrorLimitingDiagnosticConsumerTest, StopsAtLimit) {
+  FakeDiagnosticLocationTranslator translator;
+  Testing::MockDiagnosticConsumer consumer;
+  ErrorLimitingDiagnosticConsumer limiting_consumer(consumer, 2);
+  DiagnosticEmitter<DiagnosticLocation> emitter(translator, limiting_consumer);
+
+  InSequence s;
+  EXPECT_CALL(consumer, HandleDiagnostic(
+                            IsDiagnostic(DiagnosticKind::TestDiagnostic,
+                                         DiagnosticLevel::Error, 1, 1, "M1")));
+  EXPECT_CALL(consumer,
+              HandleDiagnostic(IsDiagnostic(
+                  DiagnosticKind::TestDiagnosticWarning,
+                  DiagnosticLevel::Warning, 2, 1, "M2")));
+  EXPECT_CALL(consumer, HandleDiagnostic(
+                            IsDiagnostic(DiagnosticKind::TestDiagnostic,
+                                         DiagnosticLevel::Error, 3, 1, "M3")));
+
+  emitter.Emit({"f", "", 1, 1}, TestDiagnostic, "M1");
+  emitter.Emit({"f", "", 2, 1}, TestDiagnosticWarning, "M2");
+  EXPECT_FALSE(limiting_consumer.ShouldStop());
+  emitter.Emit({"f", "", 3, 1}, TestDiagnostic, "M3");
+  EXPECT_TRUE(limiting_consumer.ShouldStop());
+  emitter.Emit({"f", "", 4, 1}, TestDiagnostic, "M4");
+  emitter.Emit({"f", "", 5, 1}, TestDiagnosticWarning, "M5");
+
+  EXPECT_EQ(limiting_consumer.error_count(), 2);
+  EXPECT_EQ(limiting_consumer.dropped_count(), 2);
+}
+
+TEST(ErrorLimitingDiagnosticConsumerTest, ZeroIsUnlimited) {
+  FakeDiagnosticLocationTranslator translator;
+  Testing::MockDiagnosticConsumer consumer;
+  ErrorLimitingDiagnosticConsumer limiting_consumer(consumer, 0);
+  DiagnosticEmitter<DiagnosticLocation> emitter(translator, limiting_consumer);
+
+  EXPECT_CALL(consumer, HandleDiagnostic(IsDiagnostic(
+                            DiagnosticKind::TestDiagnostic,
+                            DiagnosticLevel::Error, 1, 1, "M")))
+      .Times(3);
+  for (int i = 0; i < 3; ++i) {
+    emitter.Emit({"f", "", 1, 1}, TestDiagnostic, "M");
+  }
+  EXPECT_FALSE(limiting_consumer.ShouldStop());
+}
+
+}  // namespace
@@ -29,11 +29,11 @@ TEST(SortedDiagnosticEmitterTest, SortErrors) {
   SortingDiagnosticConsumer sorting_consumer(consumer);
   DiagnosticEmitter<DiagnosticLocation> emitter(translator, sorting_consumer);
 
-  emitter.Emit({"f", 2, 1}, TestDiagnostic, "M1");
-  emitter.Emit({"f", 1, 1}, TestDiagnostic, "M2");
-  emitter.Emit({"f", 1, 3}, TestDiagnostic, "M3");
-  emitter.Emit({"f", 3, 4}, TestDiagnostic, "M4");
-  emitter.Emit({"f", 3, 2}, TestDiagnostic, "M5");
+  emitter.Emit({"f", "", 2, 1}, TestDiagnostic, "M1");
+  emitter.Emit({"f", "", 1, 1}, TestDiagnostic, "M2");
+  emitter.Emit({"f", "", 1, 3}, TestDiagnostic, "M3");
+  emitter.Emit({"f", "", 3, 4}, TestDiagnostic, "M4");
+  emitter.Emit({"f", "", 3, 2}, TestDiagnostic, "M5");
 
   InSequence s;
   EXPECT_CALL(consumer, HandleDiagnostic(
@@ -0,0 +1,76 @@
+#include "Cocktail/Diagnostics/StructuredDiagnosticConsumer.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "Cocktail/Diagnostics/DiagnosticEmitter.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace {
+
+using namespace Cocktail;
+using ::testing::HasSubstr;
+using ::testing::StartsWith;
+
+COCKTAIL_DIAGNOSTIC(TestDiagnostic, Error, "{0}", llvm::StringRef);
+COCKTAIL_DIAGNOSTIC(TestDiagnosticNote, Note, "note");
+
+struct FakeDiagnosticLocationTranslator
+    : DiagnosticLocationTranslator<DiagnosticLocation> {
+  auto GetLocation(DiagnosticLocation loc) -> DiagnosticLocation override {
+    return loc;
+  }
+};
+
+TEST(StructuredDiagnosticConsumerTest, JsonLines) {
+  std::string buffer;
+  llvm::raw_string_ostream out(buffer);
+  FakeDiagnosticLocationTranslator translator;
+  JsonLinesDiagnosticConsumer consumer(out);
+  DiagnosticEmitter<DiagnosticLocation> emitter(translator, consumer);
+
+  emitter.Build({"f.carbon", "", 2, 3}, TestDiagnostic, "say \"hi\"\n")
+      .Note({"f.carbon", "", 1, 1}, TestDiagnosticNote)
+      .Emit();
+  emitter.Emit({"f.carbon", "", 4, 5}, TestDiagnostic, "M2");
+  consumer.Flush();
+
+  EXPECT_EQ(out.str(),
+            "{\"kind\":\"TestDiagnostic\",\"file\":\"f.carbon\",\"line\":2,"
+            "\"column\":3,\"message\":\"say \\\"hi\\\"\\n\",\"level\":\"error\","
+            "\"notes\":[{\"kind\":\"TestDiagnosticNote\",\"file\":\"f.carbon\","
+            "\"line\":1,\"column\":1,\"message\":\"note\"}]}\n"
+            "{\"kind\":\"TestDiagnostic\",\"file\":\"f.carbon\",\"line\":4,"
+            "\"column\":5,\"message\":\"M2\",\"level\":\"error\","
+            "\"notes\":[]}\n");
+}
+
+TEST(StructuredDiagnosticConsumerTest, Sarif) {
+  std::string buffer;
+  llvm::raw_string_ostream out(buffer);
+  {
+    FakeDiagnosticLocationTranslator translator;
+    SarifDiagnosticConsumer consumer(out);
+    DiagnosticEmitter<DiagnosticLocation> emitter(translator, consumer);
+    emitter.Emit({"f.carbon", "", 2, 3}, TestDiagnostic, "M1");
+    emitter.Emit({"f.carbon", "", 0, 0}, TestDiagnostic, "M2");
+    consumer.Flush();
+  }
+
+  EXPECT_THAT(out.str(), StartsWith("{\"$schema\":"));
+  EXPECT_THAT(out.str(),
+              HasSubstr("{\"ruleId\":\"TestDiagnostic\",\"level\":\"error\","
+                        "\"message\":{\"text\":\"M1\"},\"locations\":[{"
+                        "\"physicalLocation\":{\"artifactLocation\":{\"uri\":"
+                        "\"f.carbon\"},\"region\":{\"startLine\":2,"
+                        "\"startColumn\":3}}}]}"));
+  EXPECT_THAT(out.str(),
+              HasSubstr("\"physicalLocation\":{\"artifactLocation\":{\"uri\":"
+                        "\"f.carbon\"}}}]}"));
+  EXPECT_THAT(out.str(), HasSubstr("\n]}]}\n"));
+}
+
+}  // namespace
@@ -3,36 +3,41 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
-#include "Cocktail/Diagnostics/DiagnosticEmitter.h"
-#include "Cocktail/Testing/Yaml.t.h"
-#include "llvm/ADT/SmallString.h"
-#include "llvm/Support/FileSystem.h"
-#include "llvm/Support/SourceMgr.h"
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/VirtualFileSystem.h"
 
 namespace {
 
 using namespace Cocktail;
-using namespace Cocktail::Testing;
-using namespace Cocktail::Testing::Yaml;
 
+using ::testing::_;
 using ::testing::ElementsAre;
 using ::testing::HasSubstr;
+using ::testing::Not;
+using ::testing::Pair;
+using ::testing::StartsWith;
 using ::testing::StrEq;
 
-/// A raw_ostream that makes it easy to repeatedly check streamed output.
-class RawTestOstream : public llvm::raw_ostream {
+/// A raw_pwrite_stream that makes it easy to repeatedly check streamed output.
+class RawTestOstream : public llvm::raw_pwrite_stream {
  public:
+  RawTestOstream() { SetUnbuffered(); }
+
   ~RawTestOstream() override {
-    flush();
     if (!buffer_.empty()) {
       ADD_FAILURE() << "Unchecked output:\n" << buffer_;
     }
   }
 
-  /// Flushes the stream and returns the contents so far, clearing the stream
-  /// back to empty.
+  /// Returns the contents so far, clearing the stream back to empty.
   auto TakeStr() -> std::string {
-    flush();
     std::string result = std::move(buffer_);
     buffer_.clear();
     return result;
@@ -40,7 +45,11 @@ class RawTestOstream : public llvm::raw_ostream {
 
  private:
   void write_impl(const char* ptr, size_t size) override {
-    buffer_.append(ptr, ptr + size);
+    buffer_.append(ptr, size);
+  }
+
+  void pwrite_impl(const char* ptr, size_t size, uint64_t offset) override {
+    buffer_.replace(offset, size, ptr, size);
   }
 
   [[nodiscard]] auto current_pos() const -> uint64_t override {
@@ -50,192 +59,498 @@ class RawTestOstream : public llvm::raw_ostream {
   std::string buffer_;
 };
 
-TEST(DriverTest, FullCommandErrors) {
-  RawTestOstream test_output_stream;
-  RawTestOstream test_error_stream;
-  Driver driver = Driver(test_output_stream, test_error_stream);
+class DriverTest : public ::testing::Test {
+ protected:
+  DriverTest() : driver_(fs_, test_output_stream_, test_error_stream_) {}
+
+  /// Adds a file holding `text` to the driver's file system, and returns its
+  /// path.
+  auto CreateTestFile(llvm::StringRef file_name, llvm::StringRef text)
+      -> std::string {
+    std::string path = ("/test/" + file_name).str();
+    fs_.addFile(path, /*ModificationTime=*/0,
+                llvm::MemoryBuffer::getMemBufferCopy(text));
+    return path;
+  }
+
+  /// Parses each line of `text` as a JSON Lines record, returning the kind
+  /// and message of each.
+  static auto ParseJsonLines(llvm::StringRef text)
+      -> llvm::SmallVector<std::pair<std::string, std::string>> {
+    llvm::SmallVector<std::pair<std::string, std::string>> records;
+    llvm::SmallVector<llvm::StringRef> lines;
+    text.split(lines, '\n', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+    for (auto line : lines) {
+      auto record = llvm::json::parse(line);
+      if (!record) {
+        ADD_FAILURE() << "Invalid JSON: " << line << ": "
+                      << llvm::toString(record.takeError());
+        continue;
+      }
+      const auto* object = record->getAsObject();
+      records.push_back({object->getString("kind").value_or("").str(),
+                         object->getString("message").value_or("").str()});
+    }
+    return records;
+  }
+
+  /// Parses `text` as a SARIF document, returning the rule ID and message of
+  /// each result.
+  static auto ParseSarif(llvm::StringRef text)
+      -> llvm::SmallVector<std::pair<std::string, std::string>> {
+    llvm::SmallVector<std::pair<std::string, std::string>> results;
+    auto document = llvm::json::parse(text);
+    if (!document) {
+      ADD_FAILURE() << "Invalid JSON: " << text << ": "
+                    << llvm::toString(document.takeError());
+      return results;
+    }
+    const auto* run =
+        document->getAsObject()->getArray("runs")->front().getAsObject();
+    for (const auto& result : *run->getArray("results")) {
+      const auto* object = result.getAsObject();
+      results.push_back(
+          {object->getString("ruleId").value_or("").str(),
+           object->getObject("message")->getString("text").value_or("").str()});
+    }
+    return results;
+  }
+
+  /// Returns the module ID of each LLVM IR module in `ir`, in order.
+  static auto GetModuleIds(llvm::StringRef ir)
+      -> llvm::SmallVector<std::string> {
+    llvm::SmallVector<std::string> ids;
+    llvm::SmallVector<llvm::StringRef> lines;
+    ir.split(lines, '\n');
+    for (auto line : lines) {
+      if (line.consume_front("; ModuleID = ")) {
+        ids.push_back(line.trim("'").str());
+      }
+    }
+    return ids;
+  }
 
-  EXPECT_FALSE(driver.RunFullCommand({}));
-  EXPECT_THAT(test_error_stream.TakeStr(), HasSubstr("ERROR"));
+  /// Runs the driver with `args`.
+  auto Run(std::initializer_list<llvm::StringRef> args) -> bool {
+    return driver_.RunCommand(llvm::SmallVector<llvm::StringRef>(args));
+  }
 
-  EXPECT_FALSE(driver.RunFullCommand({"foo"}));
-  EXPECT_THAT(test_error_stream.TakeStr(), HasSubstr("ERROR"));
+  llvm::vfs::InMemoryFileSystem fs_;
+  RawTestOstream test_output_stream_;
+  RawTestOstream test_error_stream_;
+  Driver driver_;
+};
 
-  EXPECT_FALSE(driver.RunFullCommand({"foo --bar --baz"}));
-  EXPECT_THAT(test_error_stream.TakeStr(), HasSubstr("ERROR"));
+// Several functions that call each other, so that each shard both defines
+// functions and declares ones defined by other shards.
+constexpr llvm::StringLiteral CallsProgram = R"(
+fn Add(a: i32, b: i32) -> i32 {
+  return a + b;
 }
 
-TEST(DriverTest, Help) {
-  RawTestOstream test_output_stream;
-  RawTestOstream test_error_stream;
-  Driver driver = Driver(test_output_stream, test_error_stream);
+fn Twice(n: i32) -> i32 {
+  return Add(n, n);
+}
 
-  EXPECT_TRUE(driver.RunHelpSubcommand(ConsoleDiagnosticConsumer(), {}));
-  EXPECT_THAT(test_error_stream.TakeStr(), StrEq(""));
-  auto help_text = test_output_stream.TakeStr();
+fn Point(x: i32) -> {.x: i32, .y: i32} {
+  return {.x = x, .y = Twice(x)};
+}
 
-  // Help text should mention each subcommand.
-#define COCKTAIL_SUBCOMMAND(Name, Spelling, ...) \
-  EXPECT_THAT(help_text, HasSubstr(Spelling));
-#include "Cocktail/Driver/Flags.def"
+fn Pick(c: bool, a: i32, b: i32) -> i32 {
+  if (c) {
+    return a;
+  }
+  return b;
+}
 
-  // Check that the subcommand dispatch works.
-  EXPECT_TRUE(driver.RunFullCommand({"help"}));
-  EXPECT_THAT(test_error_stream.TakeStr(), StrEq(""));
-  EXPECT_THAT(test_output_stream.TakeStr(), StrEq(help_text));
+fn Run() -> i32 {
+  var p: {.x: i32, .y: i32} = Point(2);
+  return Pick(true, p.x, p.y);
 }
+)";
 
-TEST(DriverTest, HelpErrors) {
-  RawTestOstream test_output_stream;
-  RawTestOstream test_error_stream;
-  Driver driver = Driver(test_output_stream, test_error_stream);
+TEST_F(DriverTest, CommandErrors) {
+  EXPECT_FALSE(Run({}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), HasSubstr("No input files"));
 
-  EXPECT_FALSE(driver.RunHelpSubcommand(ConsoleDiagnosticConsumer(), {"foo"}));
-  EXPECT_THAT(test_output_stream.TakeStr(), StrEq(""));
-  EXPECT_THAT(test_error_stream.TakeStr(), HasSubstr("ERROR"));
+  EXPECT_FALSE(Run({"foo"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), HasSubstr("ERROR"));
 
-  EXPECT_FALSE(driver.RunHelpSubcommand(ConsoleDiagnosticConsumer(), {"help"}));
-  EXPECT_THAT(test_output_stream.TakeStr(), StrEq(""));
-  EXPECT_THAT(test_error_stream.TakeStr(), HasSubstr("ERROR"));
+  EXPECT_FALSE(Run({"compile"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), HasSubstr("No input files"));
 
-  EXPECT_FALSE(
-      driver.RunHelpSubcommand(ConsoleDiagnosticConsumer(), {"--xyz"}));
-  EXPECT_THAT(test_output_stream.TakeStr(), StrEq(""));
-  EXPECT_THAT(test_error_stream.TakeStr(), HasSubstr("ERROR"));
-}
-
-auto CreateTestFile(llvm::StringRef text) -> std::string {
-  int fd = -1;
-  llvm::SmallString<1024> path;
-  auto ec = llvm::sys::fs::createTemporaryFile("test_file", ".txt", fd, path);
-  if (ec) {
-    llvm::report_fatal_error(llvm::Twine("Failed to create temporary file: ") +
-                             ec.message());
+  EXPECT_FALSE(Run({"compile", "/not/a/real/file/name.cocktail"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), HasSubstr("ERROR"));
+}
+
+TEST_F(DriverTest, ReusesBuiltins) {
+  auto path = CreateTestFile("calls.cocktail", CallsProgram);
+
+  // The second compile checks against the builtins built by the first.
+  EXPECT_TRUE(Run({"compile", "--phase=check", "--dump-raw-sem-ir",
+                   "--builtin-sem-ir", path}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  auto first = test_output_stream_.TakeStr();
+  EXPECT_TRUE(Run({"compile", "--phase=check", "--dump-raw-sem-ir",
+                   "--builtin-sem-ir", path}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  EXPECT_THAT(test_output_stream_.TakeStr(), StrEq(first));
+}
+
+TEST_F(DriverTest, LowerThreadsMatchesSingleThreaded) {
+  auto path = CreateTestFile("calls.cocktail", CallsProgram);
+
+  EXPECT_TRUE(Run({"compile", "--phase=lower", "--dump-llvm-ir", path}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  auto single_threaded = test_output_stream_.TakeStr();
+  EXPECT_THAT(single_threaded, HasSubstr("define i32 @Twice("));
+
+  // Both more and fewer shards than functions.
+  for (llvm::StringRef threads : {"--lower-threads=2", "--lower-threads=16"}) {
+    SCOPED_TRACE(threads.str());
+    EXPECT_TRUE(
+        Run({"compile", "--phase=lower", "--dump-llvm-ir", threads, path}));
+    EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+    EXPECT_THAT(test_output_stream_.TakeStr(), StrEq(single_threaded));
   }
 
-  llvm::raw_fd_ostream s(fd, /*shouldClose=*/true);
-  s << text;
-  s.close();
-
-  return path.str().str();
-}
-
-TEST(DriverTest, DumpTokens) {
-  RawTestOstream test_output_stream;
-  RawTestOstream test_error_stream;
-  Driver driver = Driver(test_output_stream, test_error_stream);
-
-  auto test_file_path = CreateTestFile("Hello World");
-  EXPECT_TRUE(driver.RunDumpTokensSubcommand(ConsoleDiagnosticConsumer(),
-                                             {test_file_path}));
-  EXPECT_THAT(test_error_stream.TakeStr(), StrEq(""));
-  auto tokenized_text = test_output_stream.TakeStr();
-
-  EXPECT_THAT(Yaml::Value::FromText(tokenized_text),
-              ElementsAre(Yaml::MappingValue{
-                  {"token", Yaml::MappingValue{{"index", "0"},
-                                               {"kind", "Identifier"},
-                                               {"line", "1"},
-                                               {"column", "1"},
-                                               {"indent", "1"},
-                                               {"spelling", "Hello"},
-                                               {"identifier", "0"},
-                                               {"has_trailing_space", "true"}}},
-                  {"token", Yaml::MappingValue{{"index", "1"},
-                                               {"kind", "Identifier"},
-                                               {"line", "1"},
-                                               {"column", "7"},
-                                               {"indent", "1"},
-                                               {"spelling", "World"},
-                                               {"identifier", "1"},
-                                               {"has_trailing_space", "true"}}},
-                  {"token", Yaml::MappingValue{{"index", "2"},
-                                               {"kind", "EndOfFile"},
-                                               {"line", "1"},
-                                               {"column", "12"},
-                                               {"indent", "1"},
-                                               {"spelling", ""}}}}));
-
-  // Check that the subcommand dispatch works.
-  EXPECT_TRUE(driver.RunFullCommand({"dump-tokens", test_file_path}));
-  EXPECT_THAT(test_error_stream.TakeStr(), StrEq(""));
-  EXPECT_THAT(test_output_stream.TakeStr(), StrEq(tokenized_text));
-}
-
-TEST(DriverTest, DumpTokenErrors) {
-  RawTestOstream test_output_stream;
-  RawTestOstream test_error_stream;
-  Driver driver = Driver(test_output_stream, test_error_stream);
-
-  EXPECT_FALSE(driver.RunDumpTokensSubcommand(ConsoleDiagnosticConsumer(), {}));
-  EXPECT_THAT(test_output_stream.TakeStr(), StrEq(""));
-  EXPECT_THAT(test_error_stream.TakeStr(), HasSubstr("ERROR"));
+  EXPECT_FALSE(Run({"compile", "--phase=lower", "--lower-threads=-1", path}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("`--lower-threads` must not be negative"));
+}
+
+TEST_F(DriverTest, LowersFoldedConstants) {
+  auto path = CreateTestFile("constants.cocktail", R"(
+fn Run() -> i32 {
+  let t: (i32, i32) = (1, 2 + 3);
+  return 1 + 2 + 3;
+}
+)");
+
+  EXPECT_TRUE(Run({"compile", "--phase=lower", "--dump-llvm-ir", path}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  auto ir = test_output_stream_.TakeStr();
+  // Folded expressions are replaced by their values, and constant aggregates
+  // with a pointer representation become globals.
+  EXPECT_THAT(ir, HasSubstr("ret i32 6"));
+  EXPECT_THAT(ir, HasSubstr("@tuple.const = private constant { i32, i32 } "
+                            "{ i32 1, i32 5 }"));
+  EXPECT_THAT(ir, Not(HasSubstr(" add ")));
+}
 
+TEST_F(DriverTest, Emit) {
+  auto path = CreateTestFile("calls.cocktail", CallsProgram);
+
+  EXPECT_TRUE(Run({"compile", "--emit=asm", "--output=-", path}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  EXPECT_THAT(test_output_stream_.TakeStr(), HasSubstr("Twice:"));
+
+  // Without `--force-obj-output`, `--emit=obj` writes assembly to stdout.
+  EXPECT_TRUE(Run({"compile", "--emit=obj", "--output=-", path}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  EXPECT_THAT(test_output_stream_.TakeStr(), HasSubstr("Twice:"));
+
+  EXPECT_TRUE(Run({"compile", "--emit=bc", "--output=-", path}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  auto bitcode = test_output_stream_.TakeStr();
+  EXPECT_THAT(bitcode, StartsWith("BC\xC0\xDE"));
+  auto lto_info = llvm::getBitcodeLTOInfo(
+      llvm::MemoryBufferRef(bitcode, "bitcode"));
+  ASSERT_TRUE(!!lto_info) << llvm::toString(lto_info.takeError());
+  EXPECT_FALSE(lto_info->HasSummary);
+
+  EXPECT_TRUE(Run({"compile", "--emit=thinlto-bc", "--output=-", path}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  auto thinlto_bitcode = test_output_stream_.TakeStr();
+  EXPECT_THAT(thinlto_bitcode, Not(StrEq(bitcode)));
+  auto thinlto_info = llvm::getBitcodeLTOInfo(
+      llvm::MemoryBufferRef(thinlto_bitcode, "thinlto-bitcode"));
+  ASSERT_TRUE(!!thinlto_info) << llvm::toString(thinlto_info.takeError());
+  EXPECT_TRUE(thinlto_info->IsThinLTO);
+  EXPECT_TRUE(thinlto_info->HasSummary);
+
+  EXPECT_FALSE(Run({"compile", "--emit=exe", path}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), HasSubstr("ERROR"));
+}
+
+TEST_F(DriverTest, InputDir) {
+  // Created out of order; each directory is searched in sorted order.
+  CreateTestFile("dir/z.cocktail", "");
+  CreateTestFile("dir/sub/c.cocktail", "");
+  CreateTestFile("dir/b.cocktail", "");
+  CreateTestFile("dir/a.cocktail", "");
+  CreateTestFile("dir/notes.txt", "");
+  auto path = CreateTestFile("calls.cocktail", CallsProgram);
+
+  // Files named directly come before those found by searching.
+  EXPECT_TRUE(Run({"compile", "--phase=lower", "--dump-llvm-ir",
+                   "--input-dir=/test/dir", path}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  EXPECT_THAT(GetModuleIds(test_output_stream_.TakeStr()),
+              ElementsAre(path, "/test/dir/a.cocktail", "/test/dir/b.cocktail",
+                          "/test/dir/sub/c.cocktail", "/test/dir/z.cocktail"));
+
+  CreateTestFile("empty/notes.txt", "");
+  EXPECT_FALSE(Run({"compile", "--phase=lex", "--input-dir=/test/empty"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              StrEq("/test/empty: No `*.cocktail` files in input directory.\n"));
+
+  EXPECT_FALSE(Run({"compile", "--phase=lex", "--input-dir=/test/missing"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              StartsWith("/test/missing: Error searching input directory: "));
+}
+
+TEST_F(DriverTest, ResponseFiles) {
+  auto path = CreateTestFile("calls.cocktail", CallsProgram);
+  auto spaced_path = CreateTestFile("with space.cocktail", "");
+  CreateTestFile("inputs.rsp", "\"" + spaced_path + "\"\n" + path + "\n");
+  CreateTestFile("args.rsp", "--phase=lower\n--dump-llvm-ir @/test/inputs.rsp");
+
+  // Response files may be nested, and quote arguments containing spaces.
+  EXPECT_TRUE(Run({"compile", "@/test/args.rsp"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  EXPECT_THAT(GetModuleIds(test_output_stream_.TakeStr()),
+              ElementsAre(spaced_path, path));
+
+  EXPECT_FALSE(Run({"compile", "@/test/missing.rsp"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              StartsWith("ERROR: Unable to read response file "
+                         "`/test/missing.rsp`: "));
+
+  CreateTestFile("cycle.rsp", "@/test/cycle.rsp");
+  EXPECT_FALSE(Run({"compile", "@/test/cycle.rsp"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("ERROR: Response files nested more than"));
+}
+
+TEST_F(DriverTest, ErrorLimit) {
+  auto path = CreateTestFile("errors.cocktail", "$\n$\n$\n$\n");
+  constexpr llvm::StringLiteral Message = "unrecognized characters";
+
+  EXPECT_FALSE(Run({"compile", "--phase=check", path}));
+  EXPECT_EQ(llvm::StringRef(test_error_stream_.TakeStr()).count(Message), 4);
+
+  // Lexing stops at the second error, and later phases are skipped.
+  EXPECT_FALSE(Run({"compile", "--phase=check", "--error-limit=2", path}));
+  auto errors = test_error_stream_.TakeStr();
+  EXPECT_EQ(llvm::StringRef(errors).count(Message), 2);
+  EXPECT_THAT(errors,
+              HasSubstr("/test/errors.cocktail: Stopped lex after 2 errors "
+                        "(--error-limit); 0 later diagnostics were not "
+                        "reported.\n"));
+
+  // A limit that isn't reached changes nothing.
+  EXPECT_FALSE(Run({"compile", "--phase=check", "--error-limit=5", path}));
+  errors = test_error_stream_.TakeStr();
+  EXPECT_EQ(llvm::StringRef(errors).count(Message), 4);
+  EXPECT_THAT(errors, Not(HasSubstr("--error-limit")));
+}
+
+TEST_F(DriverTest, ErrorLimitStructured) {
+  auto path = CreateTestFile("errors.cocktail", "$\n$\n$\n$\n");
+  constexpr llvm::StringLiteral Truncated =
+      "Stopped lex after 2 errors (--error-limit); 0 later diagnostics were "
+      "not reported.";
+
+  EXPECT_FALSE(Run({"compile", "--phase=check", "--error-limit=2",
+                    "--diagnostics-format=jsonl", path}));
+  EXPECT_THAT(ParseJsonLines(test_error_stream_.TakeStr()),
+              ElementsAre(Pair("UnrecognizedCharacters", _),
+                          Pair("UnrecognizedCharacters", _),
+                          Pair("ErrorLimitReached", Truncated.str())));
+
+  EXPECT_FALSE(Run({"compile", "--phase=check", "--error-limit=2",
+                    "--diagnostics-format=sarif", path}));
+  EXPECT_THAT(ParseSarif(test_error_stream_.TakeStr()),
+              ElementsAre(Pair("UnrecognizedCharacters", _),
+                          Pair("UnrecognizedCharacters", _),
+                          Pair("ErrorLimitReached", Truncated.str())));
+}
+
+TEST_F(DriverTest, DriverErrorsStructured) {
+  auto path = CreateTestFile("calls.cocktail", CallsProgram);
+
+  // Errors from CodeGen are reported as records rather than text.
+  EXPECT_FALSE(Run({"compile", "--target=not-a-target", "--output=-",
+                    "--diagnostics-format=jsonl", path}));
+  EXPECT_THAT(ParseJsonLines(test_error_stream_.TakeStr()),
+              ElementsAre(Pair("DriverError", HasSubstr("not-a-target"))));
+
+  EXPECT_FALSE(Run({"compile", "--target=not-a-target", "--output=-",
+                    "--diagnostics-format=sarif", path}));
+  EXPECT_THAT(ParseSarif(test_error_stream_.TakeStr()),
+              ElementsAre(Pair("DriverError", HasSubstr("not-a-target"))));
+
+  EXPECT_FALSE(Run({"compile", "--target=not-a-target", "--output=-", path}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              StartsWith("ERROR: Invalid target: "));
+}
+
+TEST_F(DriverTest, FrontEndPipelineMatchesStreamed) {
+  llvm::SmallVector<std::string> paths = {
+      CreateTestFile("a_check_error.cocktail",
+                     "fn Run() -> i32 {\n  return missing;\n}\n"),
+      CreateTestFile("b_ok.cocktail", CallsProgram),
+      CreateTestFile("c_parse_error.cocktail", "fn Run() -> i32 {\n"),
+      CreateTestFile("d_check_error.cocktail",
+                     "fn F() -> i32 {\n  return also_missing;\n}\n"),
+  };
+
+  for (llvm::StringRef phase : {"--phase=parse", "--phase=check"}) {
+    SCOPED_TRACE(phase.str());
+    llvm::SmallVector<llvm::StringRef> args = {"compile", phase};
+    args.append(paths.begin(), paths.end());
+
+    // Without dumps or streamed errors, the front end runs as a pipeline.
+    EXPECT_FALSE(driver_.RunCommand(args));
+    EXPECT_THAT(test_output_stream_.TakeStr(), StrEq(""));
+    auto pipelined = test_error_stream_.TakeStr();
+
+    args.push_back("--stream-errors");
+    EXPECT_FALSE(driver_.RunCommand(args));
+    EXPECT_THAT(test_output_stream_.TakeStr(), StrEq(""));
+    EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(pipelined));
+
+    // Diagnostics are in the order the files were given.
+    auto parse_error = pipelined.find("c_parse_error.cocktail");
+    ASSERT_NE(parse_error, std::string::npos);
+    if (phase == "--phase=check") {
+      auto first_check_error = pipelined.find("a_check_error.cocktail");
+      auto second_check_error = pipelined.find("d_check_error.cocktail");
+      ASSERT_NE(first_check_error, std::string::npos);
+      ASSERT_NE(second_check_error, std::string::npos);
+      EXPECT_LT(first_check_error, parse_error);
+      EXPECT_LT(parse_error, second_check_error);
+    } else {
+      EXPECT_THAT(pipelined, Not(HasSubstr("check_error.cocktail")));
+    }
+  }
+}
+
+TEST_F(DriverTest, MemoryLeanTimeReport) {
+  auto first = CreateTestFile("first.cocktail", CallsProgram);
+  auto second = CreateTestFile("second.cocktail", CallsProgram);
+
+  EXPECT_TRUE(Run({"compile", "--phase=lower", "--time-report", first,
+                   second}));
+  EXPECT_THAT(test_output_stream_.TakeStr(), StrEq(""));
+  auto report = test_error_stream_.TakeStr();
+  EXPECT_THAT(report, HasSubstr("===== Time report ====="));
+  EXPECT_THAT(report, HasSubstr("Check::CheckParseTree"));
+  EXPECT_THAT(report, HasSubstr("Lower::LowerToLLVMParallel"));
+  EXPECT_THAT(report, HasSubstr("(memory-lean off)"));
+  // The pipelined front end frees each unit's front end once it's checked.
+  EXPECT_THAT(report,
+              HasSubstr("Freed early: 2 front ends, 0 SemIR files, 0 LLVM "
+                        "modules\n"));
+
+  EXPECT_TRUE(Run({"compile", "--phase=lower", "--memory-lean",
+                   "--time-report", first, second}));
+  EXPECT_THAT(test_output_stream_.TakeStr(), StrEq(""));
+  report = test_error_stream_.TakeStr();
+  EXPECT_THAT(report, HasSubstr("(memory-lean on)"));
+  EXPECT_THAT(report,
+              HasSubstr("Freed early: 2 front ends, 2 SemIR files, 2 LLVM "
+                        "modules\n"));
+
+  // The report follows a structured diagnostics document rather than
+  // interrupting it.
+  EXPECT_TRUE(Run({"compile", "--phase=lower", "--time-report",
+                   "--diagnostics-format=sarif", first}));
+  EXPECT_THAT(test_output_stream_.TakeStr(), StrEq(""));
+  report = test_error_stream_.TakeStr();
+  auto report_start = report.find("===== Time report =====");
+  ASSERT_NE(report_start, std::string::npos);
+  EXPECT_THAT(ParseSarif(llvm::StringRef(report).take_front(report_start)),
+              ElementsAre());
+
+  // Without `--time-report`, nothing is printed.
+  EXPECT_TRUE(Run({"compile", "--phase=lower", "--memory-lean", first}));
+  EXPECT_THAT(test_output_stream_.TakeStr(), StrEq(""));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+}
+
+TEST_F(DriverTest, Interpret) {
+  auto calls = CreateTestFile("calls.cocktail", CallsProgram);
+  auto params = CreateTestFile("params.cocktail",
+                               "fn Run(n: i32) -> i32 {\n  return n;\n}\n");
+
+  // `Run` returns `Pick(true, p.x, p.y)`, where `p` is `Point(2)`.
+  EXPECT_TRUE(Run({"compile", "--phase=check", "--interpret", calls}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  EXPECT_THAT(test_output_stream_.TakeStr(),
+              StrEq(calls + ": Run returned 2\n"));
+
+  // Interpreting replaces lowering and codegen.
+  EXPECT_TRUE(Run({"compile", "--interpret", calls}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  EXPECT_THAT(test_output_stream_.TakeStr(),
+              StrEq(calls + ": Run returned 2\n"));
+
+  // Failures are reported per file, and don't stop later files.
   EXPECT_FALSE(
-      driver.RunDumpTokensSubcommand(ConsoleDiagnosticConsumer(), {"--xyz"}));
-  EXPECT_THAT(test_output_stream.TakeStr(), StrEq(""));
-  EXPECT_THAT(test_error_stream.TakeStr(), HasSubstr("ERROR"));
-
-  EXPECT_FALSE(driver.RunDumpTokensSubcommand(ConsoleDiagnosticConsumer(),
-                                              {"/not/a/real/file/name"}));
-  EXPECT_THAT(test_output_stream.TakeStr(), StrEq(""));
-  EXPECT_THAT(test_error_stream.TakeStr(), HasSubstr("ERROR"));
-}
-
-TEST(DriverTest, DumpParseTree) {
-  RawTestOstream test_output_stream;
-  RawTestOstream test_error_stream;
-  Driver driver = Driver(test_output_stream, test_error_stream);
-
-  auto test_file_path = CreateTestFile("var v: Int = 42;");
-  EXPECT_TRUE(driver.RunDumpParseTreeSubcommand(ConsoleDiagnosticConsumer(),
-                                                {test_file_path}));
-  EXPECT_THAT(test_error_stream.TakeStr(), StrEq(""));
-  auto tokenized_text = test_output_stream.TakeStr();
-
-  EXPECT_THAT(
-      Yaml::Value::FromText(tokenized_text),
-      ElementsAre(Yaml::SequenceValue{
-          Yaml::MappingValue{
-              {"node_index", "6"},
-              {"kind", "VariableDeclaration"},
-              {"text", "var"},
-              {"subtree_size", "7"},
-              {"children",
-               Yaml::SequenceValue{
-                   Yaml::MappingValue{
-                       {"node_index", "2"},
-                       {"kind", "PatternBinding"},
-                       {"text", ":"},
-                       {"subtree_size", "3"},
-                       {"children",
-                        Yaml::SequenceValue{
-                            Yaml::MappingValue{{"node_index", "0"},
-                                               {"kind", "DeclaredName"},
-                                               {"text", "v"}},
-                            Yaml::MappingValue{{"node_index", "1"},
-                                               {"kind", "NameReference"},
-                                               {"text", "Int"}}}}},
-                   Yaml::MappingValue{{"node_index", "4"},
-                                      {"kind", "VariableInitializer"},
-                                      {"text", "="},
-                                      {"subtree_size", "2"},
-                                      {"children",  //
-                                       Yaml::SequenceValue{Yaml::MappingValue{
-                                           {"node_index", "3"},
-                                           {"kind", "Literal"},
-                                           {"text", "42"}}}}},
-                   Yaml::MappingValue{{"node_index", "5"},
-                                      {"kind", "DeclarationEnd"},
-                                      {"text", ";"}}}}},
-          Yaml::MappingValue{{"node_index", "7"},  //
-                             {"kind", "FileEnd"},
-                             {"text", ""}}}));
-
-  // Check that the subcommand dispatch works.
-  EXPECT_TRUE(driver.RunFullCommand({"dump-parse-tree", test_file_path}));
-  EXPECT_THAT(test_error_stream.TakeStr(), StrEq(""));
-  EXPECT_THAT(test_output_stream.TakeStr(), StrEq(tokenized_text));
+      Run({"compile", "--phase=check", "--interpret", params, calls}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              StrEq("ERROR: " + params + ": `Run` must not have parameters\n"));
+  EXPECT_THAT(test_output_stream_.TakeStr(),
+              StrEq(calls + ": Run returned 2\n"));
+
+  auto no_run = CreateTestFile("no_run.cocktail",
+                               "fn NotRun() -> i32 {\n  return 0;\n}\n");
+  EXPECT_FALSE(Run({"compile", "--phase=check", "--interpret", no_run}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              StrEq("ERROR: " + no_run + ": No `Run` function to interpret\n"));
+  EXPECT_THAT(test_output_stream_.TakeStr(), StrEq(""));
+
+  // With a structured format, failures are records against the file.
+  EXPECT_FALSE(Run({"compile", "--phase=check", "--interpret",
+                    "--diagnostics-format=jsonl", no_run}));
+  EXPECT_THAT(ParseJsonLines(test_error_stream_.TakeStr()),
+              ElementsAre(Pair("DriverError",
+                               "No `Run` function to interpret")));
+  EXPECT_THAT(test_output_stream_.TakeStr(), StrEq(""));
+
+  EXPECT_FALSE(Run({"compile", "--phase=parse", "--interpret", calls}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("Requested interpreting but compile phase is limited"));
+}
+
+TEST_F(DriverTest, Serve) {
+  auto path = CreateTestFile("calls.cocktail", CallsProgram);
+  auto bad_path = CreateTestFile("bad.cocktail", "fn Run() -> i32 {");
+
+  std::istringstream requests(
+      "compile --phase=check " + path + "\n" +
+      // Blank lines are skipped.
+      "\n" +
+      // A failure doesn't stop later commands.
+      "compile --phase=check " + bad_path + "\n" +
+      // `serve` can't be nested, including after a global flag.
+      "serve\n" + "-v serve\n" +
+      // The builtins checked by earlier commands are reused.
+      "compile --phase=lower " + path + "\n");
+  EXPECT_FALSE(driver_.Serve(requests));
+  EXPECT_THAT(test_output_stream_.TakeStr(),
+              StrEq("serve: ok\nserve: failed\nserve: failed\n"
+                    "serve: failed\nserve: ok\n"));
+  auto errors = test_error_stream_.TakeStr();
+  EXPECT_THAT(errors, HasSubstr("bad.cocktail"));
+  EXPECT_THAT(errors, HasSubstr("ERROR: `serve` can't be nested"));
+
+  // `serve` may run again once the previous one finishes.
+  std::istringstream more_requests("compile --phase=check " + path + "\n");
+  EXPECT_TRUE(driver_.Serve(more_requests));
+  EXPECT_THAT(test_output_stream_.TakeStr(), StrEq("serve: ok\n"));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+}
+
+TEST_F(DriverTest, ServeQuotedArguments) {
+  auto path = CreateTestFile("with space.cocktail", CallsProgram);
+
+  std::istringstream requests("compile --phase=check \"" + path + "\"\n");
+  EXPECT_TRUE(driver_.Serve(requests));
+  EXPECT_THAT(test_output_stream_.TakeStr(), StrEq("serve: ok\n"));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
 }
 
 }  // namespace
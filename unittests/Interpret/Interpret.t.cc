@@ -0,0 +1,232 @@
+#include "Cocktail/Interpret/Interpret.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "Cocktail/SemIR/File.h"
+#include "Cocktail/Testing/Check.t.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace {
+
+using namespace Cocktail;
+
+using ::testing::HasSubstr;
+
+class InterpretTest : public Testing::CheckTest {
+ protected:
+  /// Runs the function `name` with integer `args`, and returns its integer
+  /// result, or fails the test and returns -1.
+  static auto RunInteger(const SemIR::File& sem_ir, llvm::StringRef name,
+                         llvm::ArrayRef<int32_t> args,
+                         const Interpret::Limits& limits = {}) -> int32_t {
+    llvm::SmallVector<Interpret::Value> values;
+    for (int32_t arg : args) {
+      values.push_back(Interpret::Value::MakeInteger(arg));
+    }
+    auto result =
+        Interpret::InterpretFunction(sem_ir, GetFunctionId(sem_ir, name),
+                                     values, limits, /*vlog_stream=*/nullptr);
+    if (!result.ok()) {
+      ADD_FAILURE() << "Running " << name.str() << ": " << result.error();
+      return -1;
+    }
+    EXPECT_EQ(result->kind, Interpret::Value::Kind::Integer);
+    return result->integer;
+  }
+};
+
+// The tests run functions with parameters, so that calls and operators are
+// interpreted rather than folded while checking.
+
+TEST_F(InterpretTest, Calls) {
+  auto sem_ir = CheckSource(R"(
+fn Add(a: i32, b: i32) -> i32 {
+  return a + b;
+}
+
+fn Twice(n: i32) -> i32 {
+  return Add(n, n);
+}
+
+fn Sum(a: i32, b: i32, c: i32) -> i32 {
+  return Add(Twice(a), Add(b, c));
+}
+)");
+  EXPECT_EQ(RunInteger(sem_ir, "Add", {2, 3}), 5);
+  EXPECT_EQ(RunInteger(sem_ir, "Twice", {-4}), -8);
+  EXPECT_EQ(RunInteger(sem_ir, "Sum", {1, 10, 100}), 112);
+  // Arithmetic wraps, as in the lowered `add`.
+  EXPECT_EQ(RunInteger(sem_ir, "Add", {2147483647, 1}), -2147483648);
+}
+
+TEST_F(InterpretTest, BlockArgBranches) {
+  auto sem_ir = CheckSource(R"(
+fn Pick(c: bool, a: i32, b: i32) -> i32 {
+  if (c) {
+    return a;
+  }
+  return b;
+}
+
+fn PickAnd(c: bool, d: bool, a: i32, b: i32) -> i32 {
+  return Pick(c and d, a, b);
+}
+
+fn PickOr(c: bool, d: bool, a: i32, b: i32) -> i32 {
+  return Pick(c or d, a, b);
+}
+
+fn AddOnce(n: i32) -> i32 {
+  var go: bool = true;
+  var total: i32 = 0;
+  while (go) {
+    total = total + n;
+    go = false;
+  }
+  return total;
+}
+)");
+  auto pick_and = GetFunctionId(sem_ir, "PickAnd");
+  auto pick_or = GetFunctionId(sem_ir, "PickOr");
+  for (bool c : {false, true}) {
+    for (bool d : {false, true}) {
+      SCOPED_TRACE(testing::Message() << "c = " << c << ", d = " << d);
+      llvm::SmallVector<Interpret::Value> args = {
+          Interpret::Value::MakeBool(c), Interpret::Value::MakeBool(d),
+          Interpret::Value::MakeInteger(1), Interpret::Value::MakeInteger(2)};
+      auto and_result = Interpret::InterpretFunction(
+          sem_ir, pick_and, args, {}, /*vlog_stream=*/nullptr);
+      ASSERT_TRUE(and_result.ok()) << and_result.error();
+      EXPECT_EQ(and_result->integer, c && d ? 1 : 2);
+      auto or_result = Interpret::InterpretFunction(
+          sem_ir, pick_or, args, {}, /*vlog_stream=*/nullptr);
+      ASSERT_TRUE(or_result.ok()) << or_result.error();
+      EXPECT_EQ(or_result->integer, c || d ? 1 : 2);
+    }
+  }
+  EXPECT_EQ(RunInteger(sem_ir, "AddOnce", {7}), 7);
+}
+
+TEST_F(InterpretTest, Aggregates) {
+  auto sem_ir = CheckSource(R"(
+fn Point(x: i32, y: i32) -> {.x: i32, .y: i32} {
+  return {.x = x, .y = y};
+}
+
+fn StructSum(x: i32) -> i32 {
+  var p: {.x: i32, .y: i32} = Point(x, x + 1);
+  p.y = p.y + 10;
+  return p.x + p.y;
+}
+
+fn TupleSum(a: i32, b: i32) -> i32 {
+  var t: (i32, i32, i32) = (a, b, a);
+  t[1] = t[1] + b;
+  return t[0] + t[1] + t[2];
+}
+
+fn ArrayPick(a: i32, b: i32, c: i32) -> i32 {
+  var arr: [i32; 3] = (a, b, c);
+  arr[0] = arr[2];
+  return arr[0] + arr[1];
+}
+)");
+  EXPECT_EQ(RunInteger(sem_ir, "StructSum", {3}), 17);
+  EXPECT_EQ(RunInteger(sem_ir, "TupleSum", {1, 2}), 6);
+  EXPECT_EQ(RunInteger(sem_ir, "ArrayPick", {1, 2, 3}), 5);
+
+  // A function that returns an aggregate uses a return slot, which can't
+  // outlive the interpreter's memory.
+  auto point = Interpret::InterpretFunction(
+      sem_ir, GetFunctionId(sem_ir, "Point"),
+      {Interpret::Value::MakeInteger(1), Interpret::Value::MakeInteger(2)}, {},
+      /*vlog_stream=*/nullptr);
+  ASSERT_FALSE(point.ok());
+  EXPECT_THAT(point.error().message(), HasSubstr("return slot"));
+}
+
+TEST_F(InterpretTest, Limits) {
+  auto sem_ir = CheckSource(R"(
+fn Forever(n: i32) -> i32 {
+  while (true) {
+  }
+  return n;
+}
+
+fn Recurse(n: i32) -> i32 {
+  return Recurse(n + 1);
+}
+)");
+  auto forever = Interpret::InterpretFunction(
+      sem_ir, GetFunctionId(sem_ir, "Forever"),
+      {Interpret::Value::MakeInteger(0)}, {.max_steps = 1000},
+      /*vlog_stream=*/nullptr);
+  ASSERT_FALSE(forever.ok());
+  EXPECT_THAT(forever.error().message(),
+              HasSubstr("Exceeded the limit of 1000 steps"));
+
+  auto recurse = Interpret::InterpretFunction(
+      sem_ir, GetFunctionId(sem_ir, "Recurse"),
+      {Interpret::Value::MakeInteger(0)}, {.max_call_depth = 10},
+      /*vlog_stream=*/nullptr);
+  ASSERT_FALSE(recurse.ok());
+  EXPECT_THAT(recurse.error().message(),
+              HasSubstr("Exceeded the call depth limit of 10"));
+
+  auto wrong_args = Interpret::InterpretFunction(
+      sem_ir, GetFunctionId(sem_ir, "Recurse"), {}, {},
+      /*vlog_stream=*/nullptr);
+  ASSERT_FALSE(wrong_args.ok());
+  EXPECT_THAT(wrong_args.error().message(),
+              HasSubstr("`Recurse` expects 1 arguments, but got 0"));
+}
+
+TEST_F(InterpretTest, EntryPoint) {
+  auto sem_ir = CheckSource(R"(
+fn Add(a: i32, b: i32) -> i32 {
+  return a + b;
+}
+
+fn Run() -> i32 {
+  var t: (i32, i32) = (Add(1, 2), 4);
+  return t[0] + t[1];
+}
+)");
+  auto result = Interpret::InterpretEntryPoint(sem_ir, {},
+                                               /*vlog_stream=*/nullptr);
+  ASSERT_TRUE(result.ok()) << result.error();
+  EXPECT_EQ(*result, 7);
+
+  // `Run` may return an aggregate, which isn't an exit code.
+  auto aggregate = Interpret::InterpretEntryPoint(CheckSource(R"(
+fn Run() -> {.x: i32, .y: i32} {
+  return {.x = 1, .y = 2};
+}
+)"),
+                                                  {}, /*vlog_stream=*/nullptr);
+  ASSERT_TRUE(aggregate.ok()) << aggregate.error();
+  EXPECT_EQ(*aggregate, 0);
+
+  auto with_params = Interpret::InterpretEntryPoint(CheckSource(R"(
+fn Run(n: i32) -> i32 {
+  return n;
+}
+)"),
+                                                    {},
+                                                    /*vlog_stream=*/nullptr);
+  ASSERT_FALSE(with_params.ok());
+  EXPECT_THAT(with_params.error().message(),
+              HasSubstr("`Run` must not have parameters"));
+
+  auto missing = Interpret::InterpretEntryPoint(
+      CheckSource("fn NotRun() -> i32 { return 0; }"), {},
+      /*vlog_stream=*/nullptr);
+  ASSERT_FALSE(missing.ok());
+  EXPECT_THAT(missing.error().message(), HasSubstr("No `Run` function"));
+}
+
+}  // namespace
@@ -0,0 +1,54 @@
+#include "Cocktail/Lex/TokenizedBuffer.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "Cocktail/Diagnostics/DiagnosticEmitter.h"
+#include "Cocktail/Source/SourceBuffer.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/VirtualFileSystem.h"
+
+namespace Cocktail::Lex {
+namespace {
+
+using ::testing::ElementsAre;
+
+class TokenizedBufferTest : public ::testing::Test {
+ protected:
+  auto GetKinds(llvm::StringRef text) -> std::vector<TokenKind> {
+    // Each source gets its own file, because files can't be replaced.
+    std::string path = "/test" + std::to_string(++num_files_) + ".cocktail";
+    fs_.addFile(path, /*ModificationTime=*/0,
+                llvm::MemoryBuffer::getMemBufferCopy(text));
+    source_storage_.emplace(std::move(
+        *SourceBuffer::CreateFromFile(fs_, path, ConsoleDiagnosticConsumer())));
+    TokenizedBuffer buffer =
+        TokenizedBuffer::Lex(*source_storage_, ConsoleDiagnosticConsumer());
+    EXPECT_FALSE(buffer.has_errors());
+    std::vector<TokenKind> kinds;
+    for (auto token : buffer.tokens()) {
+      kinds.push_back(buffer.GetKind(token));
+    }
+    return kinds;
+  }
+
+  llvm::vfs::InMemoryFileSystem fs_;
+  std::optional<SourceBuffer> source_storage_;
+  int num_files_ = 0;
+};
+
+TEST_F(TokenizedBufferTest, StartsWithStartOfFile) {
+  EXPECT_THAT(GetKinds(""),
+              ElementsAre(TokenKind::StartOfFile, TokenKind::EndOfFile));
+  EXPECT_THAT(GetKinds("fn F();"),
+              ElementsAre(TokenKind::StartOfFile, TokenKind::Fn,
+                          TokenKind::Identifier, TokenKind::OpenParen,
+                          TokenKind::CloseParen, TokenKind::Semi,
+                          TokenKind::EndOfFile));
+}
+
+}  // namespace
+}  // namespace Cocktail::Lex